@@ -0,0 +1,529 @@
+#include "blub/async/dispatcher.hpp"
+#include "blub/core/globals.hpp"
+#include "blub/core/string.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/log/global.hpp"
+#include "blub/log/system.hpp"
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/simple/accessor.hpp"
+#include "blub/procedural/voxel/simple/container/inMemory.hpp"
+#include "blub/procedural/voxel/simple/surface.hpp"
+#include "blub/procedural/voxel/simple/utils/meshExport.hpp"
+#include "blub/procedural/voxel/terrain/accessor.hpp"
+#include "blub/procedural/voxel/terrain/surface.hpp"
+#include "blub/procedural/voxel/tile/container.hpp"
+#include "blub/procedural/voxel/tile/surface.hpp"
+#include "blub/serialization/format/text/input.hpp"
+#include "blub/serialization/format/text/output.hpp"
+
+#include "field.hpp"
+#include "netsConfig.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#ifdef BLUB_LINUX
+#   include <sys/resource.h>
+#endif
+
+
+/** @example bake.cpp
+ * This headless tool bakes a voxel-world to meshes on disk, without a renderer. Use it to pre-bake meshes for distribution or review
+ * and as throughput-benchmark: it calculates every lod of terrain::accessor and terrain::surface for all tiles of the world
+ * on a dispatcher with a configurable count of threads and prints the surface-tiles per second and the peak memory.
+ * Every lod gets welded by simple::utils::meshExport to one mesh and written as binary PLY or as OBJ.
+ *
+ * The input is a simple::container::inMemory serialized by serialization::format::text. Without input the test-terrain of the
+ * benchmark gets generated, save it by -s to get a world for later runs.
+ *
+ * Usage: example-benchmark-bake [options]
+ *  -i file    serialized inMemory-container to bake
+ *  -g tiles   size of the generated test-terrain in tiles per axis, if no input is given (default 8)
+ *  -s file    saves the voxel-world serialized
+ *  -l count   number of lods (default 3)
+ *  -t count   number of worker-threads, 0 runs the jobs on the main thread (default: hardware concurrency)
+ *  -m mesher  "mc" for marching cubes or "nets" for surface nets (default mc)
+ *  -d error   decimates the lods from 1 on, error in voxel (default 0, off)
+ *  -c         optimizes the triangles for the vertex-cache
+ *  -q         keeps the vertices quantized
+ *  -f format  "ply", "obj" or "none" (default ply)
+ *  -o prefix  output-files get named prefix_lod<lod>.<format> (default bake)
+ */
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+/**
+ * @brief The options struct contains the command-line arguments.
+ */
+struct options
+{
+    options()
+        : numTilesGenerated(8)
+        , numLod(3)
+        , numThreads(std::thread::hardware_concurrency())
+        , surfaceNets(false)
+        , decimation(0.)
+        , optimizeVertexCache(false)
+        , quantized(false)
+        , format("ply")
+        , output("bake")
+    {
+        ;
+    }
+
+    string input;
+    int32 numTilesGenerated;
+    string save;
+    int32 numLod;
+    int32 numThreads;
+    bool surfaceNets;
+    real decimation;
+    bool optimizeVertexCache;
+    bool quantized;
+    string format;
+    string output;
+};
+
+/**
+ * @brief parseOptions reads the command-line.
+ * @return false on unknown or incomplete arguments.
+ */
+bool parseOptions(const int& argc, char* argv[], options& result)
+{
+    for (int32 ind = 1; ind < argc; ++ind)
+    {
+        const char* option(argv[ind]);
+        if (std::strcmp(option, "-c") == 0)
+        {
+            result.optimizeVertexCache = true;
+            continue;
+        }
+        if (std::strcmp(option, "-q") == 0)
+        {
+            result.quantized = true;
+            continue;
+        }
+        if (ind+1 >= argc)
+        {
+            return false;
+        }
+        const char* value(argv[++ind]);
+        if (std::strcmp(option, "-i") == 0)
+        {
+            result.input = value;
+        }
+        else if (std::strcmp(option, "-g") == 0)
+        {
+            result.numTilesGenerated = std::atoi(value);
+        }
+        else if (std::strcmp(option, "-s") == 0)
+        {
+            result.save = value;
+        }
+        else if (std::strcmp(option, "-l") == 0)
+        {
+            result.numLod = std::atoi(value);
+        }
+        else if (std::strcmp(option, "-t") == 0)
+        {
+            result.numThreads = std::atoi(value);
+        }
+        else if (std::strcmp(option, "-m") == 0)
+        {
+            result.surfaceNets = std::strcmp(value, "nets") == 0;
+            if (!result.surfaceNets && std::strcmp(value, "mc") != 0)
+            {
+                return false;
+            }
+        }
+        else if (std::strcmp(option, "-d") == 0)
+        {
+            result.decimation = std::atof(value);
+        }
+        else if (std::strcmp(option, "-f") == 0)
+        {
+            result.format = value;
+            if (result.format != "ply" && result.format != "obj" && result.format != "none")
+            {
+                return false;
+            }
+        }
+        else if (std::strcmp(option, "-o") == 0)
+        {
+            result.output = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return result.numLod > 0 && result.numThreads >= 0 && result.numTilesGenerated > 0 && result.decimation >= 0.;
+}
+
+/**
+ * @brief runUntilDone runs the dispatcher until all jobs are done, including the ones they post.
+ * The dispatcher must be created with endThreadsAfterAllDone set to true.
+ */
+void runUntilDone(async::dispatcher& worker)
+{
+    worker.start();
+    worker.stop();
+    worker.reset();
+}
+
+/**
+ * @brief calculatePeakMemory returns the peak resident memory of the process.
+ * @return KiB, 0 if not supported by the platform.
+ */
+uint64 calculatePeakMemory()
+{
+#ifdef BLUB_LINUX
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief The bake class loads or generates a voxel-world, calculates the surface of all lods and writes the meshes.
+ */
+template <class configType>
+class bake
+{
+public:
+    typedef configType t_config;
+    typedef typename t_config::t_container::t_simple t_voxelContainer;
+    typedef typename t_config::t_container::t_tile t_tileContainer;
+    typedef voxel::terrain::accessor<t_config> t_voxelAccessor;
+    typedef voxel::terrain::surface<t_config> t_voxelSurface;
+    typedef typename t_voxelSurface::t_simple t_lodSurface;
+    typedef voxel::simple::utils::meshExport<t_config> t_meshExport;
+    typedef typename t_meshExport::t_meshPtr t_meshPtr;
+    typedef typename t_voxelContainer::t_utilsTile t_utilsTile;
+    typedef typename t_voxelContainer::t_tileMap t_tileMap;
+    typedef voxel::simple::container::utils::tileState t_tileState;
+
+    bake(const options& toBake)
+        : m_options(toBake)
+        , m_worker(toBake.numThreads, true, "bake")
+    {
+        ;
+    }
+
+    /**
+     * @brief run does all the work and logs the results.
+     * @return EXIT_SUCCESS or EXIT_FAILURE
+     */
+    int run()
+    {
+        t_tileMap tiles;
+        if (m_options.input.empty())
+        {
+            generateTiles(tiles);
+        }
+        else if (!loadTiles(tiles))
+        {
+            return EXIT_FAILURE;
+        }
+        BLUB_LOG_OUT() << "voxel-tiles: " << tiles.size() << ", peak memory after loading: " << calculatePeakMemory() << "KiB";
+
+        // the accessor doesn't cache lod 0, the surface calculates it directly on the container
+        t_voxelContainer voxels(m_worker);
+        t_voxelAccessor voxelAccessor(m_worker, voxels, m_options.numLod, false);
+        t_voxelSurface voxelSurface(m_worker, voxelAccessor);
+        if (m_options.quantized)
+        {
+            voxelSurface.setVertexFormat(t_voxelSurface::t_vertexFormat::quantized);
+        }
+        voxelSurface.setDecimation(m_options.decimation, 1);
+        for (const typename t_voxelSurface::t_lodList::value_type& lod : voxelSurface.getLodList())
+        {
+            lod->setOptimizeVertexCache(m_options.optimizeVertexCache);
+        }
+
+        // every tile replaces an empty one, so all of them get calculated
+        const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        voxels.setTiles(tiles);
+        tiles.clear();
+        runUntilDone(m_worker);
+        const real seconds(std::chrono::duration<real>(std::chrono::steady_clock::now() - start).count());
+
+        int32 numTiles(0);
+        for (int32 lod = 0; lod < voxelSurface.getNumLod(); ++lod)
+        {
+            const t_lodSurface& work(*voxelSurface.getLod(lod));
+            uint64 numTriangles(0);
+            for (const typename t_lodSurface::t_tilesMap::value_type& tile : work.getTilesMap())
+            {
+                numTriangles += tile.second->getIndices().size()/3;
+            }
+            numTiles += work.getTileCount();
+            BLUB_LOG_OUT() << "lod " << lod << ": " << work.getTileCount() << " surface-tiles, " << numTriangles << " triangles";
+        }
+        BLUB_LOG_OUT() << "baked " << numTiles << " surface-tiles in " << seconds << "s with " << m_options.numThreads << " threads, "
+                       << (seconds > 0. ? numTiles/seconds : 0.) << " tiles/s, peak memory: " << calculatePeakMemory() << "KiB";
+
+        if (!m_options.save.empty() && !saveVoxels(voxels))
+        {
+            return EXIT_FAILURE;
+        }
+        if (m_options.format == "none")
+        {
+            return EXIT_SUCCESS;
+        }
+        for (int32 lod = 0; lod < voxelSurface.getNumLod(); ++lod)
+        {
+            if (!exportLod(*voxelSurface.getLod(lod), lod))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+protected:
+    /**
+     * @brief generateTiles fills tiles with the test-terrain of the benchmark, numTilesGenerated^3 tiles around the origin.
+     */
+    void generateTiles(t_tileMap& tiles) const
+    {
+        const int32 numTiles(m_options.numTilesGenerated);
+        const int32 voxelLength(t_tileContainer::voxelLength);
+        const field terrain(numTiles*voxelLength*0.4, 8.);
+        for (int32 tileX = -numTiles/2; tileX < numTiles - numTiles/2; ++tileX)
+        {
+            for (int32 tileY = -numTiles/2; tileY < numTiles - numTiles/2; ++tileY)
+            {
+                for (int32 tileZ = -numTiles/2; tileZ < numTiles - numTiles/2; ++tileZ)
+                {
+                    const vector3int32 id(tileX, tileY, tileZ);
+                    typename t_tileContainer::pointer work(t_tileContainer::create());
+                    work->startEdit();
+                    for (int32 x = 0; x < voxelLength; ++x)
+                    {
+                        for (int32 y = 0; y < voxelLength; ++y)
+                        {
+                            for (int32 z = 0; z < voxelLength; ++z)
+                            {
+                                const vector3int32 pos(x, y, z);
+                                typename t_config::t_data toSet;
+                                toSet.setInterpolation(terrain.calculateInterpolation(id*voxelLength + pos));
+                                work->setVoxel(pos, toSet);
+                            }
+                        }
+                    }
+                    work->endEdit();
+                    if (work->isEmpty())
+                    {
+                        continue;
+                    }
+                    if (work->isFull())
+                    {
+                        tiles.insert(id, t_utilsTile(t_tileState::full));
+                        continue;
+                    }
+                    t_utilsTile holder(t_tileState::partitial);
+                    holder.data = work;
+                    tiles.insert(id, holder);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief loadTiles deserializes the input into a temporary container and takes over all tiles that aren't empty.
+     * @return false if the file can't be read.
+     */
+    bool loadTiles(t_tileMap& tiles)
+    {
+        std::ifstream file(m_options.input.c_str());
+        if (!file.is_open())
+        {
+            BLUB_LOG_ERROR() << "can't open " << m_options.input;
+            return false;
+        }
+        t_voxelContainer loaded(m_worker);
+        try
+        {
+            serialization::format::text::input format(file);
+            format >> loaded;
+        }
+        catch (const std::exception& error)
+        {
+            BLUB_LOG_ERROR() << "can't load " << m_options.input << ": " << error.what();
+            return false;
+        }
+        runUntilDone(m_worker);
+
+        loaded.lockForRead();
+        const axisAlignedBoxInt32& bounds(loaded.getTileBounds());
+        for (int32 indX = bounds.getMinimum().x; indX < bounds.getMaximum().x; ++indX)
+        {
+            for (int32 indY = bounds.getMinimum().y; indY < bounds.getMaximum().y; ++indY)
+            {
+                for (int32 indZ = bounds.getMinimum().z; indZ < bounds.getMaximum().z; ++indZ)
+                {
+                    const vector3int32 id(indX, indY, indZ);
+                    const t_utilsTile holder(loaded.getTileHolder(id));
+                    if (holder.state != t_tileState::empty)
+                    {
+                        tiles.insert(id, holder);
+                    }
+                }
+            }
+        }
+        loaded.unlockRead();
+        return true;
+    }
+
+    /**
+     * @brief saveVoxels serializes the voxel-container, so it can get used as input later.
+     * @return false if the file can't be written.
+     */
+    bool saveVoxels(const t_voxelContainer& voxels) const
+    {
+        std::ofstream file(m_options.save.c_str());
+        if (!file.is_open())
+        {
+            BLUB_LOG_ERROR() << "can't write " << m_options.save;
+            return false;
+        }
+        serialization::format::text::output format(file);
+        format << voxels;
+        return true;
+    }
+
+    /**
+     * @brief exportLod welds all tiles of a lod and writes them to prefix_lod<lod>.<format>.
+     * @return false if the file can't be written.
+     */
+    bool exportLod(t_lodSurface& surface, const int32& lod)
+    {
+        if (surface.getTileCount() == 0)
+        {
+            return true;
+        }
+        vector3int32 tileStart(surface.getTilesMap().cbegin()->first);
+        vector3int32 tileEnd(tileStart);
+        for (const typename t_lodSurface::t_tilesMap::value_type& tile : surface.getTilesMap())
+        {
+            tileStart = vector3int32(std::min(tileStart.x, tile.first.x), std::min(tileStart.y, tile.first.y), std::min(tileStart.z, tile.first.z));
+            tileEnd = vector3int32(std::max(tileEnd.x, tile.first.x), std::max(tileEnd.y, tile.first.y), std::max(tileEnd.z, tile.first.z));
+        }
+
+        const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+        t_meshPtr result;
+        t_meshExport exporter(m_worker, surface);
+        exporter.signalExportDone()->connect([&result] (t_meshPtr exported) {result = exported;});
+        exporter.exportRegion(tileStart, tileEnd + vector3int32(1));
+        runUntilDone(m_worker);
+        BASSERT(!result.isNull());
+
+        const string fileName(m_options.output + "_lod" + string::number(lod) + "." + m_options.format);
+        std::ofstream file(fileName.c_str(), std::ios::binary);
+        if (!file.is_open())
+        {
+            BLUB_LOG_ERROR() << "can't write " << fileName;
+            return false;
+        }
+        if (m_options.format == "ply")
+        {
+            writePly(*result, file);
+        }
+        else
+        {
+            writeObj(*result, file);
+        }
+        file.close();
+
+        const real seconds(std::chrono::duration<real>(std::chrono::steady_clock::now() - start).count());
+        BLUB_LOG_OUT() << "wrote " << fileName << ": " << result->positions.size() << " vertices, " << result->indices.size()/3 << " triangles in " << seconds << "s";
+        return !file.fail();
+    }
+
+    /**
+     * @brief writePly writes a mesh as binary little-endian PLY with positions and normals.
+     */
+    static void writePly(const typename t_meshExport::mesh& toWrite, std::ofstream& file)
+    {
+        file << "ply\n"
+             << "format binary_little_endian 1.0\n"
+             << "element vertex " << toWrite.positions.size() << "\n"
+             << "property float x\nproperty float y\nproperty float z\n"
+             << "property float nx\nproperty float ny\nproperty float nz\n"
+             << "element face " << toWrite.indices.size()/3 << "\n"
+             << "property list uchar uint vertex_indices\n"
+             << "end_header\n";
+        for (uint32 index = 0; index < toWrite.positions.size(); ++index)
+        {
+            const float vertex[] = {toWrite.positions[index].x, toWrite.positions[index].y, toWrite.positions[index].z,
+                                    toWrite.normals[index].x, toWrite.normals[index].y, toWrite.normals[index].z};
+            file.write(reinterpret_cast<const char*>(vertex), sizeof(vertex));
+        }
+        const uint8 numCorners(3);
+        for (uint32 index = 0; index < toWrite.indices.size(); index += 3)
+        {
+            file.write(reinterpret_cast<const char*>(&numCorners), sizeof(numCorners));
+            file.write(reinterpret_cast<const char*>(&toWrite.indices[index]), 3*sizeof(uint32));
+        }
+    }
+
+    /**
+     * @brief writeObj writes a mesh as Wavefront OBJ with positions and normals.
+     */
+    static void writeObj(const typename t_meshExport::mesh& toWrite, std::ofstream& file)
+    {
+        for (const vector3& position : toWrite.positions)
+        {
+            file << "v " << position.x << " " << position.y << " " << position.z << "\n";
+        }
+        for (const vector3& normal : toWrite.normals)
+        {
+            file << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+        }
+        // obj counts from one
+        for (uint32 index = 0; index < toWrite.indices.size(); index += 3)
+        {
+            file << "f";
+            for (uint32 corner = 0; corner < 3; ++corner)
+            {
+                const uint32 vertex(toWrite.indices[index + corner] + 1);
+                file << " " << vertex << "//" << vertex;
+            }
+            file << "\n";
+        }
+    }
+
+protected:
+    const options m_options;
+    async::dispatcher m_worker;
+
+};
+
+
+int main(int argc, char* argv[])
+{
+    blub::log::system::addConsole();
+
+    options toBake;
+    if (!parseOptions(argc, argv, toBake))
+    {
+        BLUB_LOG_ERROR() << "usage: " << argv[0] << " [-i file] [-g tiles] [-s file] [-l lods] [-t threads] [-m mc|nets] [-d error] [-c] [-q] [-f ply|obj|none] [-o prefix]";
+        return EXIT_FAILURE;
+    }
+
+    if (toBake.surfaceNets)
+    {
+        return bake<netsConfig>(toBake).run();
+    }
+    return bake<voxel::config>(toBake).run();
+}
@@ -0,0 +1,50 @@
+#ifndef BENCHMARK_FIELD_HPP
+#define BENCHMARK_FIELD_HPP
+
+#include "blub/core/globals.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/vector3.hpp"
+#include "blub/math/vector3int.hpp"
+
+#include <cmath>
+
+
+/**
+ * @brief The field class describes a deterministic, headless test-terrain: a sphere with a wavy surface.
+ * Every benchmark works on the same data, so results are comparable between runs and machines.
+ */
+class field
+{
+public:
+    /**
+     * @brief field constructor.
+     * @param radius Radius of the sphere in voxel.
+     * @param sharpness Scales the distance to the surface before getting clamped to the interpolation-range. Higher values give a harder field.
+     */
+    field(const blub::real& radius, const blub::real& sharpness)
+        : m_radius(radius)
+        , m_sharpness(sharpness)
+    {
+        ;
+    }
+
+    /**
+     * @brief calculateInterpolation returns the interpolation of an absolute voxel-position.
+     * @param pos
+     * @return Larger zero inside the sphere.
+     */
+    blub::int8 calculateInterpolation(const blub::vector3int32& pos) const
+    {
+        const blub::vector3 position(pos);
+        const blub::real distance(m_radius - position.length() + 6.*std::sin(position.x*0.17)*std::cos(position.y*0.13) + 3.*std::sin(position.z*0.29));
+        return static_cast<blub::int8>(blub::math::clamp<blub::real>(distance*m_sharpness, -127., 127.));
+    }
+
+private:
+    const blub::real m_radius;
+    const blub::real m_sharpness;
+
+};
+
+
+#endif // BENCHMARK_FIELD_HPP
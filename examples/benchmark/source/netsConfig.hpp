@@ -0,0 +1,27 @@
+#ifndef BENCHMARK_NETSCONFIG_HPP
+#define BENCHMARK_NETSCONFIG_HPP
+
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/tile/surfaceNets.hpp"
+
+
+/**
+ * @brief The netsConfig struct selects tile::surfaceNets instead of marching cubes.
+ */
+struct netsConfig : public blub::procedural::voxel::config
+{
+    typedef netsConfig t_config;
+
+    typedef container<netsConfig> t_container;
+    typedef accessor<netsConfig> t_accessor;
+    template <typename configType>
+    struct surface : public blub::procedural::voxel::config::surface<configType>
+    {
+        typedef blub::procedural::voxel::tile::surfaceNets<configType> t_tile;
+    };
+    typedef surface<netsConfig> t_surface;
+    typedef renderer<netsConfig> t_renderer;
+};
+
+
+#endif // BENCHMARK_NETSCONFIG_HPP
@@ -0,0 +1,173 @@
+#include "blub/core/vector.hpp"
+#include "blub/log/global.hpp"
+#include "blub/log/system.hpp"
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/data.hpp"
+#include "blub/procedural/voxel/tile/accessor.hpp"
+#include "blub/procedural/voxel/tile/internal/vertexCacheOptimizer.hpp"
+#include "blub/procedural/voxel/tile/surface.hpp"
+#include "blub/procedural/voxel/tile/surfaceNets.hpp"
+#include "blub/procedural/voxel/vertex.hpp"
+
+#include "field.hpp"
+#include "netsConfig.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+
+/** @example surface.cpp
+ * This headless benchmark calculates the surface of a test-terrain with every normal-mode of tile::surface and with tile::surfaceNets
+ * and prints the time, the created vertices and triangles, the memory of the results and the vertex-transforms per triangle of a 16 vertex fifo-cache (ACMR).
+ * Surface nets runs once more with tile::surfaceNets::setQuadCollapse(), marching cubes once more decimated by the same error.
+ * Both meshers run once more with tile::surface::setOptimizeVertexCache() and marching cubes with tile::surface::setDecimation().
+ * Run it with an optimised build.
+ */
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::config t_config;
+typedef voxel::tile::accessor<t_config> t_accessor;
+typedef voxel::tile::surface<t_config> t_surface;
+typedef voxel::tile::surfaceNets<netsConfig> t_surfaceNets;
+typedef t_config::t_data t_voxel;
+typedef t_config::t_vertex t_vertex;
+typedef t_config::t_vertexQuantized t_vertexQuantized;
+typedef t_config::t_index t_index;
+
+
+/**
+ * @brief createTiles fills the accessor-tiles of numTiles^3 tiles around the origin, skips tiles without surface.
+ */
+template <class accessorType>
+vector<sharedPointer<accessorType> > createTiles(const field& terrain, const int32& numTiles)
+{
+    typedef sharedPointer<accessorType> t_accessorPtr;
+
+    vector<t_accessorPtr> result;
+    const int32 voxelLength(accessorType::voxelLength);
+    for (int32 tileX = -numTiles/2; tileX < numTiles - numTiles/2; ++tileX)
+    {
+        for (int32 tileY = -numTiles/2; tileY < numTiles - numTiles/2; ++tileY)
+        {
+            for (int32 tileZ = -numTiles/2; tileZ < numTiles - numTiles/2; ++tileZ)
+            {
+                const vector3int32 voxelStart(vector3int32(tileX, tileY, tileZ)*voxelLength);
+                t_accessorPtr work(accessorType::create());
+                for (int32 x = -1; x < voxelLength+2; ++x)
+                {
+                    for (int32 y = -1; y < voxelLength+2; ++y)
+                    {
+                        for (int32 z = -1; z < voxelLength+2; ++z)
+                        {
+                            const vector3int32 pos(x, y, z);
+                            t_voxel toSet;
+                            toSet.setInterpolation(terrain.calculateInterpolation(voxelStart + pos));
+                            work->setVoxel(pos, toSet);
+                        }
+                    }
+                }
+                if (!work->isEmpty() && !work->isFull())
+                {
+                    result.push_back(work);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief createSurface creates a surface-tile with the settings to benchmark.
+ */
+template <class surfaceType>
+typename surfaceType::pointer createSurface(const typename surfaceType::normalMode& mode, const bool& optimizeVertexCache, const real& decimation)
+{
+    typename surfaceType::pointer result(surfaceType::create());
+    result->setNormalMode(mode);
+    result->setOptimizeVertexCache(optimizeVertexCache);
+    result->setDecimation(decimation);
+    return result;
+}
+
+/**
+ * @brief benchmark calculates all tiles numRepeat times by work and prints the results.
+ */
+template <class surfaceType>
+void benchmark(const vector<typename surfaceType::t_voxelAccessorPtr>& tiles, typename surfaceType::pointer work, const char* modeName, const int32& numRepeat)
+{
+    uint64 numVertices(0);
+    uint64 numTriangles(0);
+    real numCacheMisses(0.);
+    const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+    for (int32 repeat = 0; repeat < numRepeat; ++repeat)
+    {
+        for (const typename surfaceType::t_voxelAccessorPtr& tile : tiles)
+        {
+            work->calculateSurface(tile);
+            if (repeat == 0)
+            {
+                numVertices += work->getVertices().size();
+                numTriangles += work->getIndices().size()/3;
+                numCacheMisses += voxel::tile::internal::vertexCacheOptimizer::calculateAverageCacheMissRatio(work->getIndices(), work->getVertices().size(), 16)
+                                  * (work->getIndices().size()/3);
+            }
+        }
+    }
+    const real milliseconds(std::chrono::duration<real, std::milli>(std::chrono::steady_clock::now() - start).count() / numRepeat);
+
+    BLUB_LOG_OUT() << modeName << ": "
+                   << milliseconds << "ms for " << tiles.size() << " tiles, "
+                   << milliseconds*1000./tiles.size() << "us per tile, "
+                   << numVertices << " vertices, "
+                   << numTriangles << " triangles, "
+                   << (numVertices*sizeof(t_vertex) + numTriangles*3*sizeof(t_index))/1024 << "KiB vertex- and index-buffer, "
+                   << (numVertices*sizeof(t_vertexQuantized) + numTriangles*3*sizeof(t_index))/1024 << "KiB with vertexFormat::quantized, "
+                   << "ACMR " << (numTriangles > 0 ? numCacheMisses/numTriangles : 0.);
+}
+
+
+int main(int argc, char* argv[])
+{
+    blub::log::system::addConsole();
+
+    int32 numTiles(6);
+    int32 numRepeat(10);
+    if (argc > 1)
+    {
+        numTiles = std::atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        numRepeat = std::atoi(argv[2]);
+    }
+
+    const field terrain(numTiles*t_accessor::voxelLength*0.4, 8.);
+    const vector<sharedPointer<t_accessor> > tiles(createTiles<t_accessor>(terrain, numTiles));
+    const vector<sharedPointer<t_surfaceNets::t_voxelAccessor> > tilesNets(createTiles<t_surfaceNets::t_voxelAccessor>(terrain, numTiles));
+
+    BLUB_LOG_OUT() << "tiles with surface: " << tiles.size() << " of " << numTiles*numTiles*numTiles
+                   << ", voxel-cache per accessor-tile: " << t_accessor::voxelCount*sizeof(t_voxel)/1024 << "KiB";
+
+    const real quadCollapse(0.04);
+
+    benchmark<t_surface>(tiles, createSurface<t_surface>(t_surface::normalMode::faceAverage, false, 0.), "faceAverage", numRepeat);
+    benchmark<t_surface>(tiles, createSurface<t_surface>(t_surface::normalMode::gradient, false, 0.), "gradient", numRepeat);
+    // surface nets always uses the gradient
+    benchmark<t_surfaceNets>(tilesNets, createSurface<t_surfaceNets>(t_surfaceNets::normalMode::gradient, false, 0.), "surfaceNets", numRepeat);
+    t_surfaceNets::pointer netsCollapsed(createSurface<t_surfaceNets>(t_surfaceNets::normalMode::gradient, false, 0.));
+    netsCollapsed->setQuadCollapse(quadCollapse);
+    benchmark<t_surfaceNets>(tilesNets, netsCollapsed, "surfaceNets, quad-collapse 0.04 voxel", numRepeat);
+    // the same error as the quad-collapse of surface nets
+    benchmark<t_surface>(tiles, createSurface<t_surface>(t_surface::normalMode::gradient, false, quadCollapse), "gradient, decimated like surfaceNets", numRepeat);
+
+    benchmark<t_surface>(tiles, createSurface<t_surface>(t_surface::normalMode::faceAverage, true, 0.), "faceAverage, optimized vertex-cache", numRepeat);
+    benchmark<t_surfaceNets>(tilesNets, createSurface<t_surfaceNets>(t_surfaceNets::normalMode::gradient, true, 0.), "surfaceNets, optimized vertex-cache", numRepeat);
+
+    benchmark<t_surface>(tiles, createSurface<t_surface>(t_surface::normalMode::faceAverage, false, 0.25), "faceAverage, decimated by 0.25 voxel", numRepeat);
+
+    return EXIT_SUCCESS;
+}
@@ -30,7 +30,8 @@ blub::uint32 g_meshId = 0;
 /**
  * @brief The OgreTile class converts the resulting vertices and indices of the voxel-terrain to the Ogre Hardwarebuffer.
  * The class handles setVisible() when a tile gets cutted because it's too near or too far or a cracks has to get closed.
- * The results of the transvoxel-algorithm for closing the cracks between the lod-tiles get set to submeshes.
+ * The results of the transvoxel-algorithm for closing the cracks between the lod-tiles get set to submeshes, when they get visible the first time.
+ * simple::renderer calculates them on the worker before, the graphic-thread only copies them.
  * Every tile contains a Ogre::Mesh, a Ogre::Entity and a Ogre::SceneNode.
  * For more information on how to use ogre3d see http://www.ogre3d.org/docs/manual/ and http://www.ogre3d.org/docs/api/1.9/ .
  */
@@ -45,6 +46,7 @@ public:
     typedef typename t_config::t_renderer::t_tile* t_thiz;
     typedef typename t_config::t_surface::t_tile t_voxelSurfaceTile;
     typedef typename t_base::t_tileData::t_vertices t_vertices;
+    typedef typename t_base::t_tileData::t_indices t_indices;
     typedef typename t_config::t_vertex t_vertex;
 
     /**
@@ -66,6 +68,8 @@ public:
     virtual ~OgreTile();
 
     void setTileData(typename t_base::t_tileDataPtr convertToRenderAble, const blub::axisAlignedBox &aabb);
+    void setTileDataAttributes(typename t_base::t_tileDataPtr convertToRenderAble, const blub::axisAlignedBox &aabb);
+    void setTileDataPartial(typename t_base::t_tileDataPtr convertToRenderAble, const blub::axisAlignedBox &aabb);
 
     void setVisible(const bool& vis) override;
     void setVisibleLod(const blub::uint16& indLod, const bool& vis) override;
@@ -94,6 +98,49 @@ protected:
      * @param aabb Used for the meshes aabb and the center gets used as the position for the Ogre::SceneNode.
      */
     void setTileDataGraphic(blub::sharedPointer<t_voxelSurfaceTile> convertToRenderAble, const blub::axisAlignedBox &aabb);
+    /**
+     * @brief setTileDataAttributesGraphic only rewrites the buffers of addCustomVertexInformation(). Position-, normal- and index-buffers stay the same.
+     * Falls back to setTileDataGraphic() if the vertex-count changed.
+     * @param convertToRenderAble To convert.
+     * @param aabb Used for the meshes aabb and the center gets used as the position for the Ogre::SceneNode.
+     */
+    void setTileDataAttributesGraphic(blub::sharedPointer<t_voxelSurfaceTile> convertToRenderAble, const blub::axisAlignedBox &aabb);
+    /**
+     * @brief setTileDataPartialGraphic only rewrites the changed ranges of the position-, normal- and index-buffer, see tile::surface::calculateSurfacePartial().
+     * Created transvoxel-faces get rewritten completely. Falls back to setTileDataGraphic() if the tile wasn't remeshed from the one set last, a list changed its size or the worker didn't calculate a created face.
+     * @param convertToRenderAble To convert.
+     * @param aabb Used for the meshes aabb and the center gets used as the position for the Ogre::SceneNode.
+     */
+    void setTileDataPartialGraphic(blub::sharedPointer<t_voxelSurfaceTile> convertToRenderAble, const blub::axisAlignedBox &aabb);
+    /**
+     * @brief createLodSubMeshGraphic creates the submesh of a transvoxel-face. simple::renderer lets the worker calculate the face before it gets visible,
+     * so the surface-tile returns the cached one. Recreate the entity afterwards.
+     * @param indLod The face.
+     * @return false if the face has no triangles.
+     */
+    bool createLodSubMeshGraphic(const blub::uint16& indLod);
+    /**
+     * @brief createVertexDeclarationGraphic declares position, normal and the elements of addCustomVertexDeclaration().
+     */
+    void createVertexDeclarationGraphic(Ogre::VertexData* vertexData);
+    /**
+     * @brief setVerticesGraphic writes vertices to the hardware buffers of vertexData, relative to the center of the tile.
+     */
+    void setVerticesGraphic(Ogre::VertexData* vertexData, const t_vertices& vertices);
+    /**
+     * @brief setIndicesGraphic writes indices to the index buffer of a submesh.
+     */
+    void setIndicesGraphic(Ogre::SubMesh* sub, const t_indices& indices);
+    /**
+     * @brief destroyEntityGraphic destroys the entity, if any.
+     * @return true if the entity was visible.
+     */
+    bool destroyEntityGraphic();
+    /**
+     * @brief createEntityGraphic creates the entity of the mesh and sets the visibility of the whole tile and its transvoxel-faces.
+     * @param visible
+     */
+    void createEntityGraphic(const bool& visible);
     /**
      * @brief setVisibleGraphic sets the whole tile to visible or invisible. Gets called when tile cutted because too near or too far away.
      * @param vis
@@ -101,7 +148,7 @@ protected:
     void setVisibleGraphic(const bool& vis);
     /**
      * @brief setVisibleLodGraphic sets a subentity-visibility. Gets called if the neighbour tile has a different LOD.
-     * To close the occuring cracks this method gets called.
+     * To close the occuring cracks this method gets called. Creates the submesh on the first call with vis true.
      * @param indLod
      * @param vis
      */
@@ -130,6 +177,8 @@ private:
     Ogre::Entity* m_entity;
     Ogre::SceneNode* m_node;
 
+    blub::sharedPointer<t_voxelSurfaceTile> m_tileData;
+    blub::axisAlignedBox m_aabb;
     blub::int32 m_indexLodSubMesh[6];
 };
 
@@ -177,9 +226,25 @@ void OgreTile<configType>::initialise()
 template <typename configType>
 void OgreTile<configType>::setTileData(typename t_base::t_tileDataPtr convertToRenderAble, const blub::axisAlignedBox &aabb)
 {
+    // surface-tiles don't change after creation, see simple::surface
+    typename t_voxelSurfaceTile::pointer convertToRenderAbleCasted(convertToRenderAble.template staticCast<t_voxelSurfaceTile>());
+    m_graphicDispatcher.dispatch(boost::bind(&OgreTile::setTileDataGraphic, getSharedThisPtr(), convertToRenderAbleCasted, aabb));
+}
+
+template <typename configType>
+void OgreTile<configType>::setTileDataAttributes(typename t_base::t_tileDataPtr convertToRenderAble, const blub::axisAlignedBox &aabb)
+{
+    // surface-tiles don't change after creation, see simple::surface
     typename t_voxelSurfaceTile::pointer convertToRenderAbleCasted(convertToRenderAble.template staticCast<t_voxelSurfaceTile>());
-    typename t_voxelSurfaceTile::pointer copy(t_voxelSurfaceTile::createCopy(convertToRenderAbleCasted));
-    m_graphicDispatcher.dispatch(boost::bind(&OgreTile::setTileDataGraphic, getSharedThisPtr(), copy, aabb));
+    m_graphicDispatcher.dispatch(boost::bind(&OgreTile::setTileDataAttributesGraphic, getSharedThisPtr(), convertToRenderAbleCasted, aabb));
+}
+
+template <typename configType>
+void OgreTile<configType>::setTileDataPartial(typename t_base::t_tileDataPtr convertToRenderAble, const blub::axisAlignedBox &aabb)
+{
+    // surface-tiles don't change after creation, see simple::surface
+    typename t_voxelSurfaceTile::pointer convertToRenderAbleCasted(convertToRenderAble.template staticCast<t_voxelSurfaceTile>());
+    m_graphicDispatcher.dispatch(boost::bind(&OgreTile::setTileDataPartialGraphic, getSharedThisPtr(), convertToRenderAbleCasted, aabb));
 }
 
 template <typename configType>
@@ -215,185 +280,301 @@ void OgreTile<configType>::setTileDataGraphic(blub::sharedPointer<t_voxelSurface
 {
     using namespace blub;
 
-    bool wasVisible(false);
-    if (m_entity)
+    const t_vertices& vertices(convertToRenderAble->getVertices());
+    const t_indices& indices(convertToRenderAble->getIndices());
+
+    BASSERT(vertices.size() >= 3);
+    BASSERT(indices.size() >= 3);
+    BASSERT(indices.size() % 3 == 0);
+
+    // the submeshes change, so the entity has to get recreated
+    const bool wasVisible(destroyEntityGraphic());
+
+    m_tileData = convertToRenderAble;
+    m_aabb = aabb;
+
+    Ogre::MeshPtr meshWork(m_mesh);
+
+    const vector3 aabbHalfSize(aabb.getHalfSize());
+    meshWork->_setBounds(axisAlignedBox(-aabbHalfSize, aabbHalfSize), false);
+    // meshWork->_setBounds(aabb, false);
+    const real radius(aabbHalfSize.length());
+    meshWork->_setBoundingSphereRadius(radius);
+    // BLUB_LOG_OUT() << "aabbHalfSize:" << aabbHalfSize;
+
+    if (meshWork->sharedVertexData == nullptr)
     {
-        wasVisible = m_entity->getVisible();
+        meshWork->sharedVertexData = new Ogre::VertexData();
+        createVertexDeclarationGraphic(meshWork->sharedVertexData);
+    }
+    setVerticesGraphic(meshWork->sharedVertexData, vertices);
 
-        delete m_entity;
-        m_entity = nullptr;
+    // the transvoxel-faces get created by setVisibleLodGraphic() on demand
+    while (meshWork->getNumSubMeshes() > 1)
+    {
+        meshWork->destroySubMesh(meshWork->getNumSubMeshes()-1);
+    }
+    if (meshWork->getNumSubMeshes() == 0)
+    {
+        Ogre::SubMesh* sub(meshWork->createSubMesh());
+        sub->setBuildEdgesEnabled(false);
+        sub->useSharedVertices = true;
     }
+    setIndicesGraphic(meshWork->getSubMesh(0), indices);
 
-    uint32 numSubmeshes(1);
-    if (convertToRenderAble->getCaluculateLod())
+    for (int32 indLod = 0; indLod < 6; ++indLod)
     {
-        for (int32 indLod = 0; indLod < 6; ++indLod)
+        m_indexLodSubMesh[indLod] = -1;
+        if (t_base::m_lodShouldBeVisible[indLod])
         {
-            if (convertToRenderAble->getIndicesLod(indLod).size() > 0)
-            {
-                ++numSubmeshes;
-            }
+            createLodSubMeshGraphic(indLod);
         }
     }
 
+    createEntityGraphic(wasVisible);
+}
+
+template <typename configType>
+bool OgreTile<configType>::createLodSubMeshGraphic(const blub::uint16& indLod)
+{
+    if (m_tileData.isNull() || !m_tileData->getCaluculateLod())
+    {
+        return false;
+    }
+    // cached by the worker, see simple::renderer::setVisibleLod()
+    const t_indices& indices(m_tileData->getIndicesLod(indLod));
+    if (indices.empty())
     {
-        const t_vertices vertices(convertToRenderAble->getVertices());
-        const typename t_base::t_tileData::t_indices indices(convertToRenderAble->getIndices());
+        return false;
+    }
+    BASSERT(indices.size() % 3 == 0);
+
+    Ogre::SubMesh* sub(m_mesh->createSubMesh());
+    sub->setBuildEdgesEnabled(false);
+    sub->useSharedVertices = false;
+    sub->vertexData = new Ogre::VertexData();
+    createVertexDeclarationGraphic(sub->vertexData);
+    setVerticesGraphic(sub->vertexData, m_tileData->getVerticesLod(indLod));
+    setIndicesGraphic(sub, indices);
+
+    m_indexLodSubMesh[indLod] = m_mesh->getNumSubMeshes()-1;
+    return true;
+}
 
-        BASSERT(vertices.size() >= 3);
-        BASSERT(indices.size() >= 3);
-        BASSERT(indices.size() % 3 == 0);
+template <typename configType>
+void OgreTile<configType>::createVertexDeclarationGraphic(Ogre::VertexData* vertexData)
+{
+    Ogre::VertexDeclaration* decl = vertexData->vertexDeclaration;
 
-        Ogre::MeshPtr meshWork(m_mesh);
+    decl->addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
+    decl->addElement(1, 0, Ogre::VET_FLOAT3, Ogre::VES_NORMAL);
+    static_cast<t_thiz>(this)->addCustomVertexDeclaration(decl);
+}
 
-        const vector3 aabbHalfSize(aabb.getHalfSize());
-        meshWork->_setBounds(axisAlignedBox(-aabbHalfSize, aabbHalfSize), false);
-        // meshWork->_setBounds(aabb, false);
-        const real radius(aabbHalfSize.length());
-        meshWork->_setBoundingSphereRadius(radius);
-        // BLUB_LOG_OUT() << "aabbHalfSize:" << aabbHalfSize;
+template <typename configType>
+void OgreTile<configType>::setVerticesGraphic(Ogre::VertexData* vertexData, const t_vertices& vertices)
+{
+    using namespace blub;
 
-        if (meshWork->sharedVertexData == nullptr)
-        {
-            meshWork->sharedVertexData = new Ogre::VertexData();
+    const vector3 aabbHalfSize(m_aabb.getHalfSize());
 
-            {
-                Ogre::VertexDeclaration* decl = meshWork->sharedVertexData->vertexDeclaration;
+    vertexData->vertexCount = vertices.size();
+    Ogre::VertexBufferBinding* bind = vertexData->vertexBufferBinding;
+    {
+        Ogre::HardwareVertexBufferSharedPtr positionBuffer;
+        const size_t sizeVertex = Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
 
-                decl->addElement(0, 0, Ogre::VET_FLOAT3, Ogre::VES_POSITION);
-                decl->addElement(1, 0, Ogre::VET_FLOAT3, Ogre::VES_NORMAL);
-                static_cast<t_thiz>(this)->addCustomVertexDeclaration(decl);
-            }
-        }
+        positionBuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+                    sizeVertex, vertexData->vertexCount, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
 
-        meshWork->sharedVertexData->vertexCount = vertices.size();
-        Ogre::VertexBufferBinding* bind = meshWork->sharedVertexData->vertexBufferBinding;
+        vector3* toWriteTo(static_cast<vector3*>(positionBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD)));
+        for (uint32 ind = 0; ind < vertices.size(); ++ind)
         {
-            Ogre::HardwareVertexBufferSharedPtr positionBuffer;
-            const size_t sizeVertex = Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
+            toWriteTo[ind] = vertices.at(ind).position - aabbHalfSize;
+        }
+        positionBuffer->unlock();
 
-            positionBuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
-                        sizeVertex, meshWork->sharedVertexData->vertexCount, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        bind->setBinding(0, positionBuffer);
+    }
+    {
+        Ogre::HardwareVertexBufferSharedPtr normalBuffer;
+        const size_t sizeVertex = Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
 
-            vector3* toWriteTo(static_cast<vector3*>(positionBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD)));
-            for (uint32 ind = 0; ind < vertices.size(); ++ind)
-            {
-                toWriteTo[ind] = vertices.at(ind).position - aabbHalfSize;
-            }
-            positionBuffer->unlock();
+        normalBuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
+                    sizeVertex, vertexData->vertexCount, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
 
-            bind->setBinding(0, positionBuffer);
-        }
+        vector3* toWriteTo(static_cast<vector3*>(normalBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD)));
+        for (uint32 ind = 0; ind < vertices.size(); ++ind)
         {
-            Ogre::HardwareVertexBufferSharedPtr normalBuffer;
-            const size_t sizeVertex = Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
+            toWriteTo[ind] = vertices.at(ind).normal;
+        }
+        normalBuffer->unlock();
 
-            normalBuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(
-                        sizeVertex, meshWork->sharedVertexData->vertexCount, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        bind->setBinding(1, normalBuffer);
+    }
+    static_cast<t_thiz>(this)->addCustomVertexInformation(bind, vertices);
+}
 
-            vector3* toWriteTo(static_cast<vector3*>(normalBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD)));
-            for (uint32 ind = 0; ind < vertices.size(); ++ind)
-            {
-                toWriteTo[ind] = vertices.at(ind).normal;
-            }
-            normalBuffer->unlock();
+template <typename configType>
+void OgreTile<configType>::setIndicesGraphic(Ogre::SubMesh* sub, const t_indices& indices)
+{
+    BASSERT(indices.size() < 65536);
+    const blub::uint16 numIndices(indices.size());
+
+    Ogre::HardwareIndexBufferSharedPtr indexBuffer = Ogre::HardwareBufferManager::getSingleton().
+            createIndexBuffer(
+                Ogre::HardwareIndexBuffer::IT_16BIT,
+                numIndices,
+                Ogre::HardwareBuffer::HBU_STATIC);
+    blub::uint16* toWriteTo(static_cast<blub::uint16*>(indexBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD)));
+    memcpy(toWriteTo, indices.data(), sizeof(blub::uint16) * numIndices);
+    indexBuffer->unlock();
+
+    sub->indexData->indexBuffer = indexBuffer;
+    sub->indexData->indexCount = numIndices;
+    sub->indexData->indexStart = 0;
+    sub->setMaterialName(m_materialName);
+}
 
-            bind->setBinding(1, normalBuffer);
+template <typename configType>
+bool OgreTile<configType>::destroyEntityGraphic()
+{
+    bool wasVisible(false);
+    if (m_entity)
+    {
+        wasVisible = m_entity->getVisible();
+
+        delete m_entity;
+        m_entity = nullptr;
+    }
+    return wasVisible;
+}
+
+template <typename configType>
+void OgreTile<configType>::createEntityGraphic(const bool& visible)
+{
+    BASSERT(m_entity == nullptr);
+
+    m_entity = m_scene->createEntity(m_mesh);
+    m_node->setPosition(m_aabb.getCenter());
+    m_node->attachObject(m_entity);
+    setVisibleGraphic(visible);
+
+    for (blub::int32 indLod = 0; indLod < 6; ++indLod)
+    {
+        if (m_indexLodSubMesh[indLod] != -1)
+        {
+            m_entity->getSubEntity(m_indexLodSubMesh[indLod])->setVisible(t_base::m_lodShouldBeVisible[indLod]);
         }
-        static_cast<t_thiz>(this)->addCustomVertexInformation(bind, vertices);
+    }
+}
 
-        if (numSubmeshes < meshWork->getNumSubMeshes())
+template <typename configType>
+void OgreTile<configType>::setTileDataAttributesGraphic(blub::sharedPointer<t_voxelSurfaceTile> convertToRenderAble, const blub::axisAlignedBox &aabb)
+{
+    const t_vertices& vertices(convertToRenderAble->getVertices());
+
+    if (m_entity == nullptr ||
+        m_mesh->sharedVertexData == nullptr ||
+        m_mesh->sharedVertexData->vertexCount != vertices.size())
+    {
+        setTileDataGraphic(convertToRenderAble, aabb);
+        return;
+    }
+
+    // the created transvoxel-faces copied the old vertices. Faces the worker didn't calculate get dropped by setTileDataGraphic()
+    for (blub::int32 indLod = 0; indLod < 6; ++indLod)
+    {
+        if (m_indexLodSubMesh[indLod] != -1 &&
+            (!convertToRenderAble->getTransitionFaceCalculated(indLod) ||
+             m_mesh->getSubMesh(m_indexLodSubMesh[indLod])->vertexData->vertexCount != convertToRenderAble->getVerticesLod(indLod).size()))
         {
-            for (int32 ind = 0; meshWork->getNumSubMeshes() - numSubmeshes; ++ind)
-            {
-                meshWork->destroySubMesh(0);
-            }
+            setTileDataGraphic(convertToRenderAble, aabb);
+            return;
         }
-        if (numSubmeshes > meshWork->getNumSubMeshes())
+    }
+
+    m_tileData = convertToRenderAble;
+    static_cast<t_thiz>(this)->addCustomVertexInformation(m_mesh->sharedVertexData->vertexBufferBinding, vertices);
+    for (blub::int32 indLod = 0; indLod < 6; ++indLod)
+    {
+        if (m_indexLodSubMesh[indLod] != -1)
         {
-            for (int32 ind = 0; numSubmeshes - meshWork->getNumSubMeshes(); ++ind)
-            {
-                Ogre::SubMesh* sub(meshWork->createSubMesh());
-                sub->setBuildEdgesEnabled(false);
-                sub->useSharedVertices = true;
-            }
+            static_cast<t_thiz>(this)->addCustomVertexInformation(m_mesh->getSubMesh(m_indexLodSubMesh[indLod])->vertexData->vertexBufferBinding,
+                                                                  convertToRenderAble->getVerticesLod(indLod));
         }
-        BASSERT(numSubmeshes == meshWork->getNumSubMeshes());
+    }
+}
+
+template <typename configType>
+void OgreTile<configType>::setTileDataPartialGraphic(blub::sharedPointer<t_voxelSurfaceTile> convertToRenderAble, const blub::axisAlignedBox &aabb)
+{
+    using namespace blub;
 
-        for (int32 indLod = 0; indLod < 6; ++indLod)
+    const t_vertices& vertices(convertToRenderAble->getVertices());
+    const t_indices& indices(convertToRenderAble->getIndices());
+
+    if (m_entity == nullptr ||
+        m_tileData.isNull() ||
+        m_tileData->getRevision() != convertToRenderAble->getRemeshedFrom() ||
+        m_mesh->sharedVertexData == nullptr ||
+        m_mesh->sharedVertexData->vertexCount != vertices.size() ||
+        m_mesh->getSubMesh(0)->indexData->indexCount != indices.size())
+    {
+        setTileDataGraphic(convertToRenderAble, aabb);
+        return;
+    }
+    // a face without triangles has to lose its submesh, the same for faces the worker didn't calculate
+    for (int32 indLod = 0; indLod < 6; ++indLod)
+    {
+        if (m_indexLodSubMesh[indLod] != -1 &&
+            (!convertToRenderAble->getTransitionFaceCalculated(indLod) ||
+             convertToRenderAble->getIndicesLod(indLod).empty()))
         {
-            m_indexLodSubMesh[indLod] = -1;
+            setTileDataGraphic(convertToRenderAble, aabb);
+            return;
         }
+    }
+
+    m_tileData = convertToRenderAble;
+
+    const typename t_voxelSurfaceTile::changedRange& changedVertices(convertToRenderAble->getChangedVertices());
+    if (changedVertices.count > 0)
+    {
+        const vector3 aabbHalfSize(m_aabb.getHalfSize());
+        const size_t sizeVertex = Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
+        const Ogre::VertexBufferBinding* bind = m_mesh->sharedVertexData->vertexBufferBinding;
 
-        int32 indexSubMesh(0);
-        uint32 numIterations(7);
-        if (numSubmeshes == 1)
+        vector<vector3> toWrite(changedVertices.count);
+        for (int32 ind = 0; ind < changedVertices.count; ++ind)
         {
-            numIterations = 1;
+            toWrite[ind] = vertices[changedVertices.first + ind].position - aabbHalfSize;
         }
-        for (uint32 indSubMesh = 0; indSubMesh < numIterations; ++indSubMesh)
+        bind->getBuffer(0)->writeData(sizeVertex*changedVertices.first, sizeVertex*changedVertices.count, toWrite.data());
+        for (int32 ind = 0; ind < changedVertices.count; ++ind)
         {
-            uint16 numIndices;
-            if (indSubMesh == 0)
-            {
-                BASSERT(indices.size() < 65536);
-                numIndices = indices.size();
-            }
-            else
-            {
-                const typename t_base::t_tileData::t_indices& indicesLod(convertToRenderAble->getIndicesLod(indSubMesh-1));
-                BASSERT(indicesLod.size() < 65536);
-                if (indicesLod.empty())
-                {
-                    continue;
-                }
-                BASSERT(indicesLod.size() % 3 == 0);
-                numIndices = indicesLod.size();
-            }
-
-            Ogre::HardwareIndexBufferSharedPtr indexBuffer = Ogre::HardwareBufferManager::getSingleton().
-                    createIndexBuffer(
-                        Ogre::HardwareIndexBuffer::IT_16BIT,
-                        numIndices,
-                        Ogre::HardwareBuffer::HBU_STATIC);
-            uint16* toWriteTo(static_cast<uint16*>(indexBuffer->lock(Ogre::HardwareBuffer::HBL_DISCARD)));
-            {
-                if (indSubMesh == 0)
-                {
-                    memcpy(toWriteTo, indices.data(), sizeof(uint16) * numIndices);
-                }
-                else
-                {
-                    const typename t_base::t_tileData::t_indices& indicesLod(convertToRenderAble->getIndicesLod(indSubMesh-1));
-                    memcpy(toWriteTo, indicesLod.data(), sizeof(uint16) * numIndices);
-                }
-            }
-            indexBuffer->unlock();
-
-            Ogre::SubMesh* sub = meshWork->getSubMesh(indexSubMesh);
-            sub->indexData->indexBuffer = indexBuffer;
-            sub->indexData->indexCount = numIndices;
-            sub->indexData->indexStart = 0;
-            sub->setMaterialName(m_materialName);
-
-            if (indSubMesh > 0)
-            {
-                m_indexLodSubMesh[indSubMesh-1] = indexSubMesh;
-            }
-            ++indexSubMesh;
+            toWrite[ind] = vertices[changedVertices.first + ind].normal;
         }
+        bind->getBuffer(1)->writeData(sizeVertex*changedVertices.first, sizeVertex*changedVertices.count, toWrite.data());
     }
+    static_cast<t_thiz>(this)->addCustomVertexInformation(m_mesh->sharedVertexData->vertexBufferBinding, vertices);
 
-    m_entity = m_scene->createEntity(m_mesh);
-    m_node->setPosition(aabb.getCenter());
-    m_node->attachObject(m_entity);
-    setVisibleGraphic(wasVisible);
+    const typename t_voxelSurfaceTile::changedRange& changedIndices(convertToRenderAble->getChangedIndices());
+    if (changedIndices.count > 0)
+    {
+        m_mesh->getSubMesh(0)->indexData->indexBuffer->writeData(sizeof(uint16)*changedIndices.first,
+                                                                 sizeof(uint16)*changedIndices.count,
+                                                                 indices.data() + changedIndices.first);
+    }
 
+    // the worker calculated the faces of the new surface-tile, see simple::renderer
     for (int32 indLod = 0; indLod < 6; ++indLod)
     {
         if (m_indexLodSubMesh[indLod] != -1)
         {
-            m_entity->getSubEntity(m_indexLodSubMesh[indLod])->setVisible(t_base::m_lodShouldBeVisible[indLod]);
+            Ogre::SubMesh* sub(m_mesh->getSubMesh(m_indexLodSubMesh[indLod]));
+            setVerticesGraphic(sub->vertexData, convertToRenderAble->getVerticesLod(indLod));
+            setIndicesGraphic(sub, convertToRenderAble->getIndicesLod(indLod));
         }
     }
 }
@@ -407,10 +588,16 @@ void OgreTile<configType>::setVisibleGraphic(const bool& vis)
 template <typename configType>
 void OgreTile<configType>::setVisibleLodGraphic(const blub::uint16& indLod, const bool& vis)
 {
-    if (m_indexLodSubMesh[indLod] != -1)
+    if (m_indexLodSubMesh[indLod] == -1)
     {
-        m_entity->getSubEntity(m_indexLodSubMesh[indLod])->setVisible(vis);
+        if (vis && m_entity != nullptr && createLodSubMeshGraphic(indLod))
+        {
+            // an entity can't get new subentities
+            createEntityGraphic(destroyEntityGraphic());
+        }
+        return;
     }
+    m_entity->getSubEntity(m_indexLodSubMesh[indLod])->setVisible(vis);
 }
 
 template <typename configType>
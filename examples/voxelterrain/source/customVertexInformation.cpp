@@ -32,6 +32,7 @@
 
 /** @example customVertexInformation.cpp
  * This example shows how to add custom information to a voxel and pass them the vertices.
+ * Press "p" to paint the terrain in front of the camera. Painting only updates the vertex colours, the triangles don't get recalculated.
  * @image html voxel_customVoxelInformation.png
  */
 
@@ -183,6 +184,15 @@ struct data : public voxel::data
         : voxel::data()
         , diffuse(1., 1., 1.) // default colour white
     {;}
+    // compare the colour too, so changing only the colour gets detected by the container and the accessor
+    bool operator ==(const data& other) const
+    {
+        return voxel::data::operator ==(other) && other.diffuse == diffuse;
+    }
+    bool operator !=(const data& other) const
+    {
+        return !(*this == other);
+    }
     colour diffuse; // A diffuse colour gets added to every voxel
 };
 
@@ -227,6 +237,7 @@ typedef t_config::t_renderer::t_tile t_renderTile;
 
 
 void createSphere(t_voxelContainer *container, const vector3 &position, const bool &cut);
+void paintSphere(t_voxelContainer *container, const vector3 &position);
 
 
 int main(int /*argc*/, char* /*argv*/[])
@@ -303,6 +314,16 @@ int main(int /*argc*/, char* /*argv*/[])
                         createSphere(voxelContainer.get(), handler.camera->getPosition()+handler.camera->getDirection()*10., !left);
                     }
         );
+        // paint sphere when key "p" gets pressed
+        handler.signalKeyGotPressed()->connect(
+                    [&] (OIS::KeyEvent evt, bool pressed)
+                    {
+                        if (pressed && evt.key == OIS::KC_P)
+                        {
+                            paintSphere(voxelContainer.get(), handler.camera->getPosition()+handler.camera->getDirection()*10.);
+                        }
+                    }
+        );
     }
 
     // create voxel
@@ -346,5 +367,9 @@ void createSphere(t_voxelContainer *container, const vector3 &position, const bo
     container->editVoxel(sphereEdit);
 }
 
-
-
+void paintSphere(t_voxelContainer *container, const vector3 &position)
+{
+    t_customEdit::pointer sphereEdit(t_customEdit::create(sphere(position, 5.)));
+    sphereEdit->setAttributesOnly(true); // keeps the surface, only the colour of the voxel changes
+    container->editVoxel(sphereEdit);
+}
@@ -5,6 +5,7 @@
 #include "blub/math/sphere.hpp"
 #include "blub/math/transform.hpp"
 #include "blub/sync/identifier.hpp"
+#include "blub/procedural/voxel/cameraPriority.hpp"
 #include "blub/procedural/voxel/config.hpp"
 #include "blub/procedural/voxel/edit/noise.hpp"
 #include "blub/procedural/voxel/edit/sphere.hpp"
@@ -54,6 +55,7 @@ typedef voxel::terrain::renderer<t_config> t_voxelRenderer;
 typedef voxel::terrain::surface<t_config> t_voxelSurface;
 typedef voxel::edit::noise<t_config> t_editNoise;
 typedef voxel::edit::sphere<t_config> t_editSphere;
+typedef voxel::cameraPriority<t_config> t_cameraPriority;
 typedef OgreTile<t_config> t_renderTile;
 
 
@@ -77,6 +79,8 @@ int main(int /*argc*/, char* /*argv*/[])
 
     // initialise terrain   
 
+    // calculates tiles near the camera first - must live longer than the terrain
+    t_cameraPriority cameraPriority;
     scopedPointer<t_voxelContainer> voxelContainer;
     scopedPointer<t_voxelAccessor> voxelAccessor;
     scopedPointer<t_voxelSurface> voxelSurface;
@@ -97,6 +101,11 @@ int main(int /*argc*/, char* /*argv*/[])
         // surface
         voxelSurface.reset(new t_voxelSurface(terrainDispatcher, *voxelAccessor));
 
+        // prioritise jobs by distance to the camera
+        voxelContainer->setTilePriorityCallback(cameraPriority.createCallback(0));
+        voxelAccessor->setTilePriorityCallback(boost::bind(&t_cameraPriority::createCallback, &cameraPriority, _1));
+        voxelSurface->setTilePriorityCallback(boost::bind(&t_cameraPriority::createCallback, &cameraPriority, _1));
+
         // ogre3d render wrapper
         const t_voxelRenderer::t_createTileCallback callbackCreate = boost::bind(t_renderTile::create, handler.renderScene, "none", &handler.graphicDispatcher);
 
@@ -109,10 +118,12 @@ int main(int /*argc*/, char* /*argv*/[])
         voxelRenderer->setCreateTileCallback(callbackCreate);
         cameraIdentifier = sync::identifier::create();
         voxelRenderer->addCamera(cameraIdentifier, handler.camera->getPosition());
+        cameraPriority.addCamera(cameraIdentifier, handler.camera->getPosition());
         handler.signalFrame()->connect(
                     [&] (real)
                     {
                         voxelRenderer->updateCamera(cameraIdentifier, handler.camera->getPosition());
+                        cameraPriority.updateCamera(cameraIdentifier, handler.camera->getPosition());
                     }
         );
 
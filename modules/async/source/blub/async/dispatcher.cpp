@@ -1,6 +1,7 @@
 #include "dispatcher.hpp"
 
 #include "blub/async/mutex.hpp"
+#include "blub/async/mutexLocker.hpp"
 
 #include <boost/asio/io_service.hpp>
 #include <boost/thread.hpp>
@@ -18,6 +19,7 @@ dispatcher::dispatcher(const uint16 &numThreads, const bool &endThreadsAfterAllD
     , m_work(nullptr)
     , m_numThreads(numThreads)
     , m_endThreadsAfterAllDone(endThreadsAfterAllDone)
+    , m_prioritizedCount(0)
 {
     m_service.reset(new boost::asio::io_service());
 }
@@ -88,6 +90,29 @@ void dispatcher::post(const dispatcher::t_toCallFunction &handler)
     m_service->post(handler);
 }
 
+void dispatcher::post(const dispatcher::t_toCallFunction &handler, const real &priority)
+{
+    {
+        mutexLocker locker(m_prioritizedLocker);
+        m_prioritized.push(prioritizedHandler(handler, priority, m_prioritizedCount));
+        ++m_prioritizedCount;
+    }
+    // every posted runPrioritized() calls the handler with the highest priority at the time it runs
+    m_service->post(boost::bind(&dispatcher::runPrioritized, this));
+}
+
+void dispatcher::runPrioritized()
+{
+    t_toCallFunction handler;
+    {
+        mutexLocker locker(m_prioritizedLocker);
+        BASSERT(!m_prioritized.empty());
+        handler = m_prioritized.top().handler;
+        m_prioritized.pop();
+    }
+    handler();
+}
+
 void dispatcher::waitForQueueDone()
 {
     blub::async::mutex mutex;
@@ -1,6 +1,7 @@
 #ifndef BLUB_CORE_DISPATCHER_HPP
 #define BLUB_CORE_DISPATCHER_HPP
 
+#include "blub/async/mutex.hpp"
 #include "blub/async/predecl.hpp"
 #include "blub/core/list.hpp"
 #include "blub/core/noncopyable.hpp"
@@ -8,6 +9,7 @@
 #include "blub/core/string.hpp"
 
 #include <functional>
+#include <queue>
 
 
 namespace boost
@@ -42,6 +44,14 @@ public:
 
     void dispatch(const t_toCallFunction &handler);
     void post(const t_toCallFunction &handler);
+    /**
+     * @brief post posts a handler that gets called before all waiting handlers with a lower priority.
+     * Handlers with the same priority get called in order of posting.
+     * Handlers posted without priority don't get reordered.
+     * @param handler
+     * @param priority Higher gets called earlier.
+     */
+    void post(const t_toCallFunction &handler, const real &priority);
 
     /**
      * @brief waitForQueueDone will work only if one thread
@@ -57,6 +67,7 @@ protected:
 
 private:
     void runThread(const int32& indThread);
+    void runPrioritized();
 
 protected:
     const string m_threadName;
@@ -69,6 +80,33 @@ private:
     typedef list<boost::thread*> t_threads;
     t_threads m_threads;
 
+    struct prioritizedHandler
+    {
+        prioritizedHandler(const t_toCallFunction &handler_, const real &priority_, const uint64 &order_)
+            : handler(handler_)
+            , priority(priority_)
+            , order(order_)
+        {
+            ;
+        }
+        bool operator < (const prioritizedHandler &other) const
+        {
+            if (priority != other.priority)
+            {
+                return priority < other.priority;
+            }
+            return order > other.order;
+        }
+
+        t_toCallFunction handler;
+        real priority;
+        uint64 order;
+    };
+    typedef std::priority_queue<prioritizedHandler> t_prioritizedHandlers;
+    t_prioritizedHandlers m_prioritized;
+    uint64 m_prioritizedCount;
+    mutex m_prioritizedLocker;
+
 };
 
 
@@ -10,7 +10,10 @@ namespace procedural
     {
         class config;
         class data;
+        template <class configType = config>
+        class cameraPriority;
         struct vertex;
+        struct vertexQuantized;
         namespace tile
         {
             template <class tileType>
@@ -20,9 +23,13 @@ namespace procedural
             template <class configType = config>
             class accessor;
             template <class configType = config>
+            class haloView;
+            template <class configType = config>
             class renderer;
             template <class configType = config>
             class surface;
+            template <class configType = config>
+            class surfaceNets;
         }
         namespace simple
         {
@@ -34,6 +41,10 @@ namespace procedural
                 {
                     template <class configType = config>
                     class database;
+                    template <class configType = config>
+                    class prefab;
+                    template <class configType = config>
+                    class rawImporter;
                     enum class tileState;
                     template <class tileType>
                     class tile;
@@ -51,6 +62,11 @@ namespace procedural
             class renderer;
             template <class voxelType = config>
             class surface;
+            namespace utils
+            {
+                template <class configType = config>
+                class meshExport;
+            }
         }
         namespace terrain
         {
@@ -72,11 +88,21 @@ namespace procedural
             template <class configType = config>
             class box;
             template <class configType = config>
+            class composite;
+            template <class configType = config>
+            class filter;
+            template <class configType = config>
+            class heightmap;
+            template <class configType = config>
             class mesh;
             template <class configType = config>
             class noise;
             template <class configType = config>
+            class prefab;
+            template <class configType = config>
             class sphere;
+            template <class configType = config>
+            class stroke;
         }
     }
 }
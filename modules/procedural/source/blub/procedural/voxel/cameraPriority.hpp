@@ -0,0 +1,158 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_CAMERAPRIORITY_HPP
+#define BLUB_PROCEDURAL_VOXEL_CAMERAPRIORITY_HPP
+
+#include "blub/async/mutex.hpp"
+#include "blub/async/mutexLocker.hpp"
+#include "blub/core/globals.hpp"
+#include "blub/core/noncopyable.hpp"
+#include "blub/core/sharedPointer.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/vector3.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/predecl.hpp"
+#include "blub/sync/predecl.hpp"
+
+#include <boost/bind.hpp>
+
+#include <functional>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+
+
+/**
+ * @brief The cameraPriority class calculates the priority of tile-jobs by the distance to the nearest camera.
+ * Set the callbacks created by createCallback() to the simple::* classes of every lod, see simple::base::setTilePriorityCallback().
+ * Tiles near a camera get calculated before far away ones. All methods are threadsafe.
+ */
+template <class configType>
+class cameraPriority : public noncopyable
+{
+public:
+    typedef configType t_config;
+    typedef sharedPointer<sync::identifier> t_cameraPtr;
+    typedef std::function<real (const vector3int32& id)> t_callback;
+
+    /**
+     * @brief cameraPriority constructor.
+     */
+    cameraPriority()
+    {
+        ;
+    }
+
+    /**
+     * @brief addCamera adds a camera.
+     * @param toAdd Must not be nullptr.
+     * @param position The initial position, in voxel of lod 0.
+     */
+    void addCamera(t_cameraPtr toAdd, const vector3& position)
+    {
+        BASSERT(!toAdd.isNull());
+
+        async::mutexLocker locker(m_camerasLocker);
+        m_cameras.push_back(camera(toAdd, position));
+    }
+    /**
+     * @brief updateCamera updates the position of a camera added by addCamera().
+     * @param toUpdate Must not be nullptr.
+     * @param position The new position, in voxel of lod 0.
+     */
+    void updateCamera(t_cameraPtr toUpdate, const vector3& position)
+    {
+        async::mutexLocker locker(m_camerasLocker);
+        for (camera& work : m_cameras)
+        {
+            if (work.id == toUpdate)
+            {
+                work.position = position;
+                return;
+            }
+        }
+        BASSERT(false);
+    }
+    /**
+     * @brief removeCamera removes a camera added by addCamera().
+     * @param toRemove Must not be nullptr.
+     */
+    void removeCamera(t_cameraPtr toRemove)
+    {
+        async::mutexLocker locker(m_camerasLocker);
+        for (typename t_cameraList::iterator it = m_cameras.begin(); it != m_cameras.end(); ++it)
+        {
+            if (it->id == toRemove)
+            {
+                m_cameras.erase(it);
+                return;
+            }
+        }
+        BASSERT(false);
+    }
+
+    /**
+     * @brief calculatePriority returns the negative distance of the tile-center to the nearest camera.
+     * @param id TileId.
+     * @param lod Level of detail of the tile. A tile of lod n is 2^n times larger than a tile of lod 0.
+     * @return Zero if no camera got added.
+     */
+    real calculatePriority(const vector3int32& id, const int32& lod)
+    {
+        const real tileSize(t_config::voxelsPerTile*math::pow(2., lod));
+        const vector3 center((vector3(id) + vector3(0.5))*tileSize);
+
+        async::mutexLocker locker(m_camerasLocker);
+        if (m_cameras.empty())
+        {
+            return 0.;
+        }
+        real nearest(center.squaredDistance(m_cameras[0].position));
+        for (const camera& work : m_cameras)
+        {
+            nearest = math::min(nearest, center.squaredDistance(work.position));
+        }
+        return -math::sqrt(nearest);
+    }
+
+    /**
+     * @brief createCallback creates a callback for simple::base::setTilePriorityCallback().
+     * @param lod The level of detail of the class the callback gets set to.
+     * @return Valid as long as this instance lives.
+     */
+    t_callback createCallback(const int32& lod)
+    {
+        return boost::bind(&cameraPriority::calculatePriority, this, _1, lod);
+    }
+
+protected:
+    struct camera
+    {
+        camera(t_cameraPtr id_, const vector3& position_)
+            : id(id_)
+            , position(position_)
+        {
+            ;
+        }
+
+        t_cameraPtr id;
+        vector3 position;
+    };
+    typedef vector<camera> t_cameraList;
+
+    t_cameraList m_cameras;
+    async::mutex m_camerasLocker;
+
+};
+
+
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_CAMERAPRIORITY_HPP
@@ -4,6 +4,7 @@
 #include "blub/procedural/predecl.hpp"
 #include "blub/procedural/voxel/data.hpp"
 #include "blub/procedural/voxel/vertex.hpp"
+#include "blub/procedural/voxel/vertexQuantized.hpp"
 
 
 namespace blub
@@ -22,6 +23,7 @@ public:
     typedef data t_data;
     typedef uint16 t_index;
     typedef vertex t_vertex;
+    typedef vertexQuantized t_vertexQuantized;
 
     static const int32 voxelsPerTile = 20; // means 20^3!
 
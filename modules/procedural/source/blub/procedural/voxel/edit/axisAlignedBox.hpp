@@ -18,7 +18,7 @@ namespace edit
 
 /**
  * @brief insertes/removes voxels that are included in an blub::axisAlignedBox.
- * Always axis-aligned - use box if you want to rotate.
+ * Axis-aligned in edit-space - rotate it by the rotation of the transform passed to calculateVoxel().
  */
 template <class configType>
 class axisAlignedBox : public base<configType>
@@ -64,17 +64,16 @@ public:
         return m_aab;
     }
 
-protected:
     /**
      * @brief returns the bounding box describing the voxel to be recalculated
      * @param trans describes the tranformation the edit uses
      */
     blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const override
     {
-        return blub::axisAlignedBox(m_aab.getMinimum()*trans.scale + trans.position,
-                                    m_aab.getMaximum()*trans.scale + trans.position);
+        return t_base::transformAxisAlignedBox(m_aab, trans);
     }
 
+protected:
     /**
      * @brief checks if voxel is inside aab
      * @param pos describes the voxel-position
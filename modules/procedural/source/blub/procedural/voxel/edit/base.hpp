@@ -37,6 +37,7 @@ public:
     typedef enableSharedFromThis<base<t_config> > t_base;
     typedef sharedPointer<base<t_config> > pointer;
     typedef typename t_config::t_container::t_simple t_voxelContainerSimple;
+    typedef simple::container::base<t_config> t_voxelContainerBase;
     typedef typename t_config::t_container::t_tile t_voxelContainerTile;
     typedef typename t_config::t_data t_voxel;
 
@@ -76,33 +77,41 @@ public:
 #endif
 
         const blub::axisAlignedBox aabb(getAxisAlignedBoundingBox(trans));
+        const inverseTransform toEditSpace(trans);
 
         const int32 voxelsPerTile(t_config::voxelsPerTile);
         const vector3int32 posContainerAbsolut(voxelContainerOffset*voxelsPerTile);
-        for (int32 indX = 0; indX < t_config::voxelsPerTile; ++indX)
+
+        // only loop over the voxel inside the bounding box
+        vector3int32 voxelStart;
+        vector3int32 voxelEnd;
+        if (!calculateVoxelRange(aabb, posContainerAbsolut, voxelStart, voxelEnd))
+        {
+            return;
+        }
+
+        for (int32 indX = voxelStart.x; indX < voxelEnd.x; ++indX)
         {
-            for (int32 indY = 0; indY < t_config::voxelsPerTile; ++indY)
+            for (int32 indY = voxelStart.y; indY < voxelEnd.y; ++indY)
             {
-                for (int32 indZ = 0; indZ < t_config::voxelsPerTile; ++indZ)
+                for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
                 {
                     const vector3int32 posVoxel(indX, indY, indZ);
-                    vector3 posAbsolut(posContainerAbsolut + posVoxel);
-
-                    if (!aabb.contains(posAbsolut))
-                    {
-                        continue;
-                    }
-
-                    posAbsolut -= trans.position;
-                    posAbsolut /= trans.scale;
+                    const vector3 posAbsolut(posContainerAbsolut + posVoxel);
+                    const vector3 posEdit(toEditSpace.transformPosition(posAbsolut));
 
                     t_voxel voxelResult;
-                    const bool changeVoxel(calculateOneVoxel(posAbsolut, &voxelResult));
+                    const bool changeVoxel(calculateOneVoxel(posEdit, &voxelResult));
 
                     if (!changeVoxel)
                     {
                         continue;
                     }
+                    if (m_attributesOnly)
+                    {
+                        setVoxelAttributesOnly(voxelContainer, posVoxel, voxelResult);
+                        continue;
+                    }
                     if (!m_cut)
                     {
                         voxelContainer->setVoxelIfInterpolationHigher(posVoxel, voxelResult);
@@ -134,6 +143,27 @@ public:
         return m_cut;
     }
 
+    /**
+     * @brief setAttributesOnly declares the edit as "paint"-edit. Don't change the value while active calculation.
+     * The edit only sets the attributes of the voxel inside the edit and keeps their interpolation.
+     * The container, accessor and surface then only update the vertex-attributes of the existing surface-tiles instead of recalculating the triangles.
+     * Tiles that are full or empty don't get edited, because they can't save attributes.
+     * t_config::t_data::operator== must compare the attributes, else changes don't get detected.
+     * If you override calculateVoxel() you must not change the interpolation while getAttributesOnly() returns true, see setVoxelAttributesOnly().
+     * @param attributesOnly If true the interpolation doesn't get changed. setCut() gets ignored.
+     */
+    void setAttributesOnly(const bool& attributesOnly)
+    {
+        m_attributesOnly = attributesOnly;
+    }
+    /**
+     * @brief getAttributesOnly returns the value set by setAttributesOnly() or default false.
+     */
+    const bool &getAttributesOnly() const
+    {
+        return m_attributesOnly;
+    }
+
     /**
      * @brief Sets the voxelcontainer used by calculateVoxel().
      * @param toSet Must not be nullptr.
@@ -157,10 +187,68 @@ public:
      */
     virtual blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const = 0;
 
+    /**
+     * @brief prepareCalculateVoxelMaster gets called by the container before the tiles of the edit get dispatched.
+     * The container is write-locked and no tile is in calculation. Override it if the edit reads voxel of the container,
+     * because tiles get changed in place while the edit gets calculated.
+     * @param voxelContainer The container the edit gets applied to.
+     * @param trans The transform of the edit.
+     */
+    virtual void prepareCalculateVoxelMaster(const t_voxelContainerBase& voxelContainer, const transform& trans) const
+    {
+        (void)voxelContainer;
+        (void)trans;
+    }
+    /**
+     * @brief finishCalculateVoxelMaster gets called by the container after all tiles of the edit got calculated.
+     */
+    virtual void finishCalculateVoxelMaster() const
+    {
+        ;
+    }
+    /**
+     * @brief getReadsContainer returns true if calculateVoxel() reads the voxel of the container it gets applied to, like filter does.
+     * Such edits can't be children of a composite, because composite calculates its children into an empty temporary tile.
+     * @return false by default.
+     */
+    virtual bool getReadsContainer() const
+    {
+        return false;
+    }
+
+    /**
+     * @brief intersectsTile gets called by the container for every tile inside getAxisAlignedBoundingBox() before the tile gets dispatched.
+     * Override it if the shape of the edit is a lot smaller than its bounding box, so untouched tiles don't get scheduled.
+     * @param tileBounds The absolute voxel bounds of the tile.
+     * @param trans The transform of the edit.
+     * @return false if no voxel in tileBounds gets changed by the edit.
+     */
+    virtual bool intersectsTile(const blub::axisAlignedBox& tileBounds, const transform& trans) const
+    {
+        (void)tileBounds;
+        (void)trans;
+        return true;
+    }
+    /**
+     * @brief calculateTileState gets called by the container for every tile that intersectsTile() before the tile gets dispatched.
+     * Override it if the edit knows that a whole tile ends up full or empty. The container then sets the state without allocating
+     * the tile or calling calculateVoxel(). The container doesn't call it for edits with setAttributesOnly(), they never change the geometry.
+     * @param tileBounds The absolute voxel bounds of the tile.
+     * @param trans The transform of the edit.
+     * @return utils::tileState::partitial if calculateVoxel() has to get called, else the resulting state of the whole tile.
+     */
+    virtual simple::container::utils::tileState calculateTileState(const blub::axisAlignedBox& tileBounds, const transform& trans) const
+    {
+        (void)tileBounds;
+        (void)trans;
+        return simple::container::utils::tileState::partitial;
+    }
+
 protected:
     base()
         : m_voxelContainer(nullptr)
         , m_cut(false)
+        , m_attributesOnly(false)
     {
     }
 
@@ -175,6 +263,105 @@ protected:
         return false;
     }
 
+    /**
+     * @brief The inverseTransform class caches the inverse of a blub::transform as 3x3 matrix plus translation.
+     * Transforms absolute voxel positions into edit-space without any quaternion math per voxel.
+     * edit-space to absolute is defined as: absolute = rotation*(scale*editSpace) + position
+     */
+    class inverseTransform
+    {
+    public:
+        /**
+         * @brief inverseTransform calculates the inverse of trans. trans.scale must not contain zero.
+         */
+        inverseTransform(const transform& trans)
+        {
+            BASSERT(trans.scale.x != 0. && trans.scale.y != 0. && trans.scale.z != 0.);
+            const quaternion rotationInverse(trans.rotation.Inverse());
+            const vector3 scaleInverse(vector3(1.)/trans.scale);
+
+            m_axis[0] = (rotationInverse*vector3(1., 0., 0.))*scaleInverse;
+            m_axis[1] = (rotationInverse*vector3(0., 1., 0.))*scaleInverse;
+            m_axis[2] = (rotationInverse*vector3(0., 0., 1.))*scaleInverse;
+            m_offset = -transformDirection(trans.position);
+        }
+
+        /**
+         * @brief transformPosition transforms an absolute position into edit-space.
+         */
+        vector3 transformPosition(const vector3& absolut) const
+        {
+            return transformDirection(absolut) + m_offset;
+        }
+        /**
+         * @brief transformDirection transforms an absolute direction into edit-space. Ignores translation. The result is not normalised.
+         */
+        vector3 transformDirection(const vector3& absolut) const
+        {
+            return m_axis[0]*absolut.x + m_axis[1]*absolut.y + m_axis[2]*absolut.z;
+        }
+
+    protected:
+        vector3 m_axis[3];
+        vector3 m_offset;
+    };
+
+    /**
+     * @brief transformAxisAlignedBox transforms a blub::axisAlignedBox in edit-space to the tightest blub::axisAlignedBox containing it in absolute space.
+     * Respects rotation, scale and position of trans.
+     * @param editSpace The box in edit-space. Must not be null or infinite.
+     * @param trans The transform of the edit.
+     * @return The absolute bounding box.
+     */
+    static blub::axisAlignedBox transformAxisAlignedBox(const blub::axisAlignedBox& editSpace, const transform& trans)
+    {
+        const vector3 center(trans.rotation*(editSpace.getCenter()*trans.scale) + trans.position);
+        const vector3 halfSize(editSpace.getHalfSize());
+
+        vector3 halfSizeResult(0.);
+        for (int32 indAxis = 0; indAxis < 3; ++indAxis)
+        {
+            vector3 scaledAxis(0.);
+            scaledAxis[indAxis] = trans.scale[indAxis]*halfSize[indAxis];
+            const vector3 rotatedAxis(trans.rotation*scaledAxis);
+
+            halfSizeResult += vector3(math::abs(rotatedAxis.x), math::abs(rotatedAxis.y), math::abs(rotatedAxis.z));
+        }
+
+        return blub::axisAlignedBox(center - halfSizeResult, center + halfSizeResult);
+    }
+
+    /**
+     * @brief calculateVoxelRange calculates the relative voxel range of a container tile that is inside aabb.
+     * @param aabb The absolute bounding box.
+     * @param posContainerAbsolut The absolute voxel position of the container tile.
+     * @param voxelStart Gets set to the first relative voxel inside aabb.
+     * @param voxelEnd Gets set to the relative voxel after the last one inside aabb.
+     * @return false if no voxel is inside aabb.
+     */
+    static bool calculateVoxelRange(const blub::axisAlignedBox& aabb,
+                                    const vector3int32& posContainerAbsolut,
+                                    vector3int32& voxelStart,
+                                    vector3int32& voxelEnd)
+    {
+        if (aabb.isNull())
+        {
+            return false;
+        }
+        const vector3 start(aabb.getMinimum() - vector3(posContainerAbsolut));
+        const vector3 end(aabb.getMaximum() - vector3(posContainerAbsolut));
+        const real voxelsPerTile(t_config::voxelsPerTile);
+
+        voxelStart = vector3int32(math::clamp<real>(math::ceil(start.x), 0., voxelsPerTile),
+                                  math::clamp<real>(math::ceil(start.y), 0., voxelsPerTile),
+                                  math::clamp<real>(math::ceil(start.z), 0., voxelsPerTile));
+        voxelEnd = vector3int32(math::clamp<real>(math::floor(end.x) + 1., 0., voxelsPerTile),
+                                math::clamp<real>(math::floor(end.y) + 1., 0., voxelsPerTile),
+                                math::clamp<real>(math::floor(end.z) + 1., 0., voxelsPerTile));
+
+        return voxelStart < voxelEnd;
+    }
+
     /**
      * @brief The axis enum is used by createLine() for describing the direction.
      */
@@ -313,9 +500,32 @@ protected:
     }
 
 
+    /**
+     * @brief setVoxelAttributesOnly sets the attributes of toSet but keeps the interpolation of the voxel in voxelContainer.
+     * Use it in an overridden calculateVoxel() while getAttributesOnly() returns true.
+     * @param voxelContainer The tile to change.
+     * @param posVoxel Voxel-position in voxelContainer.
+     * @param toSet The voxel to take the attributes from. If it is minimum nothing gets set.
+     */
+    static void setVoxelAttributesOnly(t_voxelContainerTile *voxelContainer, const vector3int32 &posVoxel, t_voxel toSet)
+    {
+        if (toSet.isMin())
+        {
+            return;
+        }
+        // keep the interpolation, so the iso-surface stays the same
+        toSet.setInterpolation(voxelContainer->getVoxel(posVoxel).getInterpolation());
+        voxelContainer->setVoxel(posVoxel, toSet);
+    }
+
 private:
     virtual void setVoxel(t_voxelContainerTile *voxelContainer, const vector3int32 &posVoxel, t_voxel &toSet) const
     {
+        if (m_attributesOnly)
+        {
+            setVoxelAttributesOnly(voxelContainer, posVoxel, toSet);
+            return;
+        }
         voxelContainer->setVoxelIfInterpolationHigher(posVoxel, toSet);
     }
 
@@ -323,6 +533,7 @@ protected:
     t_voxelContainerSimple*  m_voxelContainer;
 
     bool m_cut;
+    bool m_attributesOnly;
 
 };
 
@@ -51,8 +51,7 @@ public:
      */
     blub::axisAlignedBox getAxisAlignedBoundingBox(const transform &trans) const override
     {
-        return blub::axisAlignedBox(m_aabb.getMinimum()*trans.scale + trans.position,
-                                    m_aabb.getMaximum()*trans.scale + trans.position);
+        return t_base::transformAxisAlignedBox(m_aabb, trans);
     }
 
 protected:
@@ -101,6 +100,17 @@ protected:
     void calculateVoxel(typename t_base::t_voxelContainerTile *voxelContainer, const vector3int32 &voxelContainerOffset, const transform &trans) const override
     {
         const vector3int32 posContainerAbsolut(voxelContainerOffset*t_base::t_voxelContainerTile::voxelLength);
+        const typename t_base::inverseTransform toEditSpace(trans);
+
+        // createLine() compares the plane-normals with the absolute line-axis, so transform the planes to absolute space
+        blub::plane planesAbsolut[6];
+        for (int32 indPlane = 0; indPlane < 6; ++indPlane)
+        {
+            const blub::plane& work(m_planes[indPlane]);
+            const vector3 pointAbsolut(trans.rotation*((-work.d*work.normal)*trans.scale) + trans.position);
+            const vector3 normalAbsolut((trans.rotation*(work.normal/trans.scale)).getNormalise());
+            planesAbsolut[indPlane] = blub::plane(pointAbsolut, normalAbsolut);
+        }
 
         vector3int32 toLoop[] = {{1, t_base::t_voxelContainerTile::voxelLength, t_base::t_voxelContainerTile::voxelLength},
                                  {t_base::t_voxelContainerTile::voxelLength, 1, t_base::t_voxelContainerTile::voxelLength},
@@ -118,12 +128,9 @@ protected:
                     for (int32 indZ = 0; indZ < toLoop[indAxis].z; ++indZ)
                     {
                         const vector3int32 posVoxel(indX, indY, indZ);
-                        vector3 posAbsolut(posContainerAbsolut + posVoxel);
-
-                        posAbsolut -= trans.position;
-                        posAbsolut /= trans.scale;
+                        const vector3 posAbsolut(posContainerAbsolut + posVoxel);
 
-                        const ray test(posAbsolut, rayDir[indAxis]);
+                        const ray test(toEditSpace.transformPosition(posAbsolut), toEditSpace.transformDirection(rayDir[indAxis]).getNormalise());
                         vector3 cutPoint;
 
                         real cutPoints[2];
@@ -151,8 +158,9 @@ protected:
                                 {
                                     continue;
                                 }
-                                cutPoints[numCutPointsFound] = (cutPoint[indAxis]*trans.scale[indAxis] + trans.position[indAxis]) - static_cast<real>(posContainerAbsolut[indAxis]);
-                                cutPlanes[numCutPointsFound] = m_planes[indPlane];
+                                const vector3 cutPointAbsolut(trans.rotation*(cutPoint*trans.scale) + trans.position);
+                                cutPoints[numCutPointsFound] = cutPointAbsolut[indAxis] - static_cast<real>(posContainerAbsolut[indAxis]);
+                                cutPlanes[numCutPointsFound] = planesAbsolut[indPlane];
                                 ++numCutPointsFound;
                                 if (numCutPointsFound > 2)
                                 {
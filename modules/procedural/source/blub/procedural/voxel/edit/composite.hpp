@@ -0,0 +1,387 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_EDIT_COMPOSITE_HPP
+#define BLUB_PROCEDURAL_VOXEL_EDIT_COMPOSITE_HPP
+
+#include "blub/core/vector.hpp"
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/quaternion.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/base.hpp"
+#include "blub/procedural/voxel/tile/container.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace edit
+{
+
+
+/**
+ * @brief The composite class combines a tree of edits by constructive solid geometry.
+ * Every child edit gets a transform relative to the composite and an operation that defines how it gets combined with the result of the children added before.
+ * Children may be composites too. The whole tree gets evaluated once per tile and is handled by the container as one edit,
+ * so a complex structure causes only one lock and one notification of the accessor/surface/renderer.
+ * Use setCut() on the composite to remove the result. setCut() on the children gets ignored, use operation::subtract instead.
+ * Edits that read the voxel of the container, see getReadsContainer(), can't be children.
+ */
+template <class configType>
+class composite : public base<configType>
+{
+public:
+    typedef configType t_config;
+    typedef base<t_config> t_base;
+    typedef sharedPointer<composite<t_config> > pointer;
+    typedef sharedPointer<base<t_config> const> t_editConstPtr;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_base::t_voxelContainerTile t_voxelContainerTile;
+    typedef sharedPointer<t_voxelContainerTile> t_voxelContainerTilePtr;
+
+    /**
+     * @brief The operation enum describes how a child gets combined with the result of the children before.
+     */
+    enum class operation
+    {
+        /// adds the child (union)
+        merge,
+        /// removes the child
+        subtract,
+        /// keeps only voxel inside the child and the children before
+        intersect,
+        /// like merge, but blends the surfaces together, see child::blendRadius
+        smoothMerge
+    };
+
+    /**
+     * @brief The child struct holds a child-edit and how it gets combined.
+     */
+    struct child
+    {
+        child(t_editConstPtr edit__, const operation& op_, const blub::transform& trans_, const real& blendRadius_)
+            : edit_(edit__)
+            , op(op_)
+            , trans(trans_)
+            , blendRadius(blendRadius_)
+        {
+            ;
+        }
+
+        t_editConstPtr edit_;
+        operation op;
+        /// transform relative to the composite
+        transform trans;
+        /// in voxel. Only used by operation::smoothMerge. Limited by the interpolation range of the children, useful values are between 0 and 2
+        real blendRadius;
+    };
+    typedef vector<child> t_children;
+
+    /**
+     * @brief create creates an empty composite.
+     * @return never nullptr.
+     */
+    static pointer create()
+    {
+        return pointer(new composite());
+    }
+    /**
+     * @brief ~composite destructor
+     */
+    virtual ~composite()
+    {
+        ;
+    }
+
+    /**
+     * @brief addEdit appends a child. Don't call while calculating voxel.
+     * @param toAdd Must not be nullptr. Must not read the voxel of the container, see base::getReadsContainer().
+     * @param op How the child gets combined with the children added before.
+     * @param trans Transform of the child relative to the composite. If it rotates the child, the composite must only get calculated with a uniform scale,
+     * a non-uniform scale would shear the child, see combineTransform().
+     * @param blendRadius In voxel. Only used by operation::smoothMerge.
+     */
+    void addEdit(t_editConstPtr toAdd, const operation& op = operation::merge, const transform& trans = transform(), const real& blendRadius = 1.)
+    {
+        BASSERT(!toAdd.isNull());
+        BASSERT(!toAdd->getReadsContainer()); // the children get calculated into an empty temporary tile
+        BASSERT(blendRadius >= 0.);
+        m_children.push_back(child(toAdd, op, trans, blendRadius));
+    }
+    /**
+     * @brief getEdits returns all children added by addEdit()
+     */
+    const t_children& getEdits() const
+    {
+        return m_children;
+    }
+    /**
+     * @brief clear removes all children. Don't call while calculating voxel.
+     */
+    void clear()
+    {
+        m_children.clear();
+    }
+
+    /**
+     * @brief getAxisAlignedBoundingBox returns the bounding box of the whole tree.
+     * Subtracted children don't extend it, intersected children shrink it.
+     * @param trans Transform of the composite.
+     */
+    blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const override
+    {
+        blub::axisAlignedBox result;
+        for (const child& work : m_children)
+        {
+            const blub::axisAlignedBox childAabb(work.edit_->getAxisAlignedBoundingBox(combineTransform(trans, work.trans)));
+            switch (work.op)
+            {
+            case operation::merge:
+            case operation::smoothMerge:
+                result.merge(childAabb);
+                break;
+            case operation::intersect:
+                result = result.intersection(childAabb);
+                break;
+            case operation::subtract:
+                break;
+            default:
+                BASSERT(false);
+                break;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief prepareCalculateVoxelMaster forwards to every child with its absolute transform.
+     * @param voxelContainer The container the composite gets applied to.
+     * @param trans Transform of the composite.
+     */
+    void prepareCalculateVoxelMaster(const typename t_base::t_voxelContainerBase& voxelContainer, const transform& trans) const override
+    {
+        for (const child& work : m_children)
+        {
+            work.edit_->prepareCalculateVoxelMaster(voxelContainer, combineTransform(trans, work.trans));
+        }
+    }
+    /**
+     * @brief finishCalculateVoxelMaster forwards to every child.
+     */
+    void finishCalculateVoxelMaster() const override
+    {
+        for (const child& work : m_children)
+        {
+            work.edit_->finishCalculateVoxelMaster();
+        }
+    }
+
+    /**
+     * @brief intersectsTile returns true if one of the merged children touches the tile.
+     * @param tileBounds The absolute voxel bounds of the tile.
+     * @param trans Transform of the composite.
+     */
+    bool intersectsTile(const blub::axisAlignedBox& tileBounds, const transform& trans) const override
+    {
+        for (const child& work : m_children)
+        {
+            if (work.op != operation::merge && work.op != operation::smoothMerge)
+            {
+                continue;
+            }
+            const transform childTrans(combineTransform(trans, work.trans));
+            if (work.edit_->getAxisAlignedBoundingBox(childTrans).intersects(tileBounds) &&
+                work.edit_->intersectsTile(tileBounds, childTrans))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief calculateVoxel evaluates all children into a temporary tile, combines them and writes the result into voxelContainer.
+     * Children whose bounding box doesn't touch the tile don't get evaluated.
+     * @param voxelContainer Must not be nullptr.
+     * @param voxelContainerOffset The tile-id of voxelContainer.
+     * @param trans Transform of the composite.
+     */
+    void calculateVoxel(t_voxelContainerTile* voxelContainer,
+                        const vector3int32& voxelContainerOffset,
+                        const transform &trans) const override
+    {
+        const int32 voxelLength(t_voxelContainerTile::voxelLength);
+        const int32 voxelCount(t_voxelContainerTile::voxelCount);
+        const vector3int32 posContainerAbsolut(voxelContainerOffset*voxelLength);
+        const blub::axisAlignedBox tileAabb(vector3(posContainerAbsolut), vector3(posContainerAbsolut + vector3int32(voxelLength-1)));
+
+        vector<t_voxel> result(voxelCount);
+        bool resultEmpty(true);
+
+        t_voxelContainerTilePtr childResult(t_voxelContainerTile::create());
+        childResult->startEdit();
+
+        for (const child& work : m_children)
+        {
+            const transform childTrans(combineTransform(trans, work.trans));
+            const bool intersects(work.edit_->getAxisAlignedBoundingBox(childTrans).intersects(tileAabb));
+            if (!intersects)
+            {
+                if (work.op == operation::intersect && !resultEmpty)
+                {
+                    result.assign(voxelCount, t_voxel());
+                    resultEmpty = true;
+                }
+                continue;
+            }
+            if (resultEmpty && (work.op == operation::subtract || work.op == operation::intersect))
+            {
+                continue;
+            }
+
+            childResult->setEmpty();
+            work.edit_->calculateVoxel(childResult.data(), voxelContainerOffset, childTrans);
+            const typename t_voxelContainerTile::t_voxelArray& childVoxels(childResult->getVoxelArray());
+
+            switch (work.op)
+            {
+            case operation::merge:
+                for (int32 index = 0; index < voxelCount; ++index)
+                {
+                    if (childVoxels[index].getInterpolation() > result[index].getInterpolation())
+                    {
+                        result[index] = childVoxels[index];
+                    }
+                }
+                break;
+            case operation::subtract:
+                for (int32 index = 0; index < voxelCount; ++index)
+                {
+                    const int8 inverted(-childVoxels[index].getInterpolation());
+                    if (inverted < result[index].getInterpolation())
+                    {
+                        result[index] = childVoxels[index];
+                        result[index].setInterpolation(inverted);
+                    }
+                }
+                break;
+            case operation::intersect:
+                for (int32 index = 0; index < voxelCount; ++index)
+                {
+                    if (childVoxels[index].getInterpolation() < result[index].getInterpolation())
+                    {
+                        result[index] = childVoxels[index];
+                    }
+                }
+                break;
+            case operation::smoothMerge:
+            {
+                const real blend(work.blendRadius*127.);
+                for (int32 index = 0; index < voxelCount; ++index)
+                {
+                    const t_voxel& childVoxel(childVoxels[index]);
+                    const real valueA(result[index].getInterpolation());
+                    const real valueB(childVoxel.getInterpolation());
+
+                    // outside the interpolation range of one of the surfaces - blending would create surfaces out of clamped values
+                    if (blend <= 0. || result[index].isMin() || childVoxel.isMin())
+                    {
+                        if (valueB > valueA)
+                        {
+                            result[index] = childVoxel;
+                        }
+                        continue;
+                    }
+
+                    // polynomial smooth maximum
+                    const real weight(math::clamp<real>(0.5 + 0.5*(valueB - valueA)/blend, 0., 1.));
+                    const real blended(valueA*(1. - weight) + valueB*weight + blend*weight*(1. - weight));
+                    if (weight >= 0.5)
+                    {
+                        result[index] = childVoxel;
+                    }
+                    result[index].setInterpolation(static_cast<int8>(math::clamp<real>(blended, -127., 127.)));
+                }
+                break;
+            }
+            default:
+                BASSERT(false);
+                break;
+            }
+            resultEmpty = false;
+        }
+
+        if (resultEmpty)
+        {
+            return;
+        }
+
+        for (int32 indX = 0; indX < voxelLength; ++indX)
+        {
+            for (int32 indY = 0; indY < voxelLength; ++indY)
+            {
+                for (int32 indZ = 0; indZ < voxelLength; ++indZ)
+                {
+                    const vector3int32 posVoxel(indX, indY, indZ);
+                    t_voxel& voxelResult(result[t_voxelContainerTile::calculateIndex(posVoxel)]);
+
+                    if (voxelResult.isMin())
+                    {
+                        continue;
+                    }
+                    if (t_base::m_attributesOnly)
+                    {
+                        t_base::setVoxelAttributesOnly(voxelContainer, posVoxel, voxelResult);
+                    }
+                    else if (!t_base::m_cut)
+                    {
+                        voxelContainer->setVoxelIfInterpolationHigher(posVoxel, voxelResult);
+                    }
+                    else
+                    {
+                        voxelResult.getInterpolation() *= -1;
+                        voxelContainer->setVoxelIfInterpolationLower(posVoxel, voxelResult);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief combineTransform returns the absolute transform of a child.
+     * Exact for uniform scale of parent or if the child isn't rotated. Asserts otherwise, a transform can't describe the sheared child.
+     * @param parent The absolute transform of the parent.
+     * @param relative The transform of the child relative to parent.
+     */
+    static transform combineTransform(const transform& parent, const transform& relative)
+    {
+        BASSERT((parent.scale.x == parent.scale.y && parent.scale.y == parent.scale.z) || relative.rotation == quaternion());
+
+        return transform(parent.rotation*(relative.position*parent.scale) + parent.position,
+                         parent.rotation*relative.rotation,
+                         parent.scale*relative.scale);
+    }
+
+protected:
+    /**
+     * @brief composite constructor. See create().
+     */
+    composite()
+    {
+        ;
+    }
+
+protected:
+    t_children m_children;
+
+};
+
+
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_EDIT_COMPOSITE_HPP
@@ -0,0 +1,397 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_EDIT_FILTER_HPP
+#define BLUB_PROCEDURAL_VOXEL_EDIT_FILTER_HPP
+
+#include "blub/core/vector.hpp"
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/sphere.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/base.hpp"
+#include "blub/procedural/voxel/simple/container/utils/tile.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace edit
+{
+
+
+/**
+ * @brief The filter class smoothes or erodes the interpolation of the voxel inside a sphere-brush.
+ * The kernel gets applied separable in three passes along z, y and x. Every tile gathers its halo from the neighbour tiles once.
+ * The neighbour tiles get read from a snapshot taken before the edit gets dispatched, so the result doesn't depend on the order in which the tiles get calculated.
+ * Only the position of the transform is used. setCut() is ignored.
+ * The filter only changes the interpolation, so setAttributesOnly() is not supported.
+ * The snapshot is stored in the instance, so an instance must not be applied to two containers at the same time and can't be a child of a composite.
+ */
+template <class configType>
+class filter : public base<configType>
+{
+public:
+    typedef configType t_config;
+    typedef base<t_config> t_base;
+    typedef sharedPointer<filter<t_config> > pointer;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_base::t_voxelContainerBase t_voxelContainerBase;
+    typedef typename t_base::t_voxelContainerTile t_voxelContainerTile;
+    typedef simple::container::utils::tile<t_voxelContainerTile> t_utilsTile;
+
+    /**
+     * @brief The kernel enum describes the filter.
+     */
+    enum class kernel
+    {
+        /// average of all voxel in radius
+        box,
+        /// gaussian weighted average, sigma is radius/2
+        gaussian,
+        /// minimum of all voxel in radius - removes material
+        erode,
+        /// maximum of all voxel in radius - adds material
+        dilate
+    };
+
+    /**
+     * @brief create creates an instance.
+     * @param brush The voxel inside the sphere get filtered.
+     * @param kernel_ The filter.
+     * @param radius Radius of the kernel in voxel. 1 <= radius <= voxelsPerTile
+     * @param strength 0 <= strength <= 1. Blends between the voxel before and the filtered voxel.
+     * @return never nullptr.
+     */
+    static pointer create(const blub::sphere& brush, const kernel& kernel_ = kernel::gaussian, const int32& radius = 2, const real& strength = 1.)
+    {
+        return pointer(new filter(brush, kernel_, radius, strength));
+    }
+    /**
+     * @brief ~filter destructor
+     */
+    virtual ~filter()
+    {
+        ;
+    }
+
+    /**
+     * @brief getAxisAlignedBoundingBox returns the bounds of the brush.
+     * @param trans Only position is used.
+     */
+    blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const override
+    {
+        const vector3 center(m_brush.getCenter() + trans.position);
+        return blub::axisAlignedBox(center - vector3(m_brush.getRadius()), center + vector3(m_brush.getRadius()));
+    }
+
+    /**
+     * @brief prepareCalculateVoxelMaster takes a snapshot of all tiles the filter reads, including the halo.
+     * @param voxelContainer The container the filter gets applied to.
+     * @param trans Only position is used.
+     */
+    void prepareCalculateVoxelMaster(const t_voxelContainerBase& voxelContainer, const transform& trans) const override
+    {
+        BASSERT(m_snapshot.empty()); // the instance is in calculation by another container
+        const blub::axisAlignedBox aabb(getAxisAlignedBoundingBox(trans));
+        // tiles that may get edited - every one of them reads up to one tile around it
+        const vector3int32 editStart(t_voxelContainerBase::calculateVoxelPosToTileId(vector3int32(aabb.getMinimum().getFloor())));
+        const vector3int32 editEnd(t_voxelContainerBase::calculateVoxelPosToTileId(vector3int32(aabb.getMaximum().getFloor())) + vector3int32(1));
+        m_snapshotStart = editStart - vector3int32(1);
+        m_snapshotSize = editEnd + vector3int32(1) - m_snapshotStart;
+
+        m_snapshot.clear();
+        m_snapshot.resize(m_snapshotSize.x*m_snapshotSize.y*m_snapshotSize.z);
+        for (int32 indX = 0; indX < m_snapshotSize.x; ++indX)
+        {
+            for (int32 indY = 0; indY < m_snapshotSize.y; ++indY)
+            {
+                for (int32 indZ = 0; indZ < m_snapshotSize.z; ++indZ)
+                {
+                    const vector3int32 id(indX, indY, indZ);
+                    const vector3int32 tileId(m_snapshotStart + id);
+                    t_utilsTile holder(voxelContainer.getTileHolder(tileId));
+                    if (holder.state == simple::container::utils::tileState::partitial &&
+                        tileId >= editStart && tileId < editEnd)
+                    {
+                        // tiles get changed in place while calculating
+                        sharedPointer<t_voxelContainerTile> copy(t_voxelContainerTile::create());
+                        *copy = *holder.data;
+                        holder.data = copy;
+                    }
+                    m_snapshot[calculateSnapshotIndex(id)] = holder;
+                }
+            }
+        }
+    }
+    /**
+     * @brief finishCalculateVoxelMaster releases the snapshot.
+     */
+    void finishCalculateVoxelMaster() const override
+    {
+        m_snapshot.clear();
+    }
+    /**
+     * @brief getReadsContainer returns true, the filter reads the voxel it changes.
+     */
+    bool getReadsContainer() const override
+    {
+        return true;
+    }
+
+    /**
+     * @brief calculateVoxel gathers the tile and its halo from the snapshot, filters it and blends the result into voxelContainer.
+     * @param voxelContainer Must not be nullptr.
+     * @param voxelContainerOffset The tile-id of voxelContainer.
+     * @param trans Only position is used.
+     */
+    void calculateVoxel(t_voxelContainerTile* voxelContainer,
+                        const vector3int32& voxelContainerOffset,
+                        const transform &trans) const override
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const vector3int32 posContainerAbsolut(voxelContainerOffset*voxelsPerTile);
+        const vector3 center(m_brush.getCenter() + trans.position);
+        BASSERT(!t_base::getAttributesOnly()); // the filter only changes the interpolation
+
+        vector3int32 voxelStart;
+        vector3int32 voxelEnd;
+        if (!t_base::calculateVoxelRange(getAxisAlignedBoundingBox(trans), posContainerAbsolut, voxelStart, voxelEnd))
+        {
+            return;
+        }
+
+        const int32 lengthWithHalo(voxelsPerTile + 2*m_radius);
+        vector<float> values(lengthWithHalo*lengthWithHalo*lengthWithHalo);
+        vector<float> buffer(values.size());
+
+        gather(voxelContainerOffset, values);
+
+        // separable - every pass only calculates the values needed by the next pass
+        filterPass(values, buffer, 2, vector3int32(0, 0, m_radius), vector3int32(lengthWithHalo, lengthWithHalo, m_radius + voxelsPerTile));
+        filterPass(buffer, values, 1, vector3int32(0, m_radius, m_radius), vector3int32(lengthWithHalo, m_radius + voxelsPerTile, m_radius + voxelsPerTile));
+        filterPass(values, buffer, 0, vector3int32(m_radius), vector3int32(m_radius + voxelsPerTile));
+
+        const real falloff(math::max<real>(m_brush.getRadius()*0.25, 1.));
+        for (int32 indX = voxelStart.x; indX < voxelEnd.x; ++indX)
+        {
+            for (int32 indY = voxelStart.y; indY < voxelEnd.y; ++indY)
+            {
+                for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
+                {
+                    const vector3int32 posVoxel(indX, indY, indZ);
+                    const real distance(center.distance(vector3(posContainerAbsolut + posVoxel)));
+                    const real weight(m_strength*math::clamp<real>((m_brush.getRadius() - distance) / falloff, 0., 1.));
+                    if (weight <= 0.)
+                    {
+                        continue;
+                    }
+
+                    t_voxel result(voxelContainer->getVoxel(posVoxel));
+                    const real before(result.getInterpolation());
+                    const real filtered(buffer[calculateIndex(posVoxel + vector3int32(m_radius), lengthWithHalo)]);
+                    const real blended(before + (filtered - before)*weight);
+
+                    result.setInterpolation(static_cast<int8>(math::clamp<real>(std::floor(blended + 0.5), -127., 127.)));
+                    voxelContainer->setVoxel(posVoxel, result);
+                }
+            }
+        }
+    }
+
+protected:
+    /**
+     * @brief filter constructor. See create().
+     */
+    filter(const blub::sphere& brush, const kernel& kernel_, const int32& radius, const real& strength)
+        : m_brush(brush)
+        , m_kernel(kernel_)
+        , m_radius(radius)
+        , m_strength(strength)
+    {
+        BASSERT(m_radius >= 1);
+        BASSERT(m_radius <= t_config::voxelsPerTile);
+        BASSERT(m_strength >= 0. && m_strength <= 1.);
+
+        if (m_kernel == kernel::gaussian)
+        {
+            const real sigma(static_cast<real>(m_radius)*0.5);
+            real sum(0.);
+            for (int32 ind = -m_radius; ind <= m_radius; ++ind)
+            {
+                const real weight(std::exp(-static_cast<real>(ind*ind) / (2.*sigma*sigma)));
+                m_weights.push_back(weight);
+                sum += weight;
+            }
+            for (float& weight : m_weights)
+            {
+                weight /= sum;
+            }
+        }
+        else
+        {
+            m_weights.resize(2*m_radius + 1, 1.f / static_cast<float>(2*m_radius + 1));
+        }
+    }
+
+    static int32 calculateIndex(const vector3int32& pos, const int32& length)
+    {
+        return (pos.x*length + pos.y)*length + pos.z;
+    }
+
+    int32 calculateSnapshotIndex(const vector3int32& id) const
+    {
+        BASSERT(id >= vector3int32(0));
+        BASSERT(id < m_snapshotSize);
+        return (id.x*m_snapshotSize.y + id.y)*m_snapshotSize.z + id.z;
+    }
+
+    /**
+     * @brief gather copies the interpolation of the tile and its halo out of the snapshot. Copies row by row per source tile.
+     * @param id The tile-id.
+     * @param result Gets filled. Size (voxelsPerTile + 2*radius)^3.
+     */
+    void gather(const vector3int32& id, vector<float>& result) const
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const int32 lengthWithHalo(voxelsPerTile + 2*m_radius);
+        const vector3int32 gatherStart(id*voxelsPerTile - vector3int32(m_radius));
+
+        // the halo is at most one tile thick
+        for (int32 tileX = -1; tileX <= 1; ++tileX)
+        {
+            for (int32 tileY = -1; tileY <= 1; ++tileY)
+            {
+                for (int32 tileZ = -1; tileZ <= 1; ++tileZ)
+                {
+                    const vector3int32 sourceId(id + vector3int32(tileX, tileY, tileZ));
+                    const vector3int32 sourceStart(sourceId*voxelsPerTile);
+                    // overlap of the source tile and the gather-region, relative to the source tile
+                    const vector3int32 from(vector3int32(0).getMaximum(gatherStart - sourceStart));
+                    const vector3int32 to(vector3int32(voxelsPerTile).getMinimum(gatherStart + vector3int32(lengthWithHalo) - sourceStart));
+                    if (!(from < to))
+                    {
+                        continue;
+                    }
+
+                    const t_utilsTile& holder(m_snapshot[calculateSnapshotIndex(sourceId - m_snapshotStart)]);
+                    const vector3int32 offset(sourceStart - gatherStart);
+                    for (int32 indX = from.x; indX < to.x; ++indX)
+                    {
+                        for (int32 indY = from.y; indY < to.y; ++indY)
+                        {
+                            float* row(&result[calculateIndex(offset + vector3int32(indX, indY, 0), lengthWithHalo)]);
+                            if (holder.state != simple::container::utils::tileState::partitial)
+                            {
+                                const float value(holder.state == simple::container::utils::tileState::full ? 127.f : -127.f);
+                                for (int32 indZ = from.z; indZ < to.z; ++indZ)
+                                {
+                                    row[indZ] = value;
+                                }
+                                continue;
+                            }
+                            const t_voxel* source(&holder.data->getVoxel(t_voxelContainerTile::calculateIndex(vector3int32(indX, indY, 0))));
+                            for (int32 indZ = from.z; indZ < to.z; ++indZ)
+                            {
+                                row[indZ] = source[indZ].getInterpolation();
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief filterPass applies the kernel along one axis.
+     * @param source Input values.
+     * @param result Output values. Only the values between start and end get written.
+     * @param axis 0 for x, 1 for y, 2 for z.
+     * @param start First position to calculate.
+     * @param end Position after the last one to calculate.
+     */
+    void filterPass(const vector<float>& source, vector<float>& result, const int32& axis, const vector3int32& start, const vector3int32& end) const
+    {
+        const int32 lengthWithHalo(t_config::voxelsPerTile + 2*m_radius);
+        const int32 stride(axis == 0 ? lengthWithHalo*lengthWithHalo : (axis == 1 ? lengthWithHalo : 1));
+        const int32 kernelLength(m_weights.size());
+
+        for (int32 indX = start.x; indX < end.x; ++indX)
+        {
+            for (int32 indY = start.y; indY < end.y; ++indY)
+            {
+                const int32 rowStart(calculateIndex(vector3int32(indX, indY, start.z), lengthWithHalo));
+                const int32 rowLength(end.z - start.z);
+                float* resultRow(&result[rowStart]);
+
+                // loops over z innermost, so all passes run along contiguous rows
+                switch (m_kernel)
+                {
+                case kernel::box:
+                case kernel::gaussian:
+                    for (int32 indZ = 0; indZ < rowLength; ++indZ)
+                    {
+                        resultRow[indZ] = 0.f;
+                    }
+                    for (int32 indKernel = 0; indKernel < kernelLength; ++indKernel)
+                    {
+                        const float weight(m_weights[indKernel]);
+                        const float* sourceRow(&source[rowStart + (indKernel - m_radius)*stride]);
+                        for (int32 indZ = 0; indZ < rowLength; ++indZ)
+                        {
+                            resultRow[indZ] += sourceRow[indZ]*weight;
+                        }
+                    }
+                    break;
+                case kernel::erode:
+                case kernel::dilate:
+                {
+                    const bool erode(m_kernel == kernel::erode);
+                    const float* sourceFirst(&source[rowStart - m_radius*stride]);
+                    for (int32 indZ = 0; indZ < rowLength; ++indZ)
+                    {
+                        resultRow[indZ] = sourceFirst[indZ];
+                    }
+                    for (int32 indKernel = 1; indKernel < kernelLength; ++indKernel)
+                    {
+                        const float* sourceRow(&source[rowStart + (indKernel - m_radius)*stride]);
+                        for (int32 indZ = 0; indZ < rowLength; ++indZ)
+                        {
+                            resultRow[indZ] = erode ? std::min(resultRow[indZ], sourceRow[indZ]) : std::max(resultRow[indZ], sourceRow[indZ]);
+                        }
+                    }
+                    break;
+                }
+                default:
+                    BASSERT(false);
+                    break;
+                }
+            }
+        }
+    }
+
+protected:
+    const blub::sphere m_brush;
+    const kernel m_kernel;
+    const int32 m_radius;
+    const real m_strength;
+    vector<float> m_weights;
+
+    // snapshot of the tiles, valid between prepareCalculateVoxelMaster() and finishCalculateVoxelMaster()
+    mutable vector<t_utilsTile> m_snapshot;
+    mutable vector3int32 m_snapshotStart;
+    mutable vector3int32 m_snapshotSize;
+
+};
+
+
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_EDIT_FILTER_HPP
@@ -0,0 +1,349 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_EDIT_HEIGHTMAP_HPP
+#define BLUB_PROCEDURAL_VOXEL_EDIT_HEIGHTMAP_HPP
+
+#include "blub/core/vector.hpp"
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/math/vector2int.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/voxel/edit/base.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace edit
+{
+
+
+/**
+ * @brief The heightmap class converts a 2d-heightmap to voxel. The voxel between bottom and the bilinear sampled height are solid.
+ * The heightmap lies in the x/z-plane, the height grows along the y-axis. Sample (x, z) has the edit-space position (x, height, z).
+ * Use the position and scale of the transform to place and stretch the heightmap. Rotation is not supported.
+ * The edit replaces all voxel inside getAxisAlignedBoundingBox(), setCut() is ignored.
+ * Tiles that are completely below the surface get set to full, tiles completely above to empty - without allocation or calculating any voxel.
+ * With setAttributesOnly() every tile gets calculated.
+ * Only tiles that contain the surface get calculated, column by column.
+ * The column bounds are stored in the instance, so an instance must not be applied to two containers at the same time or added twice to a composite.
+ */
+template <class configType>
+class heightmap : public base<configType>
+{
+public:
+    typedef configType t_config;
+    typedef base<t_config> t_base;
+    typedef sharedPointer<heightmap<t_config> > pointer;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_base::t_voxelContainerTile t_voxelContainerTile;
+    typedef typename t_base::t_voxelContainerBase t_voxelContainerBase;
+    typedef vector<real> t_heights;
+
+    /**
+     * @brief create creates an instance.
+     * @param size Number of samples on the x- and z-axis. Both must be at least 2.
+     * @param heights size.x*size.y samples. Index of sample (x, z) is z*size.x + x.
+     * @param bottom The height where the solid voxel begin.
+     * @return never nullptr.
+     */
+    static pointer create(const vector2int32& size, const t_heights& heights, const real& bottom = 0.)
+    {
+        return pointer(new heightmap(size, heights, bottom));
+    }
+    /**
+     * @brief ~heightmap destructor
+     */
+    virtual ~heightmap()
+    {
+        ;
+    }
+
+    /**
+     * @brief getSize returns the number of samples on the x- and z-axis.
+     */
+    const vector2int32& getSize() const
+    {
+        return m_size;
+    }
+    /**
+     * @brief getHeights returns the samples set by create().
+     */
+    const t_heights& getHeights() const
+    {
+        return m_heights;
+    }
+    /**
+     * @brief getBottom returns the height where the solid voxel begin.
+     */
+    const real& getBottom() const
+    {
+        return m_bottom;
+    }
+
+    /**
+     * @brief getAxisAlignedBoundingBox returns the bounds of the heightmap including the interpolation range of one voxel.
+     * @param trans Position and scale are used.
+     */
+    blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const override
+    {
+        checkTransform(trans);
+
+        const vector3 minimum(trans.position.x,
+                              calculateHeightAbsolut(m_bottom, trans) - 1.,
+                              trans.position.z);
+        const vector3 maximum(trans.position.x + (m_size.x - 1)*trans.scale.x,
+                              calculateHeightAbsolut(m_maximum, trans) + 1.,
+                              trans.position.z + (m_size.y - 1)*trans.scale.z);
+        return blub::axisAlignedBox(minimum, maximum);
+    }
+
+    /**
+     * @brief prepareCalculateVoxelMaster calculates the minimum and maximum height of every tile-column. Used by calculateTileState().
+     * @param voxelContainer Not used.
+     * @param trans Position and scale are used.
+     */
+    void prepareCalculateVoxelMaster(const t_voxelContainerBase& voxelContainer, const transform& trans) const override
+    {
+        (void)voxelContainer;
+        BASSERT(m_columns.empty()); // the instance is in calculation by another container
+
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const blub::axisAlignedBox aabb(getAxisAlignedBoundingBox(trans));
+
+        m_columnStart = vector2int32(math::floor(aabb.getMinimum().x / voxelsPerTile),
+                                     math::floor(aabb.getMinimum().z / voxelsPerTile));
+        const vector2int32 columnEnd(math::floor(aabb.getMaximum().x / voxelsPerTile) + 1,
+                                     math::floor(aabb.getMaximum().z / voxelsPerTile) + 1);
+        m_columnCount = vector2int32(columnEnd.x - m_columnStart.x, columnEnd.y - m_columnStart.y);
+
+        m_columns.resize(m_columnCount.x*m_columnCount.y);
+        for (int32 indX = 0; indX < m_columnCount.x; ++indX)
+        {
+            for (int32 indZ = 0; indZ < m_columnCount.y; ++indZ)
+            {
+                const int32 voxelX((m_columnStart.x + indX)*voxelsPerTile);
+                const int32 voxelZ((m_columnStart.y + indZ)*voxelsPerTile);
+
+                // the bilinear interpolated surface lies between the samples around the tile
+                const int32 sampleStartX(math::clamp<real>(math::floor((voxelX - trans.position.x) / trans.scale.x), 0., m_size.x-1));
+                const int32 sampleEndX(math::clamp<real>(math::ceil((voxelX + voxelsPerTile-1 - trans.position.x) / trans.scale.x), 0., m_size.x-1));
+                const int32 sampleStartZ(math::clamp<real>(math::floor((voxelZ - trans.position.z) / trans.scale.z), 0., m_size.y-1));
+                const int32 sampleEndZ(math::clamp<real>(math::ceil((voxelZ + voxelsPerTile-1 - trans.position.z) / trans.scale.z), 0., m_size.y-1));
+
+                column& result(m_columns[indX*m_columnCount.y + indZ]);
+                result.minimum = getSample(sampleStartX, sampleStartZ);
+                result.maximum = result.minimum;
+                for (int32 sampleX = sampleStartX; sampleX <= sampleEndX; ++sampleX)
+                {
+                    for (int32 sampleZ = sampleStartZ; sampleZ <= sampleEndZ; ++sampleZ)
+                    {
+                        const real sample(getSample(sampleX, sampleZ));
+                        result.minimum = math::min(result.minimum, sample);
+                        result.maximum = math::max(result.maximum, sample);
+                    }
+                }
+                result.minimum = calculateHeightAbsolut(result.minimum, trans);
+                result.maximum = calculateHeightAbsolut(result.maximum, trans);
+            }
+        }
+    }
+    /**
+     * @brief finishCalculateVoxelMaster frees the column bounds.
+     */
+    void finishCalculateVoxelMaster() const override
+    {
+        m_columns.clear();
+    }
+
+    /**
+     * @brief calculateTileState returns full if the tile is completely below the surface and empty if it is completely above.
+     * Tiles that aren't completely inside getAxisAlignedBoundingBox() and all tiles of an edit with setAttributesOnly() always get calculated.
+     * @param tileBounds The absolute voxel bounds of the tile.
+     * @param trans Position and scale are used.
+     */
+    simple::container::utils::tileState calculateTileState(const blub::axisAlignedBox& tileBounds, const transform& trans) const override
+    {
+        if (t_base::m_attributesOnly)
+        {
+            return simple::container::utils::tileState::partitial; // a full or empty tile would replace the geometry
+        }
+        if (!getAxisAlignedBoundingBox(trans).contains(tileBounds))
+        {
+            return simple::container::utils::tileState::partitial;
+        }
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const vector2int32 columnId(vector2int32(math::floor(tileBounds.getMinimum().x / voxelsPerTile),
+                                                 math::floor(tileBounds.getMinimum().z / voxelsPerTile)));
+        const vector2int32 columnIdRelative(columnId.x - m_columnStart.x, columnId.y - m_columnStart.y);
+        if (columnIdRelative.x < 0 || columnIdRelative.y < 0 ||
+            columnIdRelative.x >= m_columnCount.x || columnIdRelative.y >= m_columnCount.y ||
+            m_columns.empty())
+        {
+            BASSERT(false); // prepareCalculateVoxelMaster() didn't get called
+            return simple::container::utils::tileState::partitial;
+        }
+        const column& bounds(m_columns[columnIdRelative.x*m_columnCount.y + columnIdRelative.y]);
+        const real bottom(calculateHeightAbsolut(m_bottom, trans));
+
+        if (tileBounds.getMinimum().y >= bottom + 1. && tileBounds.getMaximum().y <= bounds.minimum - 1.)
+        {
+            return simple::container::utils::tileState::full;
+        }
+        if (tileBounds.getMinimum().y >= bounds.maximum + 1. || tileBounds.getMaximum().y <= bottom - 1.)
+        {
+            return simple::container::utils::tileState::empty;
+        }
+        return simple::container::utils::tileState::partitial;
+    }
+
+    /**
+     * @brief calculateVoxel samples the height once per voxel-column and writes the voxel row by row.
+     * @param voxelContainer Must not be nullptr.
+     * @param voxelContainerOffset The tile-id of voxelContainer.
+     * @param trans Position and scale are used.
+     */
+    void calculateVoxel(t_voxelContainerTile* voxelContainer,
+                        const vector3int32& voxelContainerOffset,
+                        const transform &trans) const override
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const vector3int32 posContainerAbsolut(voxelContainerOffset*voxelsPerTile);
+
+        vector3int32 voxelStart;
+        vector3int32 voxelEnd;
+        if (!t_base::calculateVoxelRange(getAxisAlignedBoundingBox(trans), posContainerAbsolut, voxelStart, voxelEnd))
+        {
+            return;
+        }
+
+        real heights[voxelsPerTile*voxelsPerTile];
+        for (int32 indX = voxelStart.x; indX < voxelEnd.x; ++indX)
+        {
+            for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
+            {
+                const real sampleX((posContainerAbsolut.x + indX - trans.position.x) / trans.scale.x);
+                const real sampleZ((posContainerAbsolut.z + indZ - trans.position.z) / trans.scale.z);
+                heights[indX*voxelsPerTile + indZ] = calculateHeightAbsolut(sampleHeight(sampleX, sampleZ), trans);
+            }
+        }
+
+        const real bottom(calculateHeightAbsolut(m_bottom, trans));
+        const int32 rowLength(voxelEnd.z - voxelStart.z);
+        t_voxel row[voxelsPerTile];
+        for (int32 indX = voxelStart.x; indX < voxelEnd.x; ++indX)
+        {
+            for (int32 indY = voxelStart.y; indY < voxelEnd.y; ++indY)
+            {
+                const real posY(posContainerAbsolut.y + indY);
+                for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
+                {
+                    const real distanceToSurface(math::min(heights[indX*voxelsPerTile + indZ] - posY, posY - bottom));
+                    row[indZ - voxelStart.z].setInterpolation(static_cast<int8>(math::clamp<real>(distanceToSurface*127., -127., 127.)));
+                }
+                if (t_base::m_attributesOnly)
+                {
+                    for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
+                    {
+                        t_base::setVoxelAttributesOnly(voxelContainer, vector3int32(indX, indY, indZ), row[indZ - voxelStart.z]);
+                    }
+                    continue;
+                }
+                voxelContainer->setVoxelRow(vector3int32(indX, indY, voxelStart.z), row, rowLength);
+            }
+        }
+    }
+
+protected:
+    /**
+     * @brief heightmap constructor. See create().
+     */
+    heightmap(const vector2int32& size, const t_heights& heights, const real& bottom)
+        : m_size(size)
+        , m_heights(heights)
+        , m_bottom(bottom)
+        , m_maximum(bottom)
+    {
+        BASSERT(m_size.x >= 2 && m_size.y >= 2);
+        BASSERT(static_cast<int32>(m_heights.size()) == m_size.x*m_size.y);
+
+        for (const real& height : m_heights)
+        {
+            m_maximum = math::max(m_maximum, height);
+        }
+    }
+
+    /**
+     * @brief getSample returns the height of a sample.
+     */
+    const real& getSample(const int32& x, const int32& z) const
+    {
+        return m_heights[z*m_size.x + x];
+    }
+
+    /**
+     * @brief sampleHeight bilinear interpolates the height. Positions outside the heightmap get clamped.
+     * @param x Edit-space position.
+     * @param z Edit-space position.
+     */
+    real sampleHeight(const real& x, const real& z) const
+    {
+        const real clampedX(math::clamp<real>(x, 0., m_size.x-1));
+        const real clampedZ(math::clamp<real>(z, 0., m_size.y-1));
+        const int32 sampleX(math::min<int32>(math::floor(clampedX), m_size.x-2));
+        const int32 sampleZ(math::min<int32>(math::floor(clampedZ), m_size.y-2));
+        const real weightX(clampedX - sampleX);
+        const real weightZ(clampedZ - sampleZ);
+
+        const real heightZ0(getSample(sampleX, sampleZ)*(1. - weightX) + getSample(sampleX+1, sampleZ)*weightX);
+        const real heightZ1(getSample(sampleX, sampleZ+1)*(1. - weightX) + getSample(sampleX+1, sampleZ+1)*weightX);
+        return heightZ0*(1. - weightZ) + heightZ1*weightZ;
+    }
+
+    /**
+     * @brief calculateHeightAbsolut converts an edit-space height to an absolute one.
+     */
+    static real calculateHeightAbsolut(const real& height, const transform& trans)
+    {
+        return height*trans.scale.y + trans.position.y;
+    }
+
+    static void checkTransform(const transform& trans)
+    {
+        (void)trans;
+        BASSERT(trans.rotation == quaternion());
+        BASSERT(trans.scale.x > 0. && trans.scale.y > 0. && trans.scale.z > 0.);
+    }
+
+    /**
+     * @brief The column struct holds the absolute height-range of the surface above one tile-column.
+     */
+    struct column
+    {
+        real minimum;
+        real maximum;
+    };
+
+protected:
+    const vector2int32 m_size;
+    const t_heights m_heights;
+    const real m_bottom;
+    real m_maximum;
+
+    // set by prepareCalculateVoxelMaster()
+    mutable vector<column> m_columns;
+    mutable vector2int32 m_columnStart;
+    mutable vector2int32 m_columnCount;
+
+};
+
+
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_EDIT_HEIGHTMAP_HPP
@@ -0,0 +1,293 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_EDIT_PREFAB_HPP
+#define BLUB_PROCEDURAL_VOXEL_EDIT_PREFAB_HPP
+
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/voxel/edit/base.hpp"
+#include "blub/procedural/voxel/simple/container/utils/prefab.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace edit
+{
+
+
+/**
+ * @brief The prefab class stamps a simple::container::utils::prefab created by simple::container::base::createPrefab().
+ * The position of the transform is the integer voxel-offset of the first prefab-voxel. Rotation and scale are not supported.
+ * If the offset is a multiple of voxelsPerTile whole tiles get copied as array or set to full/empty without touching single voxel.
+ * Else the voxel get merged one by one.
+ * setCut() is ignored, use blendMode::subtract. With setAttributesOnly() the attributes of all prefab-voxel that aren't minimum get set, independent of the blendMode.
+ */
+template <class configType>
+class prefab : public base<configType>
+{
+public:
+    typedef configType t_config;
+    typedef base<t_config> t_base;
+    typedef sharedPointer<prefab<t_config> > pointer;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_base::t_voxelContainerTile t_voxelContainerTile;
+    typedef simple::container::utils::prefab<t_config> t_prefab;
+    typedef typename t_prefab::constPointer t_prefabConstPtr;
+    typedef typename t_prefab::t_utilsTile t_prefabTile;
+
+    /**
+     * @brief The blendMode enum describes how the prefab voxel get combined with the voxel in the container.
+     */
+    enum class blendMode
+    {
+        /// overwrites all voxel of the region
+        replace,
+        /// voxel only get set if the interpolation is higher
+        merge,
+        /// removes the prefab
+        subtract,
+        /// voxel only get set if the interpolation is lower
+        intersect
+    };
+
+    /**
+     * @brief create creates an instance.
+     * @param toStamp Must not be nullptr. Don't change it while stamping.
+     * @param mode How the prefab gets combined with the container.
+     * @return never nullptr.
+     */
+    static pointer create(t_prefabConstPtr toStamp, const blendMode& mode = blendMode::replace)
+    {
+        return pointer(new prefab(toStamp, mode));
+    }
+    /**
+     * @brief ~prefab destructor
+     */
+    virtual ~prefab()
+    {
+        ;
+    }
+
+    /**
+     * @brief getAxisAlignedBoundingBox returns the voxel-region the prefab gets stamped to.
+     * @param trans Only position is used.
+     */
+    blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const override
+    {
+        const vector3int32 offset(calculateOffset(trans));
+        return blub::axisAlignedBox(vector3(offset), vector3(offset + m_prefab->getSize() - vector3int32(1)));
+    }
+
+    /**
+     * @brief calculateVoxel stamps the part of the prefab overlapping the tile.
+     * @param voxelContainer Must not be nullptr.
+     * @param voxelContainerOffset The tile-id of voxelContainer.
+     * @param trans Only position is used.
+     */
+    void calculateVoxel(t_voxelContainerTile* voxelContainer,
+                        const vector3int32& voxelContainerOffset,
+                        const transform &trans) const override
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const vector3int32 offset(calculateOffset(trans));
+        const vector3int32 posContainerInPrefab(voxelContainerOffset*voxelsPerTile - offset);
+
+        // whole tile inside the prefab and aligned to a prefab-tile
+        if (posContainerInPrefab % voxelsPerTile == vector3int32(0) &&
+            posContainerInPrefab >= vector3int32(0) &&
+            posContainerInPrefab + vector3int32(voxelsPerTile) <= m_prefab->getSize())
+        {
+            stampTile(voxelContainer, m_prefab->getTile(posContainerInPrefab / voxelsPerTile));
+            return;
+        }
+
+        const vector3int32 voxelStart(vector3int32(0).getMaximum(-posContainerInPrefab));
+        const vector3int32 voxelEnd(vector3int32(voxelsPerTile).getMinimum(m_prefab->getSize() - posContainerInPrefab));
+        for (int32 indX = voxelStart.x; indX < voxelEnd.x; ++indX)
+        {
+            for (int32 indY = voxelStart.y; indY < voxelEnd.y; ++indY)
+            {
+                for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
+                {
+                    const vector3int32 posVoxel(indX, indY, indZ);
+                    stampVoxel(voxelContainer, posVoxel, m_prefab->getVoxel(posContainerInPrefab + posVoxel));
+                }
+            }
+        }
+    }
+
+protected:
+    /**
+     * @brief prefab constructor. See create().
+     */
+    prefab(t_prefabConstPtr toStamp, const blendMode& mode)
+        : m_prefab(toStamp)
+        , m_mode(mode)
+    {
+        BASSERT(!m_prefab.isNull());
+    }
+
+    /**
+     * @brief calculateOffset converts the transform to the voxel-offset.
+     */
+    static vector3int32 calculateOffset(const transform& trans)
+    {
+        BASSERT(trans.rotation == quaternion());
+        BASSERT(trans.scale == vector3(1.));
+
+        const vector3 rounded(math::floor(trans.position.x + 0.5), math::floor(trans.position.y + 0.5), math::floor(trans.position.z + 0.5));
+        BASSERT(rounded == trans.position);
+        return vector3int32(rounded.x, rounded.y, rounded.z);
+    }
+
+    /**
+     * @brief stampTile stamps a whole prefab-tile.
+     * @param voxelContainer The tile to change.
+     * @param toStamp The prefab-tile.
+     */
+    void stampTile(t_voxelContainerTile* voxelContainer, const t_prefabTile& toStamp) const
+    {
+        const bool full(toStamp.state == simple::container::utils::tileState::full);
+        const bool empty(toStamp.state == simple::container::utils::tileState::empty);
+
+        if (t_base::m_attributesOnly)
+        {
+            if (empty)
+            {
+                return;
+            }
+            t_voxel maxVoxel;
+            maxVoxel.setMax();
+            const int32 voxelsPerTile(t_config::voxelsPerTile);
+            for (int32 indX = 0; indX < voxelsPerTile; ++indX)
+            {
+                for (int32 indY = 0; indY < voxelsPerTile; ++indY)
+                {
+                    for (int32 indZ = 0; indZ < voxelsPerTile; ++indZ)
+                    {
+                        const vector3int32 posVoxel(indX, indY, indZ);
+                        t_base::setVoxelAttributesOnly(voxelContainer, posVoxel, full ? maxVoxel : toStamp.data->getVoxel(posVoxel));
+                    }
+                }
+            }
+            return;
+        }
+
+        switch (m_mode)
+        {
+        case blendMode::replace:
+            if (full)
+            {
+                voxelContainer->setFull();
+                return;
+            }
+            if (empty)
+            {
+                voxelContainer->setEmpty();
+                return;
+            }
+            voxelContainer->copyVoxels(*toStamp.data);
+            return;
+        case blendMode::merge:
+            if (full)
+            {
+                voxelContainer->setFull();
+                return;
+            }
+            if (empty)
+            {
+                return;
+            }
+            break;
+        case blendMode::subtract:
+            if (full)
+            {
+                voxelContainer->setEmpty();
+                return;
+            }
+            if (empty)
+            {
+                return;
+            }
+            break;
+        case blendMode::intersect:
+            if (full)
+            {
+                return;
+            }
+            if (empty)
+            {
+                voxelContainer->setEmpty();
+                return;
+            }
+            break;
+        default:
+            BASSERT(false);
+            break;
+        }
+
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        for (int32 indX = 0; indX < voxelsPerTile; ++indX)
+        {
+            for (int32 indY = 0; indY < voxelsPerTile; ++indY)
+            {
+                for (int32 indZ = 0; indZ < voxelsPerTile; ++indZ)
+                {
+                    const vector3int32 posVoxel(indX, indY, indZ);
+                    stampVoxel(voxelContainer, posVoxel, toStamp.data->getVoxel(posVoxel));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief stampVoxel combines one voxel depending on the blendMode.
+     * @param voxelContainer The tile to change.
+     * @param posVoxel Voxel-position in voxelContainer.
+     * @param toStamp The prefab-voxel.
+     */
+    void stampVoxel(t_voxelContainerTile* voxelContainer, const vector3int32& posVoxel, t_voxel toStamp) const
+    {
+        if (t_base::m_attributesOnly)
+        {
+            t_base::setVoxelAttributesOnly(voxelContainer, posVoxel, toStamp);
+            return;
+        }
+        switch (m_mode)
+        {
+        case blendMode::replace:
+            voxelContainer->setVoxel(posVoxel, toStamp);
+            break;
+        case blendMode::merge:
+            voxelContainer->setVoxelIfInterpolationHigher(posVoxel, toStamp);
+            break;
+        case blendMode::subtract:
+            toStamp.getInterpolation() *= -1;
+            voxelContainer->setVoxelIfInterpolationLower(posVoxel, toStamp);
+            break;
+        case blendMode::intersect:
+            voxelContainer->setVoxelIfInterpolationLower(posVoxel, toStamp);
+            break;
+        default:
+            BASSERT(false);
+            break;
+        }
+    }
+
+protected:
+    const t_prefabConstPtr m_prefab;
+    const blendMode m_mode;
+
+};
+
+
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_EDIT_PREFAB_HPP
@@ -60,16 +60,23 @@ public:
     }
 
     /**
-     * @brief getAxisAlignedBoundingBox returns the transformed aab that includes the sphere.
+     * @brief getAxisAlignedBoundingBox returns the transformed aab that includes the sphere and the voxel up to radius+1 calculateOneVoxel() interpolates.
      * @param trans Transform.
      * @return
      */
     blub::axisAlignedBox getAxisAlignedBoundingBox(const blub::transform &trans) const override
     {
-        const blub::axisAlignedBox aabb(m_sphere.getCenter() - blub::vector3(m_sphere.getRadius()),
-                                  m_sphere.getCenter() + blub::vector3(m_sphere.getRadius()));
-        return blub::axisAlignedBox(aabb.getMinimum()*trans.scale + trans.position,
-                                    aabb.getMaximum()*trans.scale + trans.position);
+        // the transformed sphere is an ellipsoid - its extent on axis i is radius*length(row i of rotation*scale)
+        const blub::vector3 axisX(trans.rotation*blub::vector3(trans.scale.x, 0., 0.));
+        const blub::vector3 axisY(trans.rotation*blub::vector3(0., trans.scale.y, 0.));
+        const blub::vector3 axisZ(trans.rotation*blub::vector3(0., 0., trans.scale.z));
+        const blub::vector3 halfSize(blub::vector3(axisX.x, axisY.x, axisZ.x).length(),
+                                     blub::vector3(axisX.y, axisY.y, axisZ.y).length(),
+                                     blub::vector3(axisX.z, axisY.z, axisZ.z).length());
+
+        const blub::vector3 center(trans.rotation*(m_sphere.getCenter()*trans.scale) + trans.position);
+        const blub::vector3 extent(halfSize*(m_sphere.getRadius() + 1.));
+        return blub::axisAlignedBox(center - extent, center + extent);
     }
 
 protected:
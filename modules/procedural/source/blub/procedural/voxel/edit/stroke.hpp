@@ -0,0 +1,333 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_EDIT_STROKE_HPP
+#define BLUB_PROCEDURAL_VOXEL_EDIT_STROKE_HPP
+
+#include "blub/core/vector.hpp"
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/base.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace edit
+{
+
+
+/**
+ * @brief The stroke class creates the volume swept by a sphere along a polyline.
+ * Every point of the polyline has its own radius, the radius gets interpolated linearly along the segments (tapered capsules).
+ * A whole brush-stroke of a sculpting tool can be sent as one edit instead of one sphere per sample.
+ * Only tiles touched by the capsule of a segment get scheduled.
+ */
+template <class configType>
+class stroke : public base<configType>
+{
+public:
+    typedef configType t_config;
+    typedef base<t_config> t_base;
+    typedef sharedPointer<stroke<t_config> > pointer;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_base::t_voxelContainerTile t_voxelContainerTile;
+
+    /**
+     * @brief The point struct describes one sample of the stroke.
+     */
+    struct point
+    {
+        point(const vector3& position_, const real& radius_)
+            : position(position_)
+            , radius(radius_)
+        {
+            ;
+        }
+
+        vector3 position;
+        real radius;
+    };
+    typedef vector<point> t_points;
+
+    /**
+     * @brief create creates an empty stroke.
+     * @return never nullptr.
+     */
+    static pointer create()
+    {
+        return pointer(new stroke());
+    }
+    /**
+     * @brief ~stroke destructor
+     */
+    virtual ~stroke()
+    {
+        ;
+    }
+
+    /**
+     * @brief addPoint appends a point to the polyline. Don't call while calculating voxel.
+     * @param position In edit-space.
+     * @param radius Must be larger zero.
+     */
+    void addPoint(const vector3& position, const real& radius)
+    {
+        BASSERT(radius > 0.);
+        m_points.push_back(point(position, radius));
+    }
+    /**
+     * @brief getPoints returns the points added by addPoint()
+     */
+    const t_points& getPoints() const
+    {
+        return m_points;
+    }
+    /**
+     * @brief clear removes all points. Don't call while calculating voxel.
+     */
+    void clear()
+    {
+        m_points.clear();
+    }
+
+    /**
+     * @brief getAxisAlignedBoundingBox returns the transformed bounds of all segments.
+     * @param trans Transform.
+     */
+    blub::axisAlignedBox getAxisAlignedBoundingBox(const transform& trans) const override
+    {
+        blub::axisAlignedBox result;
+        for (uint32 indSegment = 0; indSegment < getNumSegments(); ++indSegment)
+        {
+            result.merge(getSegmentBoundingBox(indSegment, trans));
+        }
+        return result;
+    }
+
+    /**
+     * @brief intersectsTile returns true if the capsule of one segment touches the tile, see segmentIntersects().
+     * @param tileBounds The absolute voxel bounds of the tile.
+     * @param trans Transform.
+     */
+    bool intersectsTile(const blub::axisAlignedBox& tileBounds, const transform& trans) const override
+    {
+        for (uint32 indSegment = 0; indSegment < getNumSegments(); ++indSegment)
+        {
+            if (segmentIntersects(indSegment, tileBounds, trans))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief calculateVoxel evaluates the distance to all segments touching the tile.
+     * @param voxelContainer Must not be nullptr.
+     * @param voxelContainerOffset The tile-id of voxelContainer.
+     * @param trans Transform.
+     */
+    void calculateVoxel(t_voxelContainerTile* voxelContainer,
+                        const vector3int32& voxelContainerOffset,
+                        const transform &trans) const override
+    {
+        const int32 voxelLength(t_voxelContainerTile::voxelLength);
+        const vector3int32 posContainerAbsolut(voxelContainerOffset*voxelLength);
+        const blub::axisAlignedBox tileAabb(vector3(posContainerAbsolut), vector3(posContainerAbsolut + vector3int32(voxelLength-1)));
+
+        // only the segments touching the tile
+        vector<uint32> segments;
+        blub::axisAlignedBox aabb;
+        for (uint32 indSegment = 0; indSegment < getNumSegments(); ++indSegment)
+        {
+            if (segmentIntersects(indSegment, tileAabb, trans))
+            {
+                segments.push_back(indSegment);
+                aabb.merge(getSegmentBoundingBox(indSegment, trans));
+            }
+        }
+
+        vector3int32 voxelStart;
+        vector3int32 voxelEnd;
+        if (segments.empty() || !t_base::calculateVoxelRange(aabb, posContainerAbsolut, voxelStart, voxelEnd))
+        {
+            return;
+        }
+
+        const typename t_base::inverseTransform toEditSpace(trans);
+
+        for (int32 indX = voxelStart.x; indX < voxelEnd.x; ++indX)
+        {
+            for (int32 indY = voxelStart.y; indY < voxelEnd.y; ++indY)
+            {
+                for (int32 indZ = voxelStart.z; indZ < voxelEnd.z; ++indZ)
+                {
+                    const vector3int32 posVoxel(indX, indY, indZ);
+                    const vector3 posEdit(toEditSpace.transformPosition(vector3(posContainerAbsolut + posVoxel)));
+
+                    real distanceToSurface(-2.);
+                    for (const uint32& indSegment : segments)
+                    {
+                        distanceToSurface = math::max(distanceToSurface, calculateDistanceToSurface(indSegment, posEdit));
+                    }
+                    if (distanceToSurface <= -1.)
+                    {
+                        continue;
+                    }
+
+                    t_voxel voxelResult;
+                    voxelResult.setInterpolation(static_cast<int8>(math::clamp<real>(distanceToSurface*127., -127., 127.)));
+                    if (t_base::m_attributesOnly)
+                    {
+                        t_base::setVoxelAttributesOnly(voxelContainer, posVoxel, voxelResult);
+                    }
+                    else if (!t_base::m_cut)
+                    {
+                        voxelContainer->setVoxelIfInterpolationHigher(posVoxel, voxelResult);
+                    }
+                    else
+                    {
+                        voxelResult.getInterpolation() *= -1;
+                        voxelContainer->setVoxelIfInterpolationLower(posVoxel, voxelResult);
+                    }
+                }
+            }
+        }
+    }
+
+protected:
+    /**
+     * @brief stroke constructor. See create().
+     */
+    stroke()
+    {
+        ;
+    }
+
+    /**
+     * @brief getNumSegments returns the number of segments. A stroke with only one point has one segment.
+     */
+    uint32 getNumSegments() const
+    {
+        if (m_points.size() < 2)
+        {
+            return m_points.size();
+        }
+        return m_points.size() - 1;
+    }
+
+    /**
+     * @brief getSegmentBoundingBox returns the transformed bounds of one segment including the interpolation range of one voxel.
+     * @param indSegment Index of the segment.
+     * @param trans Transform.
+     */
+    blub::axisAlignedBox getSegmentBoundingBox(const uint32& indSegment, const transform& trans) const
+    {
+        const point& start(m_points[indSegment]);
+        const point& end(m_points[math::min<uint32>(indSegment+1, m_points.size()-1)]);
+
+        blub::axisAlignedBox result(start.position - vector3(start.radius + 1.), start.position + vector3(start.radius + 1.));
+        result.merge(blub::axisAlignedBox(end.position - vector3(end.radius + 1.), end.position + vector3(end.radius + 1.)));
+
+        return t_base::transformAxisAlignedBox(result, trans);
+    }
+
+    /**
+     * @brief segmentIntersects returns true if the capsule of one segment, grown by the interpolation range of one voxel, touches bounds.
+     * The capsule gets tested in absolute space. With a non-uniform scale its radius gets scaled by the largest axis, so the test stays conservative.
+     * @param indSegment Index of the segment.
+     * @param bounds Absolute bounds.
+     * @param trans Transform.
+     */
+    bool segmentIntersects(const uint32& indSegment, const blub::axisAlignedBox& bounds, const transform& trans) const
+    {
+        if (!getSegmentBoundingBox(indSegment, trans).intersects(bounds))
+        {
+            return false;
+        }
+
+        const point& start(m_points[indSegment]);
+        const point& end(m_points[math::min<uint32>(indSegment+1, m_points.size()-1)]);
+
+        const real scale(math::max(math::abs(trans.scale.x), math::max(math::abs(trans.scale.y), math::abs(trans.scale.z))));
+        const point startAbsolut(trans.rotation*(start.position*trans.scale) + trans.position, (start.radius + 1.)*scale);
+        const point endAbsolut(trans.rotation*(end.position*trans.scale) + trans.position, (end.radius + 1.)*scale);
+
+        // the distance to the box minus the radius is convex along the segment - ternary search its minimum
+        real lower(0.);
+        real upper(1.);
+        for (int32 iteration = 0; iteration < 32; ++iteration)
+        {
+            const real left(lower + (upper - lower)/3.);
+            const real right(upper - (upper - lower)/3.);
+            if (calculateDistanceToCapsule(startAbsolut, endAbsolut, left, bounds) < calculateDistanceToCapsule(startAbsolut, endAbsolut, right, bounds))
+            {
+                upper = right;
+            }
+            else
+            {
+                lower = left;
+            }
+        }
+        return calculateDistanceToCapsule(startAbsolut, endAbsolut, (lower + upper)*0.5, bounds) <= 0.;
+    }
+
+    /**
+     * @brief calculateDistanceToCapsule returns the distance from bounds to the surface of the sphere interpolated between start and end. Negative if they overlap.
+     * @param start Position and radius at along 0.
+     * @param end Position and radius at along 1.
+     * @param along 0 to 1.
+     * @param bounds The box.
+     */
+    static real calculateDistanceToCapsule(const point& start, const point& end, const real& along, const blub::axisAlignedBox& bounds)
+    {
+        const vector3 pos(start.position + (end.position - start.position)*along);
+        const real radius(start.radius + (end.radius - start.radius)*along);
+
+        vector3 outside(0.);
+        for (int32 indAxis = 0; indAxis < 3; ++indAxis)
+        {
+            outside[indAxis] = math::max<real>(math::max<real>(bounds.getMinimum()[indAxis] - pos[indAxis], pos[indAxis] - bounds.getMaximum()[indAxis]), 0.);
+        }
+        return outside.length() - radius;
+    }
+
+    /**
+     * @brief calculateDistanceToSurface returns the signed distance from pos to the surface of a segment. Positive inside.
+     * @param indSegment Index of the segment.
+     * @param pos Position in edit-space.
+     */
+    real calculateDistanceToSurface(const uint32& indSegment, const vector3& pos) const
+    {
+        const point& start(m_points[indSegment]);
+        const point& end(m_points[math::min<uint32>(indSegment+1, m_points.size()-1)]);
+
+        const vector3 segment(end.position - start.position);
+        const real squaredLength(segment.squaredLength());
+
+        real along(0.);
+        if (squaredLength > 0.)
+        {
+            along = math::clamp<real>((pos - start.position).dotProduct(segment) / squaredLength, 0., 1.);
+        }
+        const vector3 nearest(start.position + segment*along);
+        const real radius(start.radius + (end.radius - start.radius)*along);
+
+        return radius - pos.distance(nearest);
+    }
+
+protected:
+    t_points m_points;
+
+};
+
+
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_EDIT_STROKE_HPP
@@ -7,7 +7,9 @@
 #include "blub/core/hashMap.hpp"
 #include "blub/core/noncopyable.hpp"
 #include "blub/core/signal.hpp"
+#include "blub/core/vector.hpp"
 #include "blub/math/axisAlignedBoxInt32.hpp"
+#include "blub/math/math.hpp"
 #include "blub/math/vector3.hpp"
 #include "blub/procedural/log/global.hpp"
 #include "blub/procedural/voxel/simple/base.hpp"
@@ -16,6 +18,8 @@
 #include "blub/procedural/voxel/tile/accessor.hpp"
 #include "blub/procedural/voxel/tile/container.hpp"
 
+#include <algorithm>
+
 
 namespace blub
 {
@@ -48,9 +52,9 @@ public:
     typedef typename t_config::t_container::t_tile t_tileContainer;
     typedef sharedPointer<t_tileContainer> t_tileContainerPtr;
     typedef hashList<vector3int32> t_tileIdList;
+    typedef hashMap<t_tileId, axisAlignedBoxInt32> t_tileDirtyMap;
     typedef container::utils::tileState t_tileState;
     typedef container::utils::tile<t_tileContainer> t_tileHolder;
-    typedef hashMap<t_tileId, t_tileHolder> t_tileHolderMap;
 
     typedef typename t_config::t_container::t_simple t_simpleContainerVoxel;
 
@@ -139,7 +143,9 @@ protected:
             return;
         }*/
 
-        t_tileIdList affectedTiles;
+        const bool attributesOnly(m_voxels.getEditedAttributesOnly());
+
+        t_tileDirtyMap affectedTiles;
         for (auto change : changedTiles)
         {
             const t_tileId id(change.first);
@@ -159,6 +165,20 @@ protected:
             calculateAffectedAccessorTilesByContainerTile(id, workTile, affectedTiles);
         }
 
+        if (attributesOnly)
+        {
+            // the iso-surface didn't change - only accessor-tiles that already contain a surface have to get updated
+            t_tileDirtyMap existingTiles;
+            for (const typename t_tileDirtyMap::value_type& work : affectedTiles)
+            {
+                if (m_tiles.find(work.first) != m_tiles.cend())
+                {
+                    existingTiles.insert(work.first, work.second);
+                }
+            }
+            affectedTiles.swap(existingTiles);
+        }
+
         if (affectedTiles.empty())
         {
 //            blub::BWARNING("affectedTiles.empty()");
@@ -167,50 +187,141 @@ protected:
         }
 
         t_base::lockForEditMaster();
+        t_base::m_editedAttributesOnly = attributesOnly;
         BASSERT(m_numTilesInWork == 0);
         m_numTilesInWork = affectedTiles.size();
 
-        for (const t_tileId id : affectedTiles)
+        for (const typename t_tileDirtyMap::value_type& work : affectedTiles)
         {
-            t_base::m_worker.post(boost::bind(&accessor::calculateAccessorTS, this, id, getTile(id)));
+            t_base::postTileJobMaster(work.first, boost::bind(&accessor::calculateAccessorTS, this, work.first, getTile(work.first), work.second));
         }
     }
 
     /**
      * @brief calculateAccessorTS accesses the container and pulls out all voxel needed for surface calculation (marching-cubes/transvoxel).
+     * Only the voxel inside dirty get refreshed, except the tile is new.
      * @param id Accessor-TileId
-     * @param workTile The accessor-tile to fill with.
+     * @param workTile The accessor-tile to fill with. If nullptr a new one gets created.
+     * @param dirty Absolute voxel-bounds that changed in the container.
      */
-    void calculateAccessorTS(const t_tileId& id, t_tilePtr workTile)
+    void calculateAccessorTS(const t_tileId& id, t_tilePtr workTile, const axisAlignedBoxInt32& dirty)
     {
+        if (isUniform(id))
+        {
+            t_base::m_master.post(boost::bind(&accessor::afterCalculateAccessorMaster, this, id, nullptr, true));
+            return;
+        }
+
+        bool valuesChanged;
         if (workTile.isNull())
         {
             workTile = createTile();
             // workTile->setEmpty();
+            valuesChanged = gatherTile(id, workTile.data(), axisAlignedBoxInt32());
+        }
+        else
+        {
+            BASSERT(dirty.isValid());
+            valuesChanged = gatherTile(id, workTile.data(), dirty);
         }
 
-        const vector3int32 voxelStart(id*t_tile::voxelLength*m_voxelSkip);
-        // axisAlignedBoxInt32 lastUsedTileBounds;
-        t_tileHolderMap lastUsedTiles;
+        if (workTile->isEmpty() || workTile->isFull())
+        {
+            t_base::m_master.post(boost::bind(&accessor::afterCalculateAccessorMaster, this, id, nullptr, true));
+            return;
+        }
 
-        bool valuesChanged(false);
-        for (int32 indX = -1; indX < t_tile::voxelLength+2; ++indX)
+        t_base::m_master.post(boost::bind(&accessor::afterCalculateAccessorMaster, this, id, workTile, valuesChanged));
+    }
+
+    /**
+     * @brief isUniform checks by the container-tile-states only, if all container-tiles read by an accessor-tile are full or all are empty.
+     * Such an accessor-tile can't contain a surface, so no voxel have to get gathered.
+     * @param id Accessor-TileId
+     * @return False as soon as a partitial container-tile or two different states get found.
+     */
+    bool isUniform(const t_tileId& id) const
+    {
+        const int32 voxelLength(t_tile::voxelLength);
+        const vector3int32 voxelStart(id*voxelLength*m_voxelSkip);
+        const vector3int32 tileMin(neighbourhood::calculateTileId(voxelStart - vector3int32(m_voxelSkip)));
+        const vector3int32 tileMax(neighbourhood::calculateTileId(voxelStart + vector3int32((voxelLength+1)*m_voxelSkip)));
+
+        const t_tileState state(m_voxels.getTileHolder(tileMin).state);
+        if (state == t_tileState::partitial)
         {
-            for (int32 indY = -1; indY < t_tile::voxelLength+2; ++indY)
+            return false;
+        }
+        for (int32 indX = tileMin.x; indX <= tileMax.x; ++indX)
+        {
+            for (int32 indY = tileMin.y; indY <= tileMax.y; ++indY)
             {
-                for (int32 indZ = -1; indZ < t_tile::voxelLength+2; ++indZ)
+                for (int32 indZ = tileMin.z; indZ <= tileMax.z; ++indZ)
                 {
-                    const vector3int32 pos(indX, indY, indZ);
-                    const vector3int32 voxelPosAbs(voxelStart + pos*m_voxelSkip);
+                    if (m_voxels.getTileHolder(vector3int32(indX, indY, indZ)).state != state)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief gatherTile copies the voxel of the container inside dirty to workTile and sets its changed bounds.
+     * @param id Accessor-TileId
+     * @param workTile The accessor-tile to fill.
+     * @param dirty Absolute voxel-bounds to refresh. If invalid all voxel get refreshed.
+     * @return True if any voxel changed.
+     * @see tile::accessor::getChangedVoxelBoundingBox()
+     */
+    bool gatherTile(const t_tileId& id, t_tile* workTile, const axisAlignedBoxInt32& dirty) const
+    {
+        const int32 voxelLength(t_tile::voxelLength);
+        const vector3int32 voxelStart(id*voxelLength*m_voxelSkip);
+
+        vector3int32 voxelMin(voxelStart - vector3int32(m_voxelSkip));
+        vector3int32 voxelMax(voxelStart + vector3int32((voxelLength+1)*m_voxelSkip));
+        if (dirty.isValid())
+        {
+            voxelMin = voxelMin.getMaximum(dirty.getMinimum());
+            voxelMax = voxelMax.getMinimum(dirty.getMaximum());
+        }
+        BASSERT(voxelMin <= voxelMax);
+
+        const neighbourhood around(m_voxels, voxelMin, voxelMax);
+        axisAlignedBoxInt32 changed;
+
+        const vector3int32 posMin(ceilDivide(voxelMin - voxelStart, m_voxelSkip));
+        const vector3int32 posMax(floorDivide(voxelMax - voxelStart, m_voxelSkip));
+        const int32 rowLength(posMax.z - posMin.z + 1);
+        if (rowLength > 0)
+        {
+            t_voxel row[t_tile::voxelLengthWithNormalCorrection];
+            for (int32 indX = posMin.x; indX <= posMax.x; ++indX)
+            {
+                for (int32 indY = posMin.y; indY <= posMax.y; ++indY)
+                {
+                    const vector3int32 pos(indX, indY, posMin.z);
 
-                    valuesChanged |= workTile->setVoxel(pos, getVoxelData(voxelPosAbs, /*lastUsedTileBounds, */lastUsedTiles));
+                    gatherRow(around, voxelStart + pos*m_voxelSkip, rowLength, row);
+                    if (workTile->setVoxelRow(pos, row, rowLength))
+                    {
+                        changed.extend(pos);
+                        changed.extend(vector3int32(indX, indY, posMax.z));
+                    }
                 }
             }
         }
 
         if (workTile->getCalculateLod())
         {
-            BASSERT(m_voxelSkip > 0);
+            BASSERT(m_voxelSkip > 1);
+
+            const int32 voxelSkipLod(m_voxelSkip/2);
+            const vector3int32 posLodMin(ceilDivide(voxelMin - voxelStart, voxelSkipLod));
+            const vector3int32 posLodMax(floorDivide(voxelMax - voxelStart, voxelSkipLod) + vector3int32(1));
 
             const int32 voxelLengthLod = t_tile::voxelLengthLod;
             const vector3int32 toIterate[][2] = {
@@ -224,17 +335,20 @@ protected:
             for (int32 lod = 0; lod < 6; ++lod)
             {
                 const vector3int32& start(toIterate[lod][0]);
-                const vector3int32& end(toIterate[lod][1]);
-                for (int32 indX = start.x; indX < end.x; ++indX)
+                vector3int32 begin(start);
+                begin = begin.getMaximum(posLodMin);
+                vector3int32 end(toIterate[lod][1]);
+                end = end.getMinimum(posLodMax);
+                for (int32 indX = begin.x; indX < end.x; ++indX)
                 {
-                    for (int32 indY = start.y; indY < end.y; ++indY)
+                    for (int32 indY = begin.y; indY < end.y; ++indY)
                     {
-                        for (int32 indZ = start.z; indZ < end.z; ++indZ)
+                        for (int32 indZ = begin.z; indZ < end.z; ++indZ)
                         {
                             const vector3int32 pos(indX, indY, indZ);
-                            const vector3int32 voxelPosAbs(voxelStart + pos*(m_voxelSkip/2));
+                            const vector3int32 voxelPosAbs(voxelStart + pos*voxelSkipLod);
 
-                            const t_voxel result(getVoxelData(voxelPosAbs, /*lastUsedTileBounds, */lastUsedTiles));
+                            const t_voxel result(around.getVoxel(voxelPosAbs));
     #ifdef BLUB_DEBUG
                             if (indX % 2 == 0 &&
                                 indY % 2 == 0 &&
@@ -244,20 +358,19 @@ protected:
                             }
     #endif
 
-                            valuesChanged |= workTile->setVoxelLod(pos-start, result, lod);
+                            if (workTile->setVoxelLod(pos-start, result, lod))
+                            {
+                                changed.extend(pos / 2);
+                                changed.extend((pos + vector3int32(1)) / 2);
+                            }
                         }
                     }
                 }
             }
         }
+        workTile->setChangedVoxelBoundingBox(changed);
 
-        if (workTile->isEmpty() || workTile->isFull())
-        {
-            t_base::m_master.post(boost::bind(&accessor::afterCalculateAccessorMaster, this, id, nullptr, true));
-            return;
-        }
-
-        t_base::m_master.post(boost::bind(&accessor::afterCalculateAccessorMaster, this, id, workTile, valuesChanged));
+        return changed.isValid();
     }
 
     /**
@@ -309,60 +422,69 @@ protected:
 
 
     /**
-     * @brief When a tile in container gets changed it affects (because of normal-correction and lod) 3^3 accessor-tiles.
+     * @brief When a tile in container gets changed it affects (because of normal-correction and lod) up to 3^3 accessor-tiles.
+     * Extends the dirty voxel-bounds of every affected accessor-tile by the changed voxel of the container-tile.
      * @param conterainerId Container-Tile-Id
      * @param holder Container-Data
-     * @param resultingSurfaceTiles Resulting, up to 27, to recalculate tiles.
+     * @param resultingSurfaceTiles Resulting to recalculate tiles with their absolute dirty voxel-bounds.
      * Depending on how the change-axisAligendBox in the container-tile looks like.
      */
-    void calculateAffectedAccessorTilesByContainerTile(const t_tileId& conterainerId, const t_tileHolder &holder, t_tileIdList& resultingSurfaceTiles)
+    void calculateAffectedAccessorTilesByContainerTile(const t_tileId& conterainerId, const t_tileHolder &holder, t_tileDirtyMap& resultingSurfaceTiles)
     {
-        const vector3 forDiv(conterainerId);
-        const vector3int32 result((forDiv / (real)m_voxelSkip).getFloor());
-        resultingSurfaceTiles.insert(result);
+        const int32 voxelLength(t_tile::voxelLength);
 
-        vector3int32 minimum(0);
+        axisAlignedBoxInt32 changed(vector3int32(0), vector3int32(voxelLength-1));
         if (holder.state == t_tileState::partitial)
         {
             BASSERT(holder.data->getEditedVoxelBoundingBox().isValid());
-            minimum = holder.data->getEditedVoxelBoundingBox().getMinimum();
-        }
-        if (minimum > vector3int32(0))
-        {
-            return;
+            changed = holder.data->getEditedVoxelBoundingBox();
         }
+        const axisAlignedBoxInt32 dirty(conterainerId*voxelLength + changed.getMinimum(),
+                                        conterainerId*voxelLength + changed.getMaximum());
 
-        const vector3int32 resultMod(conterainerId%m_voxelSkip);
-        if (resultMod.x == 0 && minimum.x == 0)
-        {
-            resultingSurfaceTiles.insert(result - vector3int32(1, 0, 0));
-        }
-        if (resultMod.y == 0 && minimum.y == 0)
-        {
-            resultingSurfaceTiles.insert(result - vector3int32(0, 1, 0));
-        }
-        if (resultMod.z == 0 && minimum.z == 0)
-        {
-            resultingSurfaceTiles.insert(result - vector3int32(0, 0, 1));
-        }
-        if (resultMod.x == 0 && resultMod.y == 0 && minimum.x == 0 && minimum.y == 0)
-        {
-            resultingSurfaceTiles.insert(result - vector3int32(1, 1, 0));
-        }
-        if (resultMod.x == 0 && resultMod.z == 0 && minimum.x == 0 && minimum.z == 0)
-        {
-            resultingSurfaceTiles.insert(result - vector3int32(1, 0, 1));
-        }
-        if (resultMod.y == 0 && resultMod.z == 0 && minimum.y == 0 && minimum.z == 0)
-        {
-            resultingSurfaceTiles.insert(result - vector3int32(0, 1, 1));
-        }
-        if (resultMod.x == 0 && resultMod.y == 0 && resultMod.z == 0 && minimum == vector3int32(0))
+        // an accessor-tile reads the voxel from id*tileSize-m_voxelSkip to (id+1)*tileSize+m_voxelSkip
+        const int32 tileSize(voxelLength*m_voxelSkip);
+        const vector3int32 start(ceilDivide(dirty.getMinimum() - vector3int32(tileSize + m_voxelSkip), tileSize));
+        const vector3int32 end(floorDivide(dirty.getMaximum() + vector3int32(m_voxelSkip), tileSize));
+
+        for (int32 indX = start.x; indX <= end.x; ++indX)
         {
-            resultingSurfaceTiles.insert(result - vector3int32(1, 1, 1));
+            for (int32 indY = start.y; indY <= end.y; ++indY)
+            {
+                for (int32 indZ = start.z; indZ <= end.z; ++indZ)
+                {
+                    resultingSurfaceTiles[vector3int32(indX, indY, indZ)].extend(dirty);
+                }
+            }
         }
     }
 
+    /**
+     * @brief floorDivide divides every component and rounds towards negative infinity.
+     * @param value
+     * @param divisor Must be larger zero.
+     * @return
+     */
+    static vector3int32 floorDivide(const vector3int32& value, const int32& divisor)
+    {
+        return vector3int32(floorDivide(value.x, divisor), floorDivide(value.y, divisor), floorDivide(value.z, divisor));
+    }
+    static int32 floorDivide(const int32& value, const int32& divisor)
+    {
+        BASSERT(divisor > 0);
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+    /**
+     * @brief ceilDivide divides every component and rounds towards positive infinity.
+     * @param value
+     * @param divisor Must be larger zero.
+     * @return
+     */
+    static vector3int32 ceilDivide(const vector3int32& value, const int32& divisor)
+    {
+        return -floorDivide(-value, divisor);
+    }
+
     /**
      * @brief createTile creates an empty tile.
      * @return
@@ -375,26 +497,63 @@ protected:
     }
 
     /**
-     * @brief getVoxelData returns a voxel from a cahned container-tile or looks up the tile and returns it.
-     * @param voxelPosAbs Absolut voxel position.
-     * @param lastUsedTiles Last used container-tile.
-     * @return Always a valid voxel. If not found a default-constructed voxel.
+     * @brief The neighbourhood class holds all container-tiles an accessor-tile needs. Gets looked up once per accessor-tile,
+     * so the gather doesn't have to look up a tile per voxel.
      */
-    t_voxel getVoxelData(const vector3int32& voxelPosAbs, t_tileHolderMap& lastUsedTiles)
+    class neighbourhood
     {
-        const vector3int32 &tilePos(m_voxels.calculateVoxelPosToTileId(voxelPosAbs));
-        const vector3int32 &tilePosAbs(tilePos*vector3int32(t_tile::voxelLength));
+    public:
+        /**
+         * @brief neighbourhood looks up all container-tiles that contain voxel between voxelMin and voxelMax. Read-lock container before.
+         * @param voxels The container.
+         * @param voxelMin Absolute voxel-position.
+         * @param voxelMax Absolute voxel-position. Inclusive.
+         */
+        neighbourhood(const t_simpleContainerVoxel& voxels, const vector3int32& voxelMin, const vector3int32& voxelMax)
+            : m_tileStart(calculateTileId(voxelMin))
+            , m_numTiles(calculateTileId(voxelMax) - m_tileStart + vector3int32(1))
+            , m_tiles(m_numTiles.x*m_numTiles.y*m_numTiles.z)
+        {
+            for (int32 indX = 0; indX < m_numTiles.x; ++indX)
+            {
+                for (int32 indY = 0; indY < m_numTiles.y; ++indY)
+                {
+                    for (int32 indZ = 0; indZ < m_numTiles.z; ++indZ)
+                    {
+                        m_tiles[(indX*m_numTiles.y + indY)*m_numTiles.z + indZ] = voxels.getTileHolder(m_tileStart + vector3int32(indX, indY, indZ));
+                    }
+                }
+            }
+        }
 
-        typename t_tileHolderMap::const_iterator it = lastUsedTiles.find(tilePos);
+        /**
+         * @brief getTile returns a container-tile.
+         * @param id Absolute container-TileId. Must be inside the neighbourhood.
+         * @return
+         */
+        const t_tileHolder& getTile(const vector3int32& id) const
+        {
+            const vector3int32 pos(id - m_tileStart);
+            BASSERT(pos >= vector3int32(0));
+            BASSERT(pos < m_numTiles);
+            return m_tiles[(pos.x*m_numTiles.y + pos.y)*m_numTiles.z + pos.z];
+        }
 
-        t_voxel result;
-        if (it != lastUsedTiles.cend())
+        /**
+         * @brief getVoxel returns a voxel.
+         * @param voxelPosAbs Absolute voxel-position. Must be inside the neighbourhood.
+         * @return
+         */
+        t_voxel getVoxel(const vector3int32& voxelPosAbs) const
         {
-            const t_tileHolder &lastUsedTile(it->second);
-            switch(lastUsedTile.state)
+            const vector3int32 tileId(calculateTileId(voxelPosAbs));
+            const t_tileHolder& holder(getTile(tileId));
+
+            t_voxel result;
+            switch(holder.state)
             {
             case t_tileState::partitial:
-                result = lastUsedTile.data->getVoxel(voxelPosAbs-tilePosAbs);
+                result = holder.data->getVoxel(voxelPosAbs - tileId*t_tileContainer::voxelLength);
                 break;
             case t_tileState::empty:
                 result.setMin();
@@ -408,26 +567,78 @@ protected:
             return result;
         }
 
-        // get new tile
-        const t_tileHolder &lastUsedTile(m_voxels.getTileHolder(tilePos));
-        lastUsedTiles.insert(tilePos, lastUsedTile);
+        /**
+         * @brief calculateTileId converts an absolute voxel-coordinate to a container-TileId. Same like container::base::calculateVoxelPosToTileId() but without floating point.
+         * @param voxelPosAbs
+         * @return
+         */
+        static vector3int32 calculateTileId(const vector3int32& voxelPosAbs)
+        {
+            return accessor::floorDivide(voxelPosAbs, t_tileContainer::voxelLength);
+        }
+
+    protected:
+        const vector3int32 m_tileStart;
+        const vector3int32 m_numTiles;
+        vector<t_tileHolder> m_tiles;
+    };
 
-        // repeat step ahead
-        switch(lastUsedTile.state)
+    /**
+     * @brief gatherRow copies rowLength voxel along the z-axis, every m_voxelSkip voxel, into row.
+     * Copies per container-tile a whole part of the row. Full and empty container-tiles get filled without access.
+     * @param around The looked up container-tiles.
+     * @param voxelStart Absolute voxel-position of the first voxel.
+     * @param rowLength Number of voxel to copy.
+     * @param row Result.
+     */
+    void gatherRow(const neighbourhood& around, const vector3int32& voxelStart, const int32& rowLength, t_voxel* row) const
+    {
+        const int32 voxelLength(t_tileContainer::voxelLength);
+
+        t_voxel voxelMin;
+        voxelMin.setMin();
+        t_voxel voxelMax;
+        voxelMax.setMax();
+
+        int32 indRow(0);
+        while (indRow < rowLength)
         {
-        case t_tileState::partitial:
-            result = lastUsedTile.data->getVoxel(voxelPosAbs-tilePosAbs);
-            break;
-        case t_tileState::empty:
-            result.setMin();
-            break;
-        case t_tileState::full:
-            result.setMax();
-            break;
-        default:
-            BASSERT(false);
+            const vector3int32 voxelPosAbs(voxelStart.x, voxelStart.y, voxelStart.z + indRow*m_voxelSkip);
+            const vector3int32 tileId(neighbourhood::calculateTileId(voxelPosAbs));
+            const vector3int32 voxelPosInTile(voxelPosAbs - tileId*voxelLength);
+            const int32 count(math::min<int32>((voxelLength - 1 - voxelPosInTile.z) / m_voxelSkip + 1, rowLength - indRow));
+
+            t_voxel* dest(row + indRow);
+            const t_tileHolder& holder(around.getTile(tileId));
+            switch(holder.state)
+            {
+            case t_tileState::partitial:
+            {
+                const t_voxel* source(&holder.data->getVoxelArray()[t_tileContainer::calculateIndex(voxelPosInTile)]);
+                if (m_voxelSkip == 1)
+                {
+                    std::copy(source, source + count, dest);
+                }
+                else
+                {
+                    for (int32 ind = 0; ind < count; ++ind)
+                    {
+                        dest[ind] = source[ind*m_voxelSkip];
+                    }
+                }
+                break;
+            }
+            case t_tileState::empty:
+                std::fill(dest, dest + count, voxelMin);
+                break;
+            case t_tileState::full:
+                std::fill(dest, dest + count, voxelMax);
+                break;
+            default:
+                BASSERT(false);
+            }
+            indRow += count;
         }
-        return result;
     }
 
 protected:
@@ -45,6 +45,7 @@ public:
     typedef hashMap<t_tileId, t_tilePtr> t_tilesGotChangedMap;
 
     typedef std::function<t_tilePtr ()> t_createTileCallback;
+    typedef std::function<real (const t_tileId& id)> t_tilePriorityCallback;
 
     /**
      * @brief base constructor
@@ -83,6 +84,12 @@ public:
      * @return
      */
     const t_tilesGotChangedMap &getTilesThatGotEdited() const;
+    /**
+     * @brief getEditedAttributesOnly returns true if the tiles returned by getTilesThatGotEdited() only changed their voxel-attributes, but not the interpolation.
+     * In that case the iso-surface stays the same and only vertex-attributes have to get updated.
+     * @return Valid until the next lockForEdit() / lockForEditMaster()
+     */
+    const bool &getEditedAttributesOnly() const;
 
     /**
      * @brief setCreateTileCallback sets a callback for creating tiles.
@@ -91,6 +98,14 @@ public:
      */
     void setCreateTileCallback(const t_createTileCallback &callback);
 
+    /**
+     * @brief setTilePriorityCallback sets a callback that calculates the priority of the worker-jobs of a tile. Jobs with a higher priority get calculated first.
+     * Use it to calculate tiles near the camera before far away ones. Set it before the first edit.
+     * @param callback Gets called by the master. Must be threadsafe. If empty jobs get calculated in order of posting.
+     * @see cameraPriority
+     */
+    void setTilePriorityCallback(const t_tilePriorityCallback &callback);
+
     /**
      * @brief getMaster returns the master dispatcher.
      * The master synchronises jobs for the worker-thread and writes to class member.
@@ -135,6 +150,13 @@ protected:
      */
     virtual t_tilePtr createTile() const;
 
+    /**
+     * @brief postTileJobMaster posts a job for a tile to the worker. Uses the priority of setTilePriorityCallback(). Call by master dispatcher.
+     * @param id TileId
+     * @param job
+     */
+    void postTileJobMaster(const t_tileId& id, const async::dispatcher::t_toCallFunction& job);
+
 protected:
     /**
      * @brief m_master The master synchronises jobs for the worker-thread and writes to class member.
@@ -148,8 +170,14 @@ protected:
     blub::async::dispatcher &m_worker;
 
     t_tilesGotChangedMap m_tilesThatGotEdited;
+    /**
+     * @brief m_editedAttributesOnly gets set to false by lockForEditMaster(). Derived classes set it to true if the change only affects attributes.
+     * @see getEditedAttributesOnly()
+     */
+    bool m_editedAttributesOnly;
 
     t_createTileCallback m_createTileCallback;
+    t_tilePriorityCallback m_tilePriorityCallback;
 
     async::mutexReadWrite m_classLocker;
 
@@ -160,6 +188,7 @@ template <class tileType>
 base<tileType>::base(async::dispatcher &worker)
     : m_master(worker)
     , m_worker(worker)
+    , m_editedAttributesOnly(false)
 //    , m_createTileCallback(blub::bind(&t_tile::create)) // TODO good idea, techn difficult, via config
 {
     ;
@@ -200,12 +229,24 @@ const typename base<tileType>::t_tilesGotChangedMap &base<tileType>::getTilesTha
     return m_tilesThatGotEdited;
 }
 
+template <class tileType>
+const bool &base<tileType>::getEditedAttributesOnly() const
+{
+    return m_editedAttributesOnly;
+}
+
 template <class tileType>
 void base<tileType>::setCreateTileCallback(const t_createTileCallback &callback)
 {
     m_createTileCallback = callback;
 }
 
+template <class tileType>
+void base<tileType>::setTilePriorityCallback(const t_tilePriorityCallback &callback)
+{
+    m_tilePriorityCallback = callback;
+}
+
 template <class tileType>
 void base<tileType>::addToChangeList(const t_tileId &id, t_tilePtr toAdd)
 {
@@ -220,6 +261,7 @@ bool base<tileType>::tryLockForEditMaster()
     if (result)
     {
         m_tilesThatGotEdited.clear();
+        m_editedAttributesOnly = false;
     }
     return result;
 }
@@ -230,6 +272,7 @@ void base<tileType>::lockForEditMaster()
     m_classLocker.lockForWrite();
 
     m_tilesThatGotEdited.clear();
+    m_editedAttributesOnly = false;
 }
 
 template <class tileType>
@@ -251,6 +294,19 @@ typename base<tileType>::t_tilePtr base<tileType>::createTile() const
     return m_createTileCallback();
 }
 
+template <class tileType>
+void base<tileType>::postTileJobMaster(const t_tileId &id, const async::dispatcher::t_toCallFunction &job)
+{
+    if (m_tilePriorityCallback)
+    {
+        m_worker.post(job, m_tilePriorityCallback(id));
+    }
+    else
+    {
+        m_worker.post(job);
+    }
+}
+
 template <class tileType>
 blub::async::strand &base<tileType>::getMaster()
 {
@@ -6,6 +6,7 @@
 #include "blub/math/axisAlignedBoxInt32.hpp"
 #include "blub/math/transform.hpp"
 #include "blub/procedural/voxel/simple/base.hpp"
+#include "blub/procedural/voxel/simple/container/utils/prefab.hpp"
 #include "blub/procedural/voxel/simple/container/utils/tile.hpp"
 
 
@@ -42,6 +43,9 @@ public:
     typedef typename t_base::t_tileId t_tileId;
 
     typedef hashMap<t_tileId, t_utilsTile> t_tilesGotChangedMap;
+    typedef hashMap<t_tileId, t_utilsTile> t_tileMap;
+    typedef utils::prefab<t_config> t_prefab;
+    typedef typename t_prefab::pointer t_prefabPtr;
 
     /**
      * @brief base constructor.
@@ -89,6 +93,18 @@ public:
         t_base::m_master.post(boost::bind(&base::setTileMaster, this, id, toSet));
     }
 
+    /**
+     * @brief setTiles replaces several tiles at once and signals the change once. Use it for imports of whole volumes. Method is threadsafe. Do NOT lock class before.
+     * The tiles replace the old ones completely, so every voxel of a partitial tile counts as changed.
+     * If an edit is in calculation the tiles get set after it, before the next edit starts.
+     * @param toSet Tiles to set. Partitial tiles get owned by the container.
+     * @see setTile()
+     */
+    void setTiles(const t_tileMap& toSet)
+    {
+        t_base::m_master.post(boost::bind(&base::setTilesMaster, this, toSet));
+    }
+
     /**
      * @brief getTileHolder returns a utils::tileHolder setted by setTile() or by editVoxel(). Read-lock class before call.
      * Read-lock the class before.
@@ -162,6 +178,84 @@ public:
         return result;
     }
 
+    /**
+     * @brief createPrefab copies a voxel-region into a utils::prefab. Stamp it with edit::prefab. Read-lock the class before call.
+     * If voxelStart is a multiple of voxelsPerTile the tiles completely inside the region get copied as whole arrays, full and empty tiles only by state.
+     * Else and for the last tiles of the region the voxel get copied one by one.
+     * @param voxelStart An absolute voxel-coordinate. First voxel of the region.
+     * @param voxelSize Number of voxel per axis. Must be larger zero.
+     * @return never nullptr.
+     */
+    t_prefabPtr createPrefab(const vector3int32& voxelStart, const vector3int32& voxelSize) const
+    {
+        t_prefabPtr result(t_prefab::create(voxelSize));
+
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const bool aligned(calculateVoxelPosInTile(voxelStart) == vector3int32(0));
+        const vector3int32& numTiles(result->getNumTiles());
+
+        for (int32 indX = 0; indX < numTiles.x; ++indX)
+        {
+            for (int32 indY = 0; indY < numTiles.y; ++indY)
+            {
+                for (int32 indZ = 0; indZ < numTiles.z; ++indZ)
+                {
+                    const vector3int32 id(indX, indY, indZ);
+                    const vector3int32 tileStart(voxelStart + id*voxelsPerTile);
+
+                    // the last tiles get copied voxel by voxel, so the voxel outside voxelSize stay minimum
+                    if (aligned && (id + vector3int32(1))*voxelsPerTile <= voxelSize)
+                    {
+                        const t_utilsTile holder(getTileHolderByVoxelPosition(tileStart));
+                        if (holder.state != utils::tileState::partitial)
+                        {
+                            result->setTile(id, holder);
+                            continue;
+                        }
+                        t_utilsTile copy(utils::tileState::partitial);
+                        copy.data = t_tile::create();
+                        *copy.data = *holder.data;
+                        result->setTile(id, copy);
+                        continue;
+                    }
+
+                    t_tilePtr copy(t_tile::create());
+                    copy->startEdit();
+                    const vector3int32 voxelEnd(vector3int32(voxelsPerTile).getMinimum(voxelSize - id*voxelsPerTile));
+                    for (int32 voxelX = 0; voxelX < voxelEnd.x; ++voxelX)
+                    {
+                        for (int32 voxelY = 0; voxelY < voxelEnd.y; ++voxelY)
+                        {
+                            for (int32 voxelZ = 0; voxelZ < voxelEnd.z; ++voxelZ)
+                            {
+                                const vector3int32 posVoxel(voxelX, voxelY, voxelZ);
+                                copy->setVoxel(posVoxel, getVoxel(tileStart + posVoxel));
+                            }
+                        }
+                    }
+                    copy->endEdit();
+
+                    t_utilsTile holder(utils::tileState::partitial);
+                    if (copy->isEmpty())
+                    {
+                        holder.state = utils::tileState::empty;
+                    }
+                    else if (copy->isFull())
+                    {
+                        holder.state = utils::tileState::full;
+                    }
+                    else
+                    {
+                        holder.data = copy;
+                    }
+                    result->setTile(id, holder);
+                }
+            }
+        }
+
+        return result;
+    }
+
     const t_tilesGotChangedMap &getTilesThatGotEdited() const
     {
         return m_tilesThatGotEdited;
@@ -264,18 +358,26 @@ protected:
             return;
         }
 
-        if (!alreadyLocked)
-        {
-            lockForEditMaster();
-        }
-
         BASSERT(m_numInTilesInTask == 0);
 
         editTodo edit(*m_editsTodo.begin());
         m_editsTodo.erase(m_editsTodo.begin());
         t_editConstPtr change(edit.edit_);
 
+        if (!alreadyLocked)
+        {
+            lockForEditMaster();
+            t_base::m_editedAttributesOnly = change->getAttributesOnly();
+        }
+        else
+        {
+            t_base::m_editedAttributesOnly &= change->getAttributesOnly();
+        }
+
         const blub::transform trans(edit.trans);
+        m_editInCalculation = change;
+        change->prepareCalculateVoxelMaster(*this, trans);
+
         const blub::axisAlignedBox aabb(change->getAxisAlignedBoundingBox(trans));
         const blub::axisAlignedBoxInt32 aabbScaled(aabb.getMinimum(), aabb.getMaximum());
         blub::vector3int32 startEdit;
@@ -290,13 +392,41 @@ protected:
                 for (blub::int32 indZ = startEdit.z; indZ < endEdit.z; ++indZ)
                 {
                     const blub::vector3int32 id(indX, indY, indZ);
+                    const blub::vector3int32 tileStart(id*t_config::voxelsPerTile);
+                    const blub::axisAlignedBox tileBounds(blub::vector3(tileStart), blub::vector3(tileStart + blub::vector3int32(t_config::voxelsPerTile-1)));
+                    if (!change->intersectsTile(tileBounds, trans))
+                    {
+                        continue;
+                    }
                     const t_utilsTile workTile(getTileHolder(id));
+                    if (change->getAttributesOnly() && workTile.state != utils::tileState::partitial)
+                    {
+                        continue; // full and empty tiles can't save attributes
+                    }
+                    // an attribute-only edit must not replace the geometry of the tile
+                    switch (change->getAttributesOnly() ? utils::tileState::partitial : change->calculateTileState(tileBounds, trans))
+                    {
+                    case utils::tileState::full:
+                        setTileToFullMaster(id);
+                        continue;
+                    case utils::tileState::empty:
+                        setTileToEmtpyMaster(id);
+                        continue;
+                    default:
+                        break;
+                    }
+
+                    const bool editedBefore(m_tilesThatGotEdited.find(id) != m_tilesThatGotEdited.cend());
 
                     ++m_numInTilesInTask;
-                    t_base::m_worker.post(boost::bind(&base::editVoxelWorker, this, change, workTile, id, trans));
+                    t_base::postTileJobMaster(id, boost::bind(&base::editVoxelWorker, this, change, workTile, id, trans, editedBefore));
                 }
             }
         }
+        if (m_numInTilesInTask == 0)
+        {
+            allTilesEditedMaster();
+        }
     }
 
     /**
@@ -306,8 +436,9 @@ protected:
      * @param holder The tile which gets affected.
      * @param id TileId.
      * @param trans Transform.
+     * @param editedBefore True if the tile already changed since the class got locked.
      */
-    void editVoxelWorker(t_editConstPtr change, const t_utilsTile &holder, const blub::vector3int32& id, const blub::transform& trans)
+    void editVoxelWorker(t_editConstPtr change, const t_utilsTile &holder, const blub::vector3int32& id, const blub::transform& trans, const bool& editedBefore)
     {
     #ifdef BLUB_LOG_VOXEL
         blub::BOUT("base::editVoxelTS id:" + blub::string::number(id));
@@ -325,6 +456,11 @@ protected:
         if (!workTile->getEditing())
         {
             workTile->startEdit();
+            if (editedBefore && holder.state != utils::tileState::partitial)
+            {
+                // the tile got full or empty by a previous edit, the edited bounds of that edit got lost
+                workTile->extendEditedVoxelBoundingBoxToTile();
+            }
         }
         change->calculateVoxel(workTile.data(), id, trans);
 
@@ -360,23 +496,96 @@ protected:
         --m_numInTilesInTask;
         if (m_numInTilesInTask == 0)
         {
-            if (m_editsTodo.isEmpty())
+            allTilesEditedMaster();
+        }
+    }
+
+    /**
+     * @brief allTilesEditedMaster gets called after all tiles of an edit got applied. Starts the next edit or unlocks the class.
+     */
+    void allTilesEditedMaster()
+    {
+        BASSERT(m_numInTilesInTask == 0);
+
+        m_editInCalculation->finishCalculateVoxelMaster();
+        m_editInCalculation.reset();
+
+        if (!m_tilesTodo.empty())
+        {
+            // tiles delivered by setTiles() while the edit was in calculation
+            for (const typename t_tileMap::value_type& work : m_tilesTodo)
             {
-                // unlock all tiles
-                for (const typename t_tilesGotChangedMap::value_type& work : getTilesThatGotEdited())
+                setTileReplacingMaster(work.first, work.second);
+            }
+            m_tilesTodo.clear();
+            t_base::m_editedAttributesOnly = false;
+        }
+
+        if (m_editsTodo.isEmpty())
+        {
+            // unlock all tiles
+            for (const typename t_tilesGotChangedMap::value_type& work : getTilesThatGotEdited())
+            {
+                if (!work.second.data.isNull())
                 {
-                    if (!work.second.data.isNull())
-                    {
-                        work.second.data->endEdit();
-                    }
+                    work.second.data->endEdit();
                 }
-                unlockForEditMaster();
             }
-            else
+            unlockForEditMaster();
+        }
+        else
+        {
+            doNextEditMaster(true);
+        }
+    }
+
+    /**
+     * @brief setTilesMaster gets called by setTiles(). Call only by one thread at a time.
+     * Locks the class itself, or delays the tiles if an edit is in calculation.
+     * @param toSet
+     * @see setTiles()
+     */
+    void setTilesMaster(const t_tileMap& toSet)
+    {
+        if (!m_editInCalculation.isNull())
+        {
+            for (const typename t_tileMap::value_type& work : toSet)
+            {
+                m_tilesTodo.insert(work.first, work.second);
+            }
+            return;
+        }
+        lockForEditMaster();
+        for (const typename t_tileMap::value_type& work : toSet)
+        {
+            setTileReplacingMaster(work.first, work.second);
+        }
+        for (const typename t_tilesGotChangedMap::value_type& work : getTilesThatGotEdited())
+        {
+            if (!work.second.data.isNull())
+            {
+                work.second.data->endEdit();
+            }
+        }
+        unlockForEditMaster();
+    }
+
+    /**
+     * @brief setTileReplacingMaster sets a tile that replaces the old one completely. Call only by one thread at a time. Write-lock class before.
+     * @param id TileId
+     * @param toSet If partitial the edited voxel bounds get extended to the whole tile.
+     */
+    void setTileReplacingMaster(const t_tileId& id, const t_utilsTile& toSet)
+    {
+        if (toSet.state == utils::tileState::partitial)
+        {
+            if (!toSet.data->getEditing())
             {
-                doNextEditMaster(true);
+                toSet.data->startEdit();
             }
+            toSet.data->extendEditedVoxelBoundingBoxToTile();
         }
+        setTileMaster(id, toSet);
     }
 
     /**
@@ -458,6 +667,8 @@ protected:
 
     typedef list<editTodo> t_editTodoList;
     t_editTodoList m_editsTodo;
+    t_editConstPtr m_editInCalculation;
+    t_tileMap m_tilesTodo;
 
     // overwrite/reimpl stuff from t_base - because no usage of sharedPointer<>
     t_tilesGotChangedMap m_tilesThatGotEdited;
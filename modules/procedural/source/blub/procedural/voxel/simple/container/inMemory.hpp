@@ -236,11 +236,11 @@ protected:
 
                     if (holder.state == utils::tileState::partitial)
                     {
-                        holder.data = t_base::createTile();
+                        holder.data = t_base::createTileFull(false);
                         readWrite & serialization::nameValuePair::create("tile", *holder.data.data());
                     }
 
-                    setTile(id, holder);
+                    t_base::setTile(id, holder);
                 }
             }
         }
@@ -0,0 +1,145 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_SIMPLE_CONTAINER_UTILS_PREFAB_HPP
+#define BLUB_PROCEDURAL_VOXEL_SIMPLE_CONTAINER_UTILS_PREFAB_HPP
+
+#include "blub/core/globals.hpp"
+#include "blub/core/sharedPointer.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/predecl.hpp"
+#include "blub/procedural/voxel/simple/container/utils/tile.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace simple
+{
+namespace container
+{
+namespace utils
+{
+
+
+/**
+ * @brief The prefab class holds a copy of a voxel-region. Create it by simple::container::base::createPrefab() and stamp it by edit::prefab.
+ * The region gets split into tiles of voxelsPerTile^3 voxel beginning at the region-start. Tiles that are full or empty only save their state.
+ * The voxel of the last tiles outside getSize() are minimum.
+ */
+template <class configType>
+class prefab
+{
+public:
+    typedef configType t_config;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_config::t_container::t_tile t_tile;
+    typedef sharedPointer<t_tile> t_tilePtr;
+    typedef tile<t_tile> t_utilsTile;
+    typedef sharedPointer<prefab> pointer;
+    typedef sharedPointer<prefab const> constPointer;
+
+    /**
+     * @brief create creates an empty prefab.
+     * @param size Number of voxel per axis. Must be larger zero.
+     * @return never nullptr.
+     */
+    static pointer create(const vector3int32& size)
+    {
+        return pointer(new prefab(size));
+    }
+
+    /**
+     * @brief getSize returns the number of voxel per axis.
+     */
+    const vector3int32& getSize() const
+    {
+        return m_size;
+    }
+    /**
+     * @brief getNumTiles returns the number of tiles per axis.
+     */
+    const vector3int32& getNumTiles() const
+    {
+        return m_numTiles;
+    }
+
+    /**
+     * @brief getTile returns a tile.
+     * @param id 0 <= id < getNumTiles()
+     */
+    const t_utilsTile& getTile(const vector3int32& id) const
+    {
+        return m_tiles[calculateIndex(id)];
+    }
+    /**
+     * @brief setTile sets a tile. Don't call it while the prefab gets stamped. A partitial tile must not be shared with a container.
+     * @param id 0 <= id < getNumTiles()
+     * @param toSet The tile.
+     */
+    void setTile(const vector3int32& id, const t_utilsTile& toSet)
+    {
+        BASSERT(toSet.state != tileState::partitial || !toSet.data.isNull());
+        m_tiles[calculateIndex(id)] = toSet;
+    }
+
+    /**
+     * @brief getVoxel returns a voxel.
+     * @param pos 0 <= pos < getNumTiles()*voxelsPerTile
+     */
+    t_voxel getVoxel(const vector3int32& pos) const
+    {
+        const t_utilsTile& holder(getTile(pos / t_config::voxelsPerTile));
+
+        t_voxel result;
+        if (holder.state == tileState::full)
+        {
+            result.setMax();
+            return result;
+        }
+        if (holder.state == tileState::empty)
+        {
+            result.setMin();
+            return result;
+        }
+        return holder.data->getVoxel(pos % t_config::voxelsPerTile);
+    }
+
+protected:
+    /**
+     * @brief prefab constructor. See create()
+     */
+    prefab(const vector3int32& size)
+        : m_size(size)
+        , m_numTiles((size + vector3int32(t_config::voxelsPerTile - 1)) / t_config::voxelsPerTile)
+    {
+        BASSERT(size > vector3int32(0));
+        m_tiles.resize(m_numTiles.x*m_numTiles.y*m_numTiles.z);
+    }
+
+    int32 calculateIndex(const vector3int32& id) const
+    {
+        BASSERT(id >= vector3int32(0));
+        BASSERT(id < m_numTiles);
+        return id.x*m_numTiles.y*m_numTiles.z + id.y*m_numTiles.z + id.z;
+    }
+
+private:
+    const vector3int32 m_size;
+    const vector3int32 m_numTiles;
+
+    vector<t_utilsTile> m_tiles;
+
+};
+
+
+}
+}
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_SIMPLE_CONTAINER_UTILS_PREFAB_HPP
@@ -0,0 +1,447 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_SIMPLE_CONTAINER_UTILS_RAWIMPORTER_HPP
+#define BLUB_PROCEDURAL_VOXEL_SIMPLE_CONTAINER_UTILS_RAWIMPORTER_HPP
+
+#include "blub/async/dispatcher.hpp"
+#include "blub/async/strand.hpp"
+#include "blub/core/bind.hpp"
+#include "blub/core/globals.hpp"
+#include "blub/core/hashMap.hpp"
+#include "blub/core/sharedPointer.hpp"
+#include "blub/core/signal.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/predecl.hpp"
+#include "blub/procedural/voxel/simple/container/base.hpp"
+#include "blub/procedural/voxel/simple/container/utils/tile.hpp"
+
+#include <istream>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace simple
+{
+namespace container
+{
+namespace utils
+{
+
+
+/**
+ * @brief The rawImporter class streams a raw voxel-grid (8-bit, 16-bit or float samples) into a container.
+ * The grid gets read slab by slab. A slab is voxelsPerTile z-slices. The tiles of a slab get build parallel by the worker
+ * and get installed by simple::container::base::setTiles(). Tiles in which all voxel are min or max only save their state.
+ * Not more than getMaxSlabsInMemory() slabs are in memory at the same time, regardless of the volume size.
+ * The raw layout is x fastest, then y, then z. Samples are in native byte order.
+ */
+template <class configType>
+class rawImporter : public noncopyable
+{
+public:
+    typedef configType t_config;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_config::t_container::t_tile t_tile;
+    typedef sharedPointer<t_tile> t_tilePtr;
+    typedef tile<t_tile> t_utilsTile;
+    typedef simple::container::base<t_config> t_container;
+    typedef typename t_container::t_tileId t_tileId;
+    typedef typename t_container::t_tileMap t_tileMap;
+
+    typedef sharedPointer<std::istream> t_streamPtr;
+    typedef sharedPointer<vector<int8> > t_slabPtr;
+
+    typedef blub::signal<void (bool)> t_sigImportDone;
+
+    /**
+     * @brief The sampleType enum describes the format of a sample in the raw grid.
+     */
+    enum class sampleType
+    {
+        uint8,
+        uint16,
+        float32
+    };
+
+    /**
+     * @brief rawImporter constructor.
+     * @param worker Builds the tiles. May gets run by several threads.
+     * @param container The container the tiles get set to. Must live longer than the import.
+     */
+    rawImporter(async::dispatcher& worker, t_container& container)
+        : m_worker(worker)
+        , m_master(worker)
+        , m_container(container)
+        , m_maxSlabsInMemory(2)
+        , m_importing(false)
+    {
+        ;
+    }
+
+    /**
+     * @brief import starts streaming the grid into the container. Returns immediately. signalImportDone() gets called when done.
+     * A sample larger isoLevel is solid. The interpolation reaches its maximum at isoLevel+range. Use a negative range to invert the volume.
+     * Voxel of the last tiles outside the grid are minimum. Don't start an import while another one is running.
+     * @param input Read sequentially from its current position. Must stay valid until the import is done.
+     * @param size Number of samples per axis. Must be larger zero.
+     * @param type Format of a sample.
+     * @param isoLevel Sample-value of the surface.
+     * @param range Sample-distance to isoLevel that gets quantized to the interpolation minimum/maximum. Must not be zero.
+     * @param voxelOffset Absolute voxel-position of the first sample. Must be a multiple of voxelsPerTile.
+     */
+    void import(t_streamPtr input,
+                const vector3int32& size,
+                const sampleType& type,
+                const real& isoLevel,
+                const real& range,
+                const vector3int32& voxelOffset = vector3int32(0))
+    {
+        BASSERT(!input.isNull());
+        BASSERT(size > vector3int32(0));
+        BASSERT(range != 0.);
+        BASSERT(t_container::calculateVoxelPosInTile(voxelOffset) == vector3int32(0));
+
+        m_master.post(boost::bind(&rawImporter::importMaster, this, input, size, type, isoLevel, range, voxelOffset));
+    }
+
+    /**
+     * @brief setMaxSlabsInMemory sets how many slabs get read ahead. Bounds the memory usage. Default is 2.
+     * @param toSet Must be larger zero.
+     */
+    void setMaxSlabsInMemory(const int32& toSet)
+    {
+        BASSERT(toSet > 0);
+        m_maxSlabsInMemory = toSet;
+    }
+    /**
+     * @brief getMaxSlabsInMemory
+     * @return
+     * @see setMaxSlabsInMemory()
+     */
+    const int32& getMaxSlabsInMemory() const
+    {
+        return m_maxSlabsInMemory;
+    }
+
+    /**
+     * @brief signalImportDone gets called after all tiles got passed to the container. Parameter is false if reading the stream failed.
+     * @return
+     */
+    t_sigImportDone* signalImportDone()
+    {
+        return &m_sigImportDone;
+    }
+
+protected:
+    /**
+     * @brief The slab struct collects the built tiles of a slab until all of them are done.
+     */
+    struct slab
+    {
+        slab()
+            : numTilesLeft(0)
+        {
+            ;
+        }
+
+        int32 numTilesLeft;
+        t_tileMap tiles;
+    };
+    typedef hashMap<int32, slab> t_slabMap;
+
+    void importMaster(t_streamPtr input,
+                      const vector3int32& size,
+                      const sampleType& type,
+                      const real& isoLevel,
+                      const real& range,
+                      const vector3int32& voxelOffset)
+    {
+        BASSERT(!m_importing);
+
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+
+        m_importing = true;
+        m_success = true;
+        m_input = input;
+        m_size = size;
+        m_sampleType = type;
+        m_isoLevel = isoLevel;
+        m_range = range;
+        m_tileOffset = voxelOffset / voxelsPerTile;
+        m_numTilesPerSlab = vector3int32((size.x + voxelsPerTile - 1) / voxelsPerTile,
+                                         (size.y + voxelsPerTile - 1) / voxelsPerTile,
+                                         1);
+        m_numSlabs = (size.z + voxelsPerTile - 1) / voxelsPerTile;
+        m_indSlabToRead = 0;
+        m_numSlabsInMemory = 0;
+        m_reading = false;
+
+        readNextSlabMaster();
+    }
+
+    /**
+     * @brief readNextSlabMaster dispatches the read of the next slab, if not too many slabs are in memory.
+     * The stream gets read by one job at a time.
+     */
+    void readNextSlabMaster()
+    {
+        if (m_reading || !m_success)
+        {
+            return;
+        }
+        if (m_indSlabToRead >= m_numSlabs || m_numSlabsInMemory >= m_maxSlabsInMemory)
+        {
+            return;
+        }
+        m_reading = true;
+        ++m_numSlabsInMemory;
+        m_worker.post(boost::bind(&rawImporter::readSlabTS, this, m_indSlabToRead));
+        ++m_indSlabToRead;
+    }
+
+    /**
+     * @brief readSlabTS reads and quantizes a slab slice by slice. Runs on a worker thread.
+     * @param indSlab
+     */
+    void readSlabTS(const int32& indSlab)
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const int32 depth(math::min<int32>(voxelsPerTile, m_size.z - indSlab*voxelsPerTile));
+        const int32 numPerSlice(m_size.x*m_size.y);
+
+        t_slabPtr result(new vector<int8>(numPerSlice*depth));
+        vector<char> buffer(numPerSlice*calculateSampleSize(m_sampleType));
+        bool success(true);
+
+        for (int32 indZ = 0; indZ < depth; ++indZ)
+        {
+            if (!m_input->read(buffer.data(), buffer.size()))
+            {
+                success = false;
+                break;
+            }
+            int8* dest(result->data() + indZ*numPerSlice);
+            switch (m_sampleType)
+            {
+            case sampleType::uint8:
+                quantizeSlice(reinterpret_cast<const uint8*>(buffer.data()), numPerSlice, dest);
+                break;
+            case sampleType::uint16:
+                quantizeSlice(reinterpret_cast<const uint16*>(buffer.data()), numPerSlice, dest);
+                break;
+            case sampleType::float32:
+                quantizeSlice(reinterpret_cast<const float*>(buffer.data()), numPerSlice, dest);
+                break;
+            }
+        }
+
+        m_master.post(boost::bind(&rawImporter::slabReadMaster, this, indSlab, result, success));
+    }
+
+    /**
+     * @brief slabReadMaster dispatches the build of the tiles of a read slab and continues reading.
+     * @param indSlab
+     * @param data The quantized samples.
+     * @param success false if reading the stream failed.
+     */
+    void slabReadMaster(const int32& indSlab, t_slabPtr data, const bool& success)
+    {
+        m_reading = false;
+
+        if (!success)
+        {
+            m_success = false;
+            --m_numSlabsInMemory;
+            tryFinishMaster();
+            return;
+        }
+
+        slab& toBuild(m_slabs[indSlab]);
+        toBuild.numTilesLeft = m_numTilesPerSlab.x*m_numTilesPerSlab.y;
+        for (int32 indX = 0; indX < m_numTilesPerSlab.x; ++indX)
+        {
+            for (int32 indY = 0; indY < m_numTilesPerSlab.y; ++indY)
+            {
+                m_worker.post(boost::bind(&rawImporter::buildTileTS, this, indSlab, data, vector3int32(indX, indY, indSlab)));
+            }
+        }
+
+        readNextSlabMaster();
+    }
+
+    /**
+     * @brief buildTileTS creates a tile from a slab and classifies it. Runs parallel on the worker threads.
+     * @param indSlab
+     * @param data The quantized samples of the slab.
+     * @param id TileId relative to the grid.
+     */
+    void buildTileTS(const int32& indSlab, t_slabPtr data, const vector3int32& id)
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const vector3int32 start(id*voxelsPerTile);
+        const vector3int32 end(vector3int32(voxelsPerTile).getMinimum(m_size - start));
+        const int32 numPerSlice(m_size.x*m_size.y);
+
+        t_tilePtr result(t_tile::create());
+        result->startEdit();
+
+        t_voxel row[t_config::voxelsPerTile];
+        for (int32 indX = 0; indX < voxelsPerTile; ++indX)
+        {
+            for (int32 indY = 0; indY < voxelsPerTile; ++indY)
+            {
+                if (indX >= end.x || indY >= end.y)
+                {
+                    continue; // outside grid, tile got created with minimum
+                }
+                const int8* source(data->data() + (start.y + indY)*m_size.x + start.x + indX);
+                for (int32 indZ = 0; indZ < voxelsPerTile; ++indZ)
+                {
+                    if (indZ < end.z)
+                    {
+                        row[indZ].setInterpolation(source[indZ*numPerSlice]);
+                    }
+                    else
+                    {
+                        row[indZ].setMin();
+                    }
+                }
+                result->setVoxelRow(vector3int32(indX, indY, 0), row, voxelsPerTile);
+            }
+        }
+        result->endEdit();
+
+        t_utilsTile holder(tileState::partitial);
+        if (result->isEmpty())
+        {
+            holder.state = tileState::empty;
+        }
+        else if (result->isFull())
+        {
+            holder.state = tileState::full;
+        }
+        else
+        {
+            holder.data = result;
+        }
+
+        m_master.post(boost::bind(&rawImporter::tileBuiltMaster, this, indSlab, m_tileOffset + id, holder));
+    }
+
+    /**
+     * @brief tileBuiltMaster collects the tiles of a slab. Passes them to the container when the slab is complete.
+     * @param indSlab
+     * @param id Absolute TileId.
+     * @param holder
+     */
+    void tileBuiltMaster(const int32& indSlab, const t_tileId& id, const t_utilsTile& holder)
+    {
+        typename t_slabMap::iterator it(m_slabs.find(indSlab));
+        BASSERT(it != m_slabs.end());
+
+        slab& toBuild(it->second);
+        toBuild.tiles.insert(id, holder);
+        --toBuild.numTilesLeft;
+        if (toBuild.numTilesLeft > 0)
+        {
+            return;
+        }
+
+        m_container.setTiles(toBuild.tiles);
+        m_slabs.erase(it);
+        --m_numSlabsInMemory;
+
+        readNextSlabMaster();
+        tryFinishMaster();
+    }
+
+    /**
+     * @brief tryFinishMaster calls signalImportDone() if no slab is in memory and nothing is left to read.
+     */
+    void tryFinishMaster()
+    {
+        if (m_numSlabsInMemory > 0 || m_reading)
+        {
+            return;
+        }
+        if (m_success && m_indSlabToRead < m_numSlabs)
+        {
+            return;
+        }
+        m_input.reset();
+        m_importing = false;
+        m_sigImportDone(m_success);
+    }
+
+    /**
+     * @brief quantizeSlice converts samples to voxel-interpolations.
+     * @param source
+     * @param count
+     * @param dest
+     */
+    template <typename sampleValueType>
+    void quantizeSlice(const sampleValueType* source, const int32& count, int8* dest) const
+    {
+        const real scale(127. / m_range);
+        for (int32 ind = 0; ind < count; ++ind)
+        {
+            const real value((static_cast<real>(source[ind]) - m_isoLevel)*scale);
+            dest[ind] = static_cast<int8>(math::clamp<real>(value, -127., 127.));
+        }
+    }
+
+    static int32 calculateSampleSize(const sampleType& type)
+    {
+        switch (type)
+        {
+        case sampleType::uint8:
+            return sizeof(uint8);
+        case sampleType::uint16:
+            return sizeof(uint16);
+        case sampleType::float32:
+            return sizeof(float);
+        }
+        BASSERT(false);
+        return 1;
+    }
+
+protected:
+    async::dispatcher& m_worker;
+    async::strand m_master;
+    t_container& m_container;
+
+    int32 m_maxSlabsInMemory;
+    bool m_importing;
+    bool m_success;
+    bool m_reading;
+
+    t_streamPtr m_input;
+    vector3int32 m_size;
+    sampleType m_sampleType;
+    real m_isoLevel;
+    real m_range;
+    vector3int32 m_tileOffset;
+    vector3int32 m_numTilesPerSlab;
+    int32 m_numSlabs;
+    int32 m_indSlabToRead;
+    int32 m_numSlabsInMemory;
+
+    t_slabMap m_slabs;
+
+    t_sigImportDone m_sigImportDone;
+
+};
+
+
+}
+}
+}
+}
+}
+}
+
+#endif // BLUB_PROCEDURAL_VOXEL_SIMPLE_CONTAINER_UTILS_RAWIMPORTER_HPP
@@ -31,6 +31,7 @@ namespace simple
  * Including renderdistance and enabling the submeshes for losing the cracks (transvoxel results).
  * Takes the results and updates from the simple::surface and saves them into an octree.
  * Casts signals on when to update an LOD.
+ * The transvoxel-faces get calculated by the worker before a tile gets them visible, so the render-thread never runs transvoxel.
  */
 // TODO reimplement class, with better threading and better octree/sync.
 template <class configType>
@@ -50,6 +51,24 @@ public:
 
     typedef typename t_config::t_surface::t_tile t_tileSurface;
     typedef sharedPointer<t_tileSurface> t_tileDataPtr;
+    typedef hashMap<vector3int32, t_tileDataPtr> t_tileDataMap;
+
+    /**
+     * @brief The facesInCalculation struct saves the transvoxel-faces of a tile the worker calculates and if the tile shall show them afterwards. One bit per face.
+     */
+    struct facesInCalculation
+    {
+        facesInCalculation()
+            : calculating(0)
+            , visible(0)
+        {
+            ;
+        }
+
+        uint8 calculating;
+        uint8 visible;
+    };
+    typedef hashMap<vector3int32, facesInCalculation> t_facesInCalculationMap;
 
     typedef std::function<bool (vector3, axisAlignedBox)> t_octreeSearchCallback;
 
@@ -148,6 +167,7 @@ protected:
     void editDoneMaster()
     {
         auto& change(m_voxels->getTilesThatGotEdited());
+        const bool attributesOnly(m_voxels->getEditedAttributesOnly());
         for (auto hasChanged : change)
         {
             const t_tileId id(hasChanged.first);
@@ -159,7 +179,14 @@ protected:
             }
             else
             {
-                tileGotSetMaster(id, work);
+                if (attributesOnly)
+                {
+                    tileGotAttributesSetMaster(id, work);
+                }
+                else
+                {
+                    tileGotSetMaster(id, work);
+                }
             }
         }
 
@@ -179,9 +206,7 @@ protected:
         const bool found(it != m_tileData.cend());
 
         const int32 voxelsPerTile(t_config::voxelsPerTile);
-        axisAlignedBox aabb(vector3(id*voxelsPerTile),
-                            vector3(id*voxelsPerTile+vector3int32(voxelsPerTile)));
-        aabb*=m_voxelSize;
+        const axisAlignedBox aabb(calculateTileBoundingBox(id));
         t_tilePtr workTile;
         if (found)
         {
@@ -191,8 +216,16 @@ protected:
         {
             workTile = t_base::createTile();
         }
+        setTileSurface(id, workTile, toSet);
 
-        workTile->setTileData(toSet, aabb);
+        if (found && toSet->getRemeshedPartially())
+        {
+            workTile->setTileDataPartial(toSet, aabb);
+        }
+        else
+        {
+            workTile->setTileData(toSet, aabb);
+        }
 
         if (!found)
         {
@@ -204,6 +237,37 @@ protected:
         }
     }
 
+    /**
+     * @brief tileGotAttributesSetMaster updates the vertex-attributes of a tile. Gets called if only the voxel-attributes changed.
+     * @param id TileId
+     * @param toSet The Surface-tile to work on.
+     */
+    void tileGotAttributesSetMaster(const t_tileId& id, const t_tileDataPtr toSet)
+    {
+        typename t_tileMap::const_iterator it = m_tileData.find(id);
+        if (it == m_tileData.cend())
+        {
+            tileGotSetMaster(id, toSet);
+            return;
+        }
+        setTileSurface(id, it->second, toSet);
+
+        it->second->setTileDataAttributes(toSet, calculateTileBoundingBox(id));
+    }
+
+    /**
+     * @brief calculateTileBoundingBox returns the bounds of a tile.
+     * @param id TileId
+     */
+    axisAlignedBox calculateTileBoundingBox(const t_tileId& id) const
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        axisAlignedBox aabb(vector3(id*voxelsPerTile),
+                            vector3(id*voxelsPerTile+vector3int32(voxelsPerTile)));
+        aabb*=m_voxelSize;
+        return aabb;
+    }
+
     /**
      * @brief tileGotRemovedMaster removes tile from octree.
      * @param id TileId
@@ -216,6 +280,105 @@ protected:
         m_sync->removeSyncMaster(id);
 
         m_tileData.erase(it);
+        m_tileSurfaces.erase(id);
+    }
+
+    /**
+     * @brief setTileSurface remembers the surface-tile of a tile and calculates the transvoxel-faces the tile shows, before the tile gets it.
+     * Runs on the worker, like editDoneMaster().
+     * @param id TileId
+     * @param shows The tile that gets toSet.
+     * @param toSet The new surface-tile.
+     */
+    void setTileSurface(const t_tileId& id, t_tilePtr shows, const t_tileDataPtr toSet)
+    {
+        m_tileSurfaces.insert(id, toSet);
+        for (uint16 face = 0; face < 6; ++face)
+        {
+            if (shows->getVisibleLod(face))
+            {
+                toSet->getIndicesLod(face);
+            }
+        }
+    }
+
+    /**
+     * @brief setVisibleLod shows or hides a transvoxel-face of a tile.
+     * A face that didn't get calculated yet gets calculated by calculateTransitionFaceWorker() first, the tile shows it afterwards.
+     * @param id TileId
+     * @param toUpdate The tile of id.
+     * @param face 0 to 5.
+     * @param vis
+     */
+    void setVisibleLod(const t_tileId& id, t_tilePtr toUpdate, const uint16& face, const bool& vis)
+    {
+        const uint8 faceBit(1 << face);
+        typename t_facesInCalculationMap::iterator inCalculation(m_facesInCalculation.find(id));
+        if (inCalculation != m_facesInCalculation.end() && (inCalculation->second.calculating & faceBit) != 0)
+        {
+            // transitionFaceCalculatedMaster() sets the last requested visibility
+            if (vis)
+            {
+                inCalculation->second.visible |= faceBit;
+            }
+            else
+            {
+                inCalculation->second.visible &= ~faceBit;
+            }
+            return;
+        }
+        if (vis && !toUpdate->getVisibleLod(face))
+        {
+            typename t_tileDataMap::const_iterator surface(m_tileSurfaces.find(id));
+            if (surface != m_tileSurfaces.cend() && !surface->second->getTransitionFaceCalculated(face))
+            {
+                facesInCalculation& work(m_facesInCalculation[id]);
+                work.calculating |= faceBit;
+                work.visible |= faceBit;
+                t_base::m_worker.post(boost::bind(&renderer::calculateTransitionFaceWorker, this, id, surface->second, face));
+                return;
+            }
+        }
+        toUpdate->setVisibleLod(face, vis);
+    }
+
+    /**
+     * @brief calculateTransitionFaceWorker calculates a transvoxel-face on the worker.
+     * @param id TileId
+     * @param toCalculate The surface-tile of id at the time of the request.
+     * @param face 0 to 5.
+     */
+    void calculateTransitionFaceWorker(const t_tileId& id, const t_tileDataPtr toCalculate, const uint16& face)
+    {
+        toCalculate->getIndicesLod(face);
+        m_sync->getMaster().dispatch(boost::bind(&renderer::transitionFaceCalculatedMaster, this, id, face));
+    }
+
+    /**
+     * @brief transitionFaceCalculatedMaster sets the visibility requested during calculateTransitionFaceWorker().
+     * Meanwhile the tile may got removed or a new surface-tile, in the last case setVisibleLod() requests the face of the new one.
+     * @param id TileId
+     * @param face 0 to 5.
+     */
+    void transitionFaceCalculatedMaster(const t_tileId& id, const uint16& face)
+    {
+        const uint8 faceBit(1 << face);
+        typename t_facesInCalculationMap::iterator inCalculation(m_facesInCalculation.find(id));
+        BASSERT(inCalculation != m_facesInCalculation.end());
+        const bool vis((inCalculation->second.visible & faceBit) != 0);
+        inCalculation->second.calculating &= ~faceBit;
+        inCalculation->second.visible &= ~faceBit;
+        if (inCalculation->second.calculating == 0)
+        {
+            m_facesInCalculation.erase(inCalculation);
+        }
+
+        typename t_tileMap::const_iterator it(m_tileData.find(id));
+        if (it == m_tileData.cend())
+        {
+            return;
+        }
+        setVisibleLod(id, it->second, face, vis);
     }
 
     /**
@@ -314,11 +477,11 @@ protected:
             const int32 doLod(isInRange(m_cameraPositionInTreeLeaf, axisAlignedBox(neighbourOctreeNode)));
             if (toUpdate->getVisible())
             {
-                toUpdate->setVisibleLod(lod, doLod == 1);
+                setVisibleLod(id, toUpdate, lod, doLod == 1);
             }
             else
             {
-                toUpdate->setVisibleLod(lod, false);
+                setVisibleLod(id, toUpdate, lod, false);
             }
             typename t_tileMap::const_iterator it(m_tileData.find(neighbourId));
             if (it == m_tileData.cend())
@@ -327,11 +490,11 @@ protected:
             }
             if (toUpdate->getVisible())
             {
-                it->second->setVisibleLod(toSetOnNeighbour[lod], false);
+                setVisibleLod(neighbourId, it->second, toSetOnNeighbour[lod], false);
             }
             else
             {
-                it->second->setVisibleLod(toSetOnNeighbour[lod], tileWork == 1);
+                setVisibleLod(neighbourId, it->second, toSetOnNeighbour[lod], tileWork == 1);
             }
         }
     }
@@ -396,6 +559,8 @@ private:
     t_rendererSurface* m_voxels;
 
     t_tileMap m_tileData; // TODO remove me. insert the tile into the tree, instead of the id --> faster and cleaner.
+    t_tileDataMap m_tileSurfaces; // the surface-tile last set to the tile of an id, for calculating its transvoxel-faces
+    t_facesInCalculationMap m_facesInCalculation;
     t_sync *m_sync;
 
 };
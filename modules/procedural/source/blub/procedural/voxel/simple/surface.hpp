@@ -6,9 +6,12 @@
 #include "blub/core/hashList.hpp"
 #include "blub/core/hashMap.hpp"
 #include "blub/core/signal.hpp"
+#include "blub/math/axisAlignedBoxInt32.hpp"
 #include "blub/math/vector3int.hpp"
 #include "blub/procedural/log/global.hpp"
 #include "blub/procedural/voxel/simple/accessor.hpp"
+#include "blub/procedural/voxel/simple/container/base.hpp"
+#include "blub/procedural/voxel/tile/haloView.hpp"
 
 #include <boost/signals2/connection.hpp>
 
@@ -25,6 +28,9 @@ namespace simple
 
 /**
  * @brief The surface class convertes accessor-tiles to surface-tiles. In between polygons get calculated by the surface-tile.
+ * For lod 0 it may read the container directly instead, see the constructor taking a container. That saves the accessor-stage,
+ * its copy of every voxel and one hop over the master-thread.
+ * Surface-tiles never change after they got calculated, every job creates a new one. So consumers like the renderer may keep them without a copy.
  */
 template <class configType>
 class surface : public base<typename configType::t_surface::t_tile>
@@ -39,11 +45,20 @@ public:
 
     typedef hashMap<t_tileId, t_tilePtr> t_tilesMap;
     typedef hashList<vector3int32> t_tileIdList;
+    typedef hashMap<t_tileId, axisAlignedBoxInt32> t_tileDirtyMap;
 
     typedef typename t_config::t_accessor::t_tile t_tileAccessor;
     typedef sharedPointer<t_tileAccessor> t_tileAccessorPtr;
     typedef base<t_tileAccessor> t_voxelAccessor;
 
+    typedef typename t_config::t_container::t_simple t_voxelContainer;
+    typedef typename t_config::t_container::t_tile t_tileContainer;
+    typedef container::utils::tile<t_tileContainer> t_tileHolder;
+    typedef container::utils::tileState t_tileState;
+    typedef tile::haloView<t_config> t_haloView;
+    typedef typename t_tile::normalMode t_normalMode;
+    typedef typename t_tile::vertexFormat t_vertexFormat;
+
 
     /**
      * @brief surface constructor.
@@ -55,14 +70,43 @@ public:
             t_voxelAccessor& voxels,
             const int32& lod)
         : t_base(worker)
-        , m_voxels(voxels)
+        , m_voxels(&voxels)
+        , m_container(nullptr)
         , m_lod(lod)
         , m_numTilesInWork(0)
+        , m_normalMode(t_normalMode::faceAverage)
+        , m_vertexFormat(t_vertexFormat::full)
+        , m_remeshPartially(true)
+        , m_optimizeVertexCache(false)
+        , m_decimation(0.)
     {
         voxels.signalEditDone()->connect(boost::bind(&surface::editDone, this));
 
         t_base::setCreateTileCallback(boost::bind(&t_tile::create));
     }
+    /**
+     * @brief surface constructor for lod 0 without an accessor in between.
+     * Surface-tiles get calculated directly on the container-tiles and their neighbours, see tile::haloView.
+     * @param worker May getting called by several threads.
+     * @param voxels The container to which this class listens for updates to.
+     */
+    surface(blub::async::dispatcher &worker,
+            t_voxelContainer& voxels)
+        : t_base(worker)
+        , m_voxels(nullptr)
+        , m_container(&voxels)
+        , m_lod(0)
+        , m_numTilesInWork(0)
+        , m_normalMode(t_normalMode::faceAverage)
+        , m_vertexFormat(t_vertexFormat::full)
+        , m_remeshPartially(true)
+        , m_optimizeVertexCache(false)
+        , m_decimation(0.)
+    {
+        m_connTilesGotChanged = voxels.signalEditDone()->connect(boost::bind(&surface::containerEditDone, this));
+
+        t_base::setCreateTileCallback(boost::bind(&t_tile::create));
+    }
     /**
      * @brief ~surface destructor.
      */
@@ -79,6 +123,14 @@ public:
     {
         return m_tiles.size();
     }
+    /**
+     * @brief getTilesMap returns all tiles calculated by this class. Read-lock class before calling.
+     * @return
+     */
+    const t_tilesMap& getTilesMap() const
+    {
+        return m_tiles;
+    }
     /**
      * @brief getVoxelSize returns the voxel-size.
      * @return pow(2, lod)
@@ -88,6 +140,82 @@ public:
         return math::pow(2., m_lod);
     }
 
+    /**
+     * @brief setNormalMode sets how the surface-tiles calculate their vertex-normals. Call before the first edit.
+     * @param toSet
+     * @see tile::surface::setNormalMode()
+     */
+    void setNormalMode(const t_normalMode& toSet)
+    {
+        m_normalMode = toSet;
+    }
+    /**
+     * @brief setVertexFormat sets which vertex-buffers the surface-tiles keep. Call before the first edit.
+     * The renderer reads tile::surface::getVertices(), so keep vertexFormat::full or vertexFormat::fullAndQuantized if you use simple::renderer.
+     * @param toSet
+     * @see tile::surface::setVertexFormat()
+     */
+    void setVertexFormat(const t_vertexFormat& toSet)
+    {
+        m_vertexFormat = toSet;
+    }
+
+    /**
+     * @brief setRemeshPartially sets if edited tiles remesh only the cells around the changed voxel, see tile::surface::calculateSurfacePartial().
+     * The resulting surface-tiles tell the renderer which ranges of their lists changed. Default is true.
+     * @param toSet
+     */
+    void setRemeshPartially(const bool& toSet)
+    {
+        m_remeshPartially = toSet;
+    }
+    /**
+     * @brief getRemeshPartially returns what got set by setRemeshPartially().
+     * @return
+     */
+    const bool& getRemeshPartially() const
+    {
+        return m_remeshPartially;
+    }
+
+    /**
+     * @brief setOptimizeVertexCache sets if the surface-tiles reorder their triangles and vertices for the gpu after meshing. Default is false.
+     * Optimized tiles always remesh completely, so setRemeshPartially() has no effect.
+     * @param toSet
+     * @see tile::surface::setOptimizeVertexCache()
+     */
+    void setOptimizeVertexCache(const bool& toSet)
+    {
+        m_optimizeVertexCache = toSet;
+    }
+    /**
+     * @brief getOptimizeVertexCache returns what got set by setOptimizeVertexCache().
+     * @return
+     */
+    const bool& getOptimizeVertexCache() const
+    {
+        return m_optimizeVertexCache;
+    }
+
+    /**
+     * @brief setDecimation sets the error-budget with which the surface-tiles reduce their triangles after meshing. Use it for far lods. Default is 0, no decimation.
+     * Decimated tiles always remesh completely, so setRemeshPartially() has no effect.
+     * @param toSet Maximal error in voxel of this lod.
+     * @see tile::surface::setDecimation()
+     */
+    void setDecimation(const real& toSet)
+    {
+        m_decimation = toSet;
+    }
+    /**
+     * @brief getDecimation returns what got set by setDecimation().
+     * @return
+     */
+    const real& getDecimation() const
+    {
+        return m_decimation;
+    }
+
     /**
      * @brief getTile returns a surface-tile. Lock-read class before.
      * @param id TileId
@@ -125,7 +253,7 @@ protected:
      */
     void editDone()
     {
-        m_voxels.lockForRead();
+        m_voxels->lockForRead();
 
         t_base::m_master.post(boost::bind(&surface::editDoneMaster, this));
     }
@@ -137,7 +265,7 @@ protected:
      */
     void editDoneMaster()
     {
-        const typename t_voxelAccessor::t_tilesGotChangedMap& change(m_voxels.getTilesThatGotEdited());
+        const typename t_voxelAccessor::t_tilesGotChangedMap& change(m_voxels->getTilesThatGotEdited());
 #ifdef BLUB_LOG_VOXEL
         BLUB_PROCEDURAL_LOG_OUT() << "surface editDoneMaster change.size():" << change.size();
 #endif
@@ -147,7 +275,10 @@ protected:
             return;
         }
 
+        const bool attributesOnly(m_voxels->getEditedAttributesOnly());
+
         t_base::lockForEditMaster();
+        t_base::m_editedAttributesOnly = attributesOnly;
 
         BASSERT(m_numTilesInWork == 0);
         m_numTilesInWork = change.size();
@@ -163,30 +294,227 @@ protected:
             BASSERT(!work.second->isEmpty());
             BASSERT(!work.second->isFull());
 
-            t_tilePtr workTile(getTile(work.first));
+            if (attributesOnly)
+            {
+                const t_tilePtr workTile(getTile(work.first));
+                if (workTile.isNull())
+                {
+                    afterCalculateSurfaceMaster(work.first, nullptr);
+                    continue;
+                }
+                t_base::postTileJobMaster(work.first, boost::bind(&surface::updateVertexAttributesTS, this, work.first, work.second, workTile));
+                continue;
+            }
 
-            t_base::m_worker.post(boost::bind(&surface::calculateSurfaceTS, this, work.first, work.second, workTile));
+            t_base::postTileJobMaster(work.first, boost::bind(&surface::calculateSurfaceTS, this, work.first, work.second, getTile(work.first)));
         }
     }
 
+    /**
+     * @brief containerEditDone gets called when data in container changed. Only used if no accessor is in between.
+     */
+    void containerEditDone()
+    {
+        m_container->lockForRead();
+
+        t_base::m_master.post(boost::bind(&surface::containerEditDoneMaster, this));
+    }
+
+    /**
+     * @brief containerEditDoneMaster same like editDoneMaster() but for the container.
+     * Looks up all surface-tiles that read the changed voxel and dispatches them to the worker-threads.
+     * @see containerEditDone()
+     */
+    void containerEditDoneMaster()
+    {
+        const auto& change(m_container->getTilesThatGotEdited());
+#ifdef BLUB_LOG_VOXEL
+        BLUB_PROCEDURAL_LOG_OUT() << "surface containerEditDoneMaster change.size():" << change.size();
+#endif
+        const bool attributesOnly(m_container->getEditedAttributesOnly());
+
+        t_tileDirtyMap affectedTiles;
+        for (auto work : change)
+        {
+            calculateAffectedSurfaceTilesByContainerTile(work.first, work.second, affectedTiles);
+        }
+
+        if (attributesOnly)
+        {
+            // the iso-surface didn't change - only existing surface-tiles have to get updated
+            t_tileDirtyMap existingTiles;
+            for (const typename t_tileDirtyMap::value_type& work : affectedTiles)
+            {
+                if (m_tiles.find(work.first) != m_tiles.cend())
+                {
+                    existingTiles.insert(work.first, work.second);
+                }
+            }
+            affectedTiles.swap(existingTiles);
+        }
+
+        if (affectedTiles.empty())
+        {
+            m_container->unlockRead();
+            return;
+        }
+
+        t_base::lockForEditMaster();
+        t_base::m_editedAttributesOnly = attributesOnly;
+
+        BASSERT(m_numTilesInWork == 0);
+        m_numTilesInWork = affectedTiles.size();
+
+        for (const typename t_tileDirtyMap::value_type& work : affectedTiles)
+        {
+            t_base::postTileJobMaster(work.first, boost::bind(&surface::calculateSurfaceByContainerTS, this, work.first, getTile(work.first), work.second, attributesOnly));
+        }
+    }
+
+    /**
+     * @brief calculateAffectedSurfaceTilesByContainerTile inserts every surface-tile that reads voxel inside the edited bounds of a container-tile.
+     * A surface-tile reads the voxel from id*voxelLength-1 to (id+1)*voxelLength+1, so up to 3^3 surface-tiles are affected.
+     * @param containerId Container-TileId.
+     * @param holder Container-data.
+     * @param result Resulting surface-TileIds and the changed voxel relative to them. Bounds of several container-tiles get merged.
+     */
+    void calculateAffectedSurfaceTilesByContainerTile(const t_tileId& containerId, const t_tileHolder& holder, t_tileDirtyMap& result) const
+    {
+        const int32 voxelLength(t_tileContainer::voxelLength);
+
+        vector3int32 changedMin(0);
+        vector3int32 changedMax(voxelLength-1);
+        if (holder.state == t_tileState::partitial)
+        {
+            axisAlignedBoxInt32 changed(holder.data->getEditedVoxelBoundingBox());
+            BASSERT(changed.isValid());
+            changedMin = changed.getMinimum();
+            changedMax = changed.getMaximum();
+        }
+
+        for (int32 indX = -1; indX <= 1; ++indX)
+        {
+            for (int32 indY = -1; indY <= 1; ++indY)
+            {
+                for (int32 indZ = -1; indZ <= 1; ++indZ)
+                {
+                    // the changed voxel relative to the surface-tile
+                    const vector3int32 offset(vector3int32(indX, indY, indZ)*voxelLength);
+                    if (changedMax - offset >= vector3int32(-1) &&
+                        changedMin - offset <= vector3int32(voxelLength+1))
+                    {
+                        const vector3int32 dirtyMin(vector3int32(changedMin - offset).getMaximum(vector3int32(-1)));
+                        const vector3int32 dirtyMax(vector3int32(changedMax - offset).getMinimum(vector3int32(voxelLength+1)));
+
+                        axisAlignedBoxInt32& dirty(result[containerId + vector3int32(indX, indY, indZ)]);
+                        dirty.extend(dirtyMin);
+                        dirty.extend(dirtyMax);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief calculateSurfaceByContainerTS gets called by containerEditDoneMaster(), by any worker-thread.
+     * Reads the voxel through a tile::haloView. Calls afterCalculateSurfaceMaster() after work is done.
+     * @param id TileId
+     * @param oldTile The existing surface-tile or nullptr. Gets only read, see afterCalculateSurfaceMaster().
+     * @param changed The changed voxel relative to the surface-tile. See tile::surface::calculateSurfacePartial().
+     * @param attributesOnly If true only the vertex-attributes get updated. See updateVertexAttributesTS().
+     */
+    void calculateSurfaceByContainerTS(const t_tileId id, const t_tilePtr oldTile, const axisAlignedBoxInt32 changed, const bool attributesOnly)
+    {
+        t_haloView voxel;
+        for (int32 indX = -1; indX <= 1; ++indX)
+        {
+            for (int32 indY = -1; indY <= 1; ++indY)
+            {
+                for (int32 indZ = -1; indZ <= 1; ++indZ)
+                {
+                    const vector3int32 offset(indX, indY, indZ);
+                    voxel.setTile(offset, m_container->getTileHolder(id + offset));
+                }
+            }
+        }
+
+        if (voxel.isUniform())
+        {
+            t_base::m_master.post(boost::bind(&surface::afterCalculateSurfaceMaster, this, id, nullptr));
+            return;
+        }
+
+        if (attributesOnly)
+        {
+            BASSERT(!oldTile.isNull());
+            const t_tilePtr workTile(t_tile::createCopy(oldTile));
+            workTile->updateVertexAttributes(voxel);
+
+            t_base::m_master.post(boost::bind(&surface::afterCalculateSurfaceMaster, this, id, workTile));
+            return;
+        }
+
+        t_tilePtr workTile;
+        if (m_remeshPartially && !oldTile.isNull())
+        {
+            workTile = t_tile::createCopy(oldTile);
+            if (!workTile->calculateSurfacePartial(voxel, changed))
+            {
+                workTile.reset();
+            }
+        }
+        if (workTile.isNull())
+        {
+            workTile = t_base::createTile();
+            workTile->setNormalMode(m_normalMode);
+            workTile->setVertexFormat(m_vertexFormat);
+            workTile->setOptimizeVertexCache(m_optimizeVertexCache);
+            workTile->setDecimation(m_decimation);
+            workTile->calculateSurface(voxel,
+                                       getVoxelSize(),
+                                       true);
+        }
+
+        if (workTile->getIndices().empty())
+        {
+            t_base::m_master.post(boost::bind(&surface::afterCalculateSurfaceMaster, this, id, nullptr));
+            return;
+        }
+
+        t_base::m_master.post(boost::bind(&surface::afterCalculateSurfaceMaster, this, id, workTile));
+    }
+
     /**
      * @brief calculateSurfaceTS gets called by editDoneMaster(), by any worker-thread.
      * Calls afterCalculateSurfaceMaster() after work is done.
      * @param id TileId
      * @param work The accessorTile to turn into a surface-tile.
-     * @param workTile the resulting surface tile.
+     * @param oldTile The existing surface-tile or nullptr. If set only the changed voxel of work get remeshed, see setRemeshPartially().
      * @see editDoneMaster()
      */
-    void calculateSurfaceTS(const t_tileId id, t_tileAccessorPtr work, t_tilePtr workTile)
+    void calculateSurfaceTS(const t_tileId id, t_tileAccessorPtr work, const t_tilePtr oldTile)
     {
+        t_tilePtr workTile;
+        if (m_remeshPartially && !oldTile.isNull())
+        {
+            workTile = t_tile::createCopy(oldTile);
+            if (!workTile->calculateSurfacePartial(work, work->getChangedVoxelBoundingBox()))
+            {
+                workTile.reset();
+            }
+        }
         if (workTile.isNull())
         {
             workTile = t_base::createTile();
+            workTile->setNormalMode(m_normalMode);
+            workTile->setVertexFormat(m_vertexFormat);
+            workTile->setOptimizeVertexCache(m_optimizeVertexCache);
+            workTile->setDecimation(m_decimation);
+            workTile->calculateSurface(work,
+                                       getVoxelSize(),
+                                       true,
+                                       m_lod);
         }
-        workTile->calculateSurface(work,
-                                   getVoxelSize(),
-                                   true,
-                                   m_lod);
 
         if (workTile->getIndices().empty())
         {
@@ -200,6 +528,25 @@ protected:
         t_base::m_master.post(boost::bind(&surface::afterCalculateSurfaceMaster, this, id, workTile));
     }
 
+    /**
+     * @brief updateVertexAttributesTS gets called by editDoneMaster() instead of calculateSurfaceTS() if only voxel-attributes changed.
+     * Copies the existing surface-tile, keeps its triangles and only updates the vertex-attributes.
+     * Calls afterCalculateSurfaceMaster() after work is done.
+     * @param id TileId
+     * @param work The accessorTile with the changed attributes.
+     * @param oldTile The existing surface-tile. Must not be nullptr. Gets only read.
+     * @see editDoneMaster()
+     */
+    void updateVertexAttributesTS(const t_tileId id, t_tileAccessorPtr work, const t_tilePtr oldTile)
+    {
+        BASSERT(!oldTile.isNull());
+
+        const t_tilePtr workTile(t_tile::createCopy(oldTile));
+        workTile->updateVertexAttributes(work);
+
+        t_base::m_master.post(boost::bind(&surface::afterCalculateSurfaceMaster, this, id, workTile));
+    }
+
     /**
      * @brief afterCalculateSurfaceMaster gets called by calculateSurfaceTS() on master-thread.
      * @param id TileId
@@ -232,10 +579,8 @@ protected:
         else
         {
             BASSERT(!workTile.isNull());
-            if (it == m_tiles.cend())
-            {
-                m_tiles.insert(id, workTile);
-            }
+            // every job creates a new tile, the next attribute update or partial remesh has to start from it
+            m_tiles.insert(id, workTile);
             t_base::addToChangeList(id, workTile);
         }
 
@@ -243,7 +588,14 @@ protected:
         BASSERT(m_numTilesInWork >= 0);
         if (m_numTilesInWork == 0)
         {
-            m_voxels.unlockRead();
+            if (m_voxels != nullptr)
+            {
+                m_voxels->unlockRead();
+            }
+            else
+            {
+                m_container->unlockRead();
+            }
             t_base::unlockForEditMaster();
         }
     }
@@ -252,9 +604,15 @@ protected:
 private:
     t_tilesMap m_tiles;
 
-    t_voxelAccessor &m_voxels;
+    t_voxelAccessor *m_voxels;
+    t_voxelContainer *m_container;
     int32 m_lod;
     int32 m_numTilesInWork;
+    t_normalMode m_normalMode;
+    t_vertexFormat m_vertexFormat;
+    bool m_remeshPartially;
+    bool m_optimizeVertexCache;
+    real m_decimation;
 
     boost::signals2::scoped_connection m_connTilesGotChanged;
 
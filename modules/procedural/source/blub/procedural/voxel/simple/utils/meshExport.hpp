@@ -0,0 +1,328 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_SIMPLE_UTILS_MESHEXPORT_HPP
+#define BLUB_PROCEDURAL_VOXEL_SIMPLE_UTILS_MESHEXPORT_HPP
+
+#include "blub/async/dispatcher.hpp"
+#include "blub/async/strand.hpp"
+#include "blub/core/bind.hpp"
+#include "blub/core/globals.hpp"
+#include "blub/core/hashMap.hpp"
+#include "blub/core/noncopyable.hpp"
+#include "blub/core/sharedPointer.hpp"
+#include "blub/core/signal.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/vector3.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/predecl.hpp"
+#include "blub/procedural/voxel/simple/surface.hpp"
+
+#include <algorithm>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace simple
+{
+namespace utils
+{
+
+
+/**
+ * @brief The meshExport class welds the surface-tiles of a region to one indexed mesh, for offline tools like navmesh baking.
+ * Every surface-tile is a mesh on its own, so vertices on the border of a tile exist in both neighbours and differ at float-epsilon level.
+ * meshExport merges them by tile::surface::getVertexId(). The tiles get converted parallel by the worker, the welding is one job.
+ * Only the surface of one lod gets exported, the transvoxel-faces getIndicesLod() don't.
+ * Positions are absolute: tile-position + vertex-position.
+ */
+template <class configType>
+class meshExport : public noncopyable
+{
+public:
+    typedef configType t_config;
+    typedef simple::surface<t_config> t_surface;
+    typedef typename t_surface::t_tile t_tile;
+    typedef typename t_surface::t_tilePtr t_tilePtr;
+    typedef typename t_surface::t_tileId t_tileId;
+
+    /**
+     * @brief The mesh struct is the welded result. positions, normals and vertexIds have the same size.
+     */
+    struct mesh
+    {
+        vector<vector3> positions;
+        vector<vector3> normals;
+        /// see tile::surface::getVertexId()
+        vector<uint64> vertexIds;
+        /// three per triangle
+        vector<uint32> indices;
+    };
+    typedef sharedPointer<mesh> t_meshPtr;
+
+    typedef blub::signal<void (t_meshPtr)> t_sigExportDone;
+
+    /**
+     * @brief meshExport constructor.
+     * @param worker Converts the tiles. May gets run by several threads.
+     * @param surface The surface of which the tiles get exported. Must live longer than the export.
+     */
+    meshExport(async::dispatcher& worker, t_surface& surface)
+        : m_worker(worker)
+        , m_master(worker)
+        , m_surface(surface)
+        , m_exporting(false)
+        , m_numTilesLeft(0)
+    {
+        ;
+    }
+
+    /**
+     * @brief exportRegion starts the export of the tiles from tileStart to tileEnd. Returns immediately. signalExportDone() gets called when done.
+     * Don't start an export while another one is running.
+     * @param tileStart First TileId.
+     * @param tileEnd TileId behind the last one, exclusive.
+     */
+    void exportRegion(const t_tileId& tileStart, const t_tileId& tileEnd)
+    {
+        BASSERT(tileStart <= tileEnd);
+
+        m_master.post(boost::bind(&meshExport::exportRegionMaster, this, tileStart, tileEnd));
+    }
+
+    /**
+     * @brief signalExportDone gets called with the welded mesh after an export. Never nullptr, empty if the region has no surface.
+     * @return
+     */
+    t_sigExportDone* signalExportDone()
+    {
+        return &m_sigExportDone;
+    }
+
+protected:
+    /**
+     * @brief The tileMesh struct is a surface-tile converted to absolute positions. indices are local.
+     */
+    struct tileMesh
+    {
+        t_tileId id;
+        vector<vector3> positions;
+        vector<vector3> normals;
+        vector<uint64> vertexIds;
+        vector<uint32> indices;
+
+        bool operator < (const tileMesh& other) const
+        {
+            if (id.x != other.id.x)
+            {
+                return id.x < other.id.x;
+            }
+            if (id.y != other.id.y)
+            {
+                return id.y < other.id.y;
+            }
+            return id.z < other.id.z;
+        }
+    };
+    typedef sharedPointer<tileMesh> t_tileMeshPtr;
+    typedef vector<t_tileMeshPtr> t_tileMeshes;
+
+    void exportRegionMaster(const t_tileId& tileStart, const t_tileId& tileEnd)
+    {
+        BASSERT(!m_exporting);
+
+        // surface-tiles never change, keep them and release the surface
+        vector<std::pair<t_tileId, t_tilePtr> > tiles;
+        m_surface.lockForRead();
+        for (int32 x = tileStart.x; x < tileEnd.x; ++x)
+        {
+            for (int32 y = tileStart.y; y < tileEnd.y; ++y)
+            {
+                for (int32 z = tileStart.z; z < tileEnd.z; ++z)
+                {
+                    const t_tileId id(x, y, z);
+                    const t_tilePtr work(m_surface.getTile(id));
+                    if (!work.isNull() && !work->getIndices().empty())
+                    {
+                        tiles.push_back(std::make_pair(id, work));
+                    }
+                }
+            }
+        }
+        const real voxelSize(m_surface.getVoxelSize());
+        m_surface.unlockRead();
+
+        m_exporting = true;
+        m_tileMeshes.clear();
+        m_tileMeshes.reserve(tiles.size());
+        m_numTilesLeft = tiles.size();
+        if (tiles.empty())
+        {
+            m_worker.post(boost::bind(&meshExport::weldTS, this, t_tileMeshes()));
+            return;
+        }
+        for (const std::pair<t_tileId, t_tilePtr>& work : tiles)
+        {
+            m_worker.post(boost::bind(&meshExport::convertTileTS, this, work.first, work.second, voxelSize));
+        }
+    }
+
+    /**
+     * @brief convertTileTS converts the referenced vertices of a surface-tile to absolute positions. Runs parallel on the worker threads.
+     * @param id
+     * @param work
+     * @param voxelSize
+     */
+    void convertTileTS(const t_tileId& id, t_tilePtr work, const real& voxelSize)
+    {
+        const int32 voxelsPerTile(t_config::voxelsPerTile);
+        const vector3 offset(vector3(id*voxelsPerTile)*voxelSize);
+        const typename t_tile::t_indices& indices(work->getIndices());
+        const int32 numVertices(work->getVertices().empty() ? work->getVerticesQuantized().size() : work->getVertices().size());
+
+        t_tileMeshPtr result(new tileMesh());
+        result->id = id;
+        result->indices.reserve(indices.size());
+
+        // vertices of the normal-correction ring aren't referenced
+        vector<int32> local(numVertices, -1);
+        for (const typename t_tile::t_indices::value_type& index : indices)
+        {
+            int32& converted(local[index]);
+            if (converted == -1)
+            {
+                converted = result->positions.size();
+                vector3 position;
+                vector3 normal;
+                if (!work->getVertices().empty())
+                {
+                    position = work->getVertices()[index].position;
+                    normal = work->getVertices()[index].normal;
+                }
+                else
+                {
+                    const typename t_tile::t_vertexQuantized& quantized(work->getVerticesQuantized()[index]);
+                    position = quantized.decodePosition(work->getDequantization());
+                    normal = quantized.decodeNormal();
+                }
+                result->positions.push_back(offset + position);
+                result->normals.push_back(normal);
+                result->vertexIds.push_back(work->getVertexId(index, id));
+            }
+            result->indices.push_back(converted);
+        }
+
+        m_master.post(boost::bind(&meshExport::tileConvertedMaster, this, result));
+    }
+
+    /**
+     * @brief tileConvertedMaster collects the converted tiles. Dispatches the welding when all are done.
+     * @param converted
+     */
+    void tileConvertedMaster(t_tileMeshPtr converted)
+    {
+        m_tileMeshes.push_back(converted);
+        --m_numTilesLeft;
+        if (m_numTilesLeft > 0)
+        {
+            return;
+        }
+
+        t_tileMeshes toWeld;
+        toWeld.swap(m_tileMeshes);
+        m_worker.post(boost::bind(&meshExport::weldTS, this, toWeld));
+    }
+
+    /**
+     * @brief weldTS merges the converted tiles by their vertex-ids. Runs on a worker thread.
+     * The tiles get merged sorted by id, so a vertex on a border always gets the position of the same tile, regardless of the job order.
+     * @param toWeld
+     */
+    void weldTS(t_tileMeshes toWeld)
+    {
+        std::sort(toWeld.begin(), toWeld.end(), [] (const t_tileMeshPtr& left, const t_tileMeshPtr& right) {return *left < *right;});
+
+        t_meshPtr result(new mesh());
+        int32 numVertices(0);
+        int32 numIndices(0);
+        for (const t_tileMeshPtr& work : toWeld)
+        {
+            numVertices += work->positions.size();
+            numIndices += work->indices.size();
+        }
+        hashMap<uint64, uint32> welded(numVertices);
+        result->positions.reserve(numVertices);
+        result->normals.reserve(numVertices);
+        result->vertexIds.reserve(numVertices);
+        result->indices.reserve(numIndices);
+
+        vector<uint32> global;
+        for (const t_tileMeshPtr& work : toWeld)
+        {
+            global.resize(work->positions.size());
+            for (uint32 index = 0; index < work->positions.size(); ++index)
+            {
+                const uint64& vertexId(work->vertexIds[index]);
+                const typename hashMap<uint64, uint32>::const_iterator it(welded.find(vertexId));
+                if (it != welded.cend())
+                {
+                    global[index] = it->second;
+                    continue;
+                }
+                global[index] = result->positions.size();
+                welded.insert(vertexId, global[index]);
+                result->positions.push_back(work->positions[index]);
+                result->normals.push_back(work->normals[index]);
+                result->vertexIds.push_back(vertexId);
+            }
+            for (uint32 index = 0; index < work->indices.size(); index += 3)
+            {
+                const uint32 index0(global[work->indices[index]]);
+                const uint32 index1(global[work->indices[index+1]]);
+                const uint32 index2(global[work->indices[index+2]]);
+                if (index0 == index1 || index0 == index2 || index1 == index2)
+                {
+                    continue; // welded to zero space
+                }
+                result->indices.push_back(index0);
+                result->indices.push_back(index1);
+                result->indices.push_back(index2);
+            }
+        }
+
+        m_master.post(boost::bind(&meshExport::exportDoneMaster, this, result));
+    }
+
+    /**
+     * @brief exportDoneMaster calls signalExportDone().
+     * @param result
+     */
+    void exportDoneMaster(t_meshPtr result)
+    {
+        m_exporting = false;
+        m_sigExportDone(result);
+    }
+
+protected:
+    async::dispatcher& m_worker;
+    async::strand m_master;
+    t_surface& m_surface;
+
+    bool m_exporting;
+    int32 m_numTilesLeft;
+    t_tileMeshes m_tileMeshes;
+
+    t_sigExportDone m_sigExportDone;
+
+};
+
+
+}
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_SIMPLE_UTILS_MESHEXPORT_HPP
@@ -35,15 +35,22 @@ public:
      * @param worker May get called by multiple threads.
      * @param voxels The voxel-container to get the data from and to sync with.
      * @param numLod Count of level of details.
+     * @param cacheLodZero If false no accessor gets created for lod 0 and getLod(0) returns nullptr.
+     * terrain::surface then calculates lod 0 directly on the container, see tile::haloView. Keep it true if lod 0 gets synced.
      */
     accessor(blub::async::dispatcher &worker,
              t_simpleContainer &voxels,
-             const uint32& numLod)
+             const uint32& numLod,
+             const bool& cacheLodZero = true)
         : m_voxels(voxels)
     {
         for (uint32 indLod = 0; indLod < numLod; ++indLod)
         {
-            t_simple* lod = new t_simple(worker, voxels, indLod);
+            t_simple* lod(nullptr);
+            if (indLod > 0 || cacheLodZero)
+            {
+                lod = new t_simple(worker, voxels, indLod);
+            }
             t_base::m_lods.emplace_back(lod);
         }
     }
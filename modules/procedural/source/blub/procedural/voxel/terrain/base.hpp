@@ -34,6 +34,8 @@ public:
     typedef t_simple* t_lod;
     typedef vector<scopedPointer<t_simple> > t_lodList;
     typedef typename t_simple::t_createTileCallback t_createTileCallback;
+    typedef typename t_simple::t_tilePriorityCallback t_tilePriorityCallback;
+    typedef std::function<t_tilePriorityCallback (const int32& lod)> t_createTilePriorityCallback;
 
     /**
      * @brief base contructor
@@ -47,7 +49,7 @@ public:
     /**
      * @brief getLod returns a level of detail.
      * @param lod Lod-index starting with zero.
-     * @return
+     * @return May be nullptr for lod 0 of terrain::accessor, see its constructor.
      */
     t_lod getLod(const uint16& lod) const;
     /**
@@ -68,6 +70,14 @@ public:
      */
     void setCreateTileCallback(const t_createTileCallback &toSet);
 
+    /**
+     * @brief setTilePriorityCallback sets a priority-callback to every lod.
+     * @param toSet Gets called for every lod with its lod-index. Returns the callback for the lod.
+     * @see simple::base::setTilePriorityCallback()
+     * @see cameraPriority::createCallback()
+     */
+    void setTilePriorityCallback(const t_createTilePriorityCallback &toSet);
+
 protected:
 
 
@@ -114,7 +124,22 @@ void base<tileType>::setCreateTileCallback(const t_createTileCallback &toSet)
 {
     for (typename t_lodList::value_type &lod : m_lods)
     {
-        lod->setCreateTileCallback(toSet);
+        if (lod.get() != nullptr)
+        {
+            lod->setCreateTileCallback(toSet);
+        }
+    }
+}
+
+template <class tileType>
+void base<tileType>::setTilePriorityCallback(const t_createTilePriorityCallback &toSet)
+{
+    for (int32 indLod = 0; indLod < getNumLod(); ++indLod)
+    {
+        if (m_lods[indLod].get() != nullptr)
+        {
+            m_lods[indLod]->setTilePriorityCallback(toSet(indLod));
+        }
     }
 }
 
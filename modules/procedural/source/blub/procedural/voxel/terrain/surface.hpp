@@ -29,10 +29,13 @@ public:
     typedef base<t_simple> t_base;
 
     typedef typename t_config::t_accessor::t_terrain t_terrainAccessor;
+    typedef typename t_simple::t_normalMode t_normalMode;
+    typedef typename t_simple::t_vertexFormat t_vertexFormat;
 
 
     /**
      * @brief surface construtor. Creates as much lods as in voxels.
+     * If voxels has no lod 0 lod 0 gets calculated directly on the container.
      * @param worker may get called by multiple threads.
      * @param voxels The accessor to sync with.
      */
@@ -41,6 +44,12 @@ public:
         for (int32 lod = 0; lod < voxels.getNumLod(); ++lod)
         {
             typename t_terrainAccessor::t_lod accessorTiles(voxels.getLod(lod));
+            if (accessorTiles == nullptr)
+            {
+                BASSERT(lod == 0);
+                t_base::m_lods.emplace_back(new t_lod(worker, voxels.getVoxelContainer()));
+                continue;
+            }
             t_lodPtr newLod(new t_lod(worker, *accessorTiles, lod));
 
             t_base::m_lods.emplace_back(newLod);
@@ -54,6 +63,44 @@ public:
     {
     }
 
+    /**
+     * @brief setNormalMode sets the normal-mode of every lod. Call before the first edit.
+     * @param toSet
+     * @see simple::surface::setNormalMode()
+     */
+    void setNormalMode(const t_normalMode& toSet)
+    {
+        for (typename t_base::t_lodList::value_type &lod : t_base::m_lods)
+        {
+            lod->setNormalMode(toSet);
+        }
+    }
+    /**
+     * @brief setVertexFormat sets the vertex-format of every lod. Call before the first edit.
+     * @param toSet
+     * @see simple::surface::setVertexFormat()
+     */
+    void setVertexFormat(const t_vertexFormat& toSet)
+    {
+        for (typename t_base::t_lodList::value_type &lod : t_base::m_lods)
+        {
+            lod->setVertexFormat(toSet);
+        }
+    }
+    /**
+     * @brief setDecimation sets the error-budget of the lods from lodStart on and turns decimation off for the finer ones. Call before the first edit.
+     * @param toSet Maximal error in voxel of each lod, so the absolute error doubles with every lod.
+     * @param lodStart First decimated lod.
+     * @see simple::surface::setDecimation()
+     */
+    void setDecimation(const real& toSet, const int32& lodStart)
+    {
+        for (int32 lod = 0; lod < static_cast<int32>(t_base::m_lods.size()); ++lod)
+        {
+            t_base::m_lods[lod]->setDecimation(lod < lodStart ? 0. : toSet);
+        }
+    }
+
 private:
 
 
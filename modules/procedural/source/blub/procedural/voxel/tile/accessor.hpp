@@ -3,7 +3,8 @@
 
 #include "blub/core/array.hpp"
 #include "blub/core/globals.hpp"
-#include "blub/core/scopedPtr.hpp"
+#include "blub/core/sharedPointer.hpp"
+#include "blub/math/axisAlignedBoxInt32.hpp"
 #include "blub/math/vector2int.hpp"
 #include "blub/math/vector3int.hpp"
 #include "blub/serialization/access.hpp"
@@ -55,6 +56,7 @@ public:
 
     typedef vector<t_voxel> t_voxelArray;
     typedef vector<t_voxel> t_voxelArrayLod;
+    typedef sharedPointer<const t_voxelArrayLod> t_voxelArrayLodConstPtr;
 
     /**
      * @brief create creates an instance.
@@ -91,18 +93,50 @@ public:
         BASSERT(pos.y < voxelLengthWithNormalCorrection-1);
         BASSERT(pos.z < voxelLengthWithNormalCorrection-1);
 
-        if (toSet.getInterpolation() >= 0 && pos >= vector3int32(0) && pos < vector3int32(voxelLengthSurface))
-        {
-            ++m_numVoxelLargerZero;
-        }
-
         const int32 index((pos.x+1)*voxelLengthWithNormalCorrection*voxelLengthWithNormalCorrection + (pos.y+1)*voxelLengthWithNormalCorrection + pos.z+1);
         const t_voxel oldValue(m_voxels[index]);
+        if (pos >= vector3int32(0) && pos < vector3int32(voxelLengthSurface))
+        {
+            m_numVoxelLargerZero += (toSet.getInterpolation() >= 0) - (oldValue.getInterpolation() >= 0);
+        }
         m_voxels[index] = toSet;
 
         return oldValue != toSet;
     }
 
+    /**
+     * @brief setVoxelRow sets count voxel along the z-axis, beginning at pos. A lot faster than calling setVoxel() for every voxel.
+     * @param pos -1 <= pos.xyz < voxelLengthWithNormalCorrection-1
+     * @param toSet Array of count voxel.
+     * @param count pos.z + count <= voxelLengthWithNormalCorrection-1
+     * @return returns true if anything changed.
+     */
+    bool setVoxelRow(const vector3int32& pos, const t_voxel* toSet, const int32& count)
+    {
+        BASSERT(pos.x >= -1);
+        BASSERT(pos.y >= -1);
+        BASSERT(pos.z >= -1);
+        BASSERT(pos.x < voxelLengthWithNormalCorrection-1);
+        BASSERT(pos.y < voxelLengthWithNormalCorrection-1);
+        BASSERT(pos.z + count <= voxelLengthWithNormalCorrection-1);
+
+        t_voxel* row(&m_voxels[(pos.x+1)*voxelLengthWithNormalCorrection*voxelLengthWithNormalCorrection + (pos.y+1)*voxelLengthWithNormalCorrection + pos.z+1]);
+        const bool inSurface(pos.x >= 0 && pos.y >= 0 && pos.x < voxelLengthSurface && pos.y < voxelLengthSurface);
+
+        bool result(false);
+        for (int32 ind = 0; ind < count; ++ind)
+        {
+            const int32 posZ(pos.z + ind);
+            if (inSurface && posZ >= 0 && posZ < voxelLengthSurface)
+            {
+                m_numVoxelLargerZero += (toSet[ind].getInterpolation() >= 0) - (row[ind].getInterpolation() >= 0);
+            }
+            result |= row[ind] != toSet[ind];
+            row[ind] = toSet[ind];
+        }
+        return result;
+    }
+
     /**
      * @brief setVoxelLod sets a voxel to a lod array.
      * @param pos
@@ -144,6 +178,18 @@ public:
     {
         return getVoxelLod(calculateCoordsLod(pos, lod), lod);
     }
+    /**
+     * @brief calculateIndexLod returns the index of a lod-voxel in getVoxelArrayLod().
+     * @param pos
+     * @param lod level of detail index
+     * @return
+     * @see getVoxelLod()
+     */
+    static int32 calculateIndexLod(const vector3int32& pos, const int32& lod)
+    {
+        const vector2int32 index(calculateCoordsLod(pos, lod));
+        return lod*voxelCountLod + index.x*voxelLengthLod + index.y;
+    }
 
     /**
      * @brief isEmpty returns true if all voxel are minimum.
@@ -225,8 +271,19 @@ public:
      */
     t_voxelArrayLod* getVoxelArrayLod()
     {
+        detachVoxelArrayLod();
         return m_voxelsLod.get();
     }
+    /**
+     * @brief getVoxelArrayLodShared returns the 6-lod-arrays without copying them. Later changes of this tile copy the arrays before writing,
+     * so the returned arrays never change. tile::surface keeps them to calculate the transvoxel-faces on demand.
+     * The arrays get gathered eagerly with the other voxel, because reading the container needs the read-lock held during the accessor-job.
+     * @return nullptr if no lod shall get calculated.
+     */
+    t_voxelArrayLodConstPtr getVoxelArrayLodShared() const
+    {
+        return m_voxelsLod;
+    }
 
     /**
      * @brief setCalculateLod enables or disables lod calculation and voxel buffering for it.
@@ -244,7 +301,7 @@ public:
         if (m_calculateLod)
         {
             BASSERT(m_voxelsLod == nullptr);
-            m_voxelsLod.reset(new t_voxelArrayLod(6*voxelCountLod)); // [6*voxelCountLod]
+            m_voxelsLod = t_voxelArrayLodPtr(new t_voxelArrayLod(6*voxelCountLod)); // [6*voxelCountLod]
         }
         else
         {
@@ -252,6 +309,25 @@ public:
         }
     }
 
+    /**
+     * @brief getChangedVoxelBoundingBox returns the bounds of the voxel that changed by the last calculation of simple::accessor.
+     * Lod-voxel changes are included, converted to voxel-coordinates.
+     * @return -1 <= xyz < voxelLengthWithNormalCorrection-1. May be invalid if nothing changed.
+     */
+    const axisAlignedBoxInt32& getChangedVoxelBoundingBox() const
+    {
+        return m_changedVoxelBoundingBox;
+    }
+    /**
+     * @brief setChangedVoxelBoundingBox gets set by simple::accessor after every calculation.
+     * @param toSet
+     * @see getChangedVoxelBoundingBox()
+     */
+    void setChangedVoxelBoundingBox(const axisAlignedBoxInt32& toSet)
+    {
+        m_changedVoxelBoundingBox = toSet;
+    }
+
     /**
      * @brief setNumVoxelLargerZero internally used for extern sync. (optimisation)
      * @param toSet
@@ -275,7 +351,6 @@ protected:
      */
     accessor()
         : m_voxels(voxelCount)
-        , m_voxelsLod(nullptr)
         , m_calculateLod(false)
         , m_numVoxelLargerZero(0)
         , m_numVoxelLargerZeroLod(0)
@@ -292,16 +367,24 @@ protected:
         BASSERT(m_calculateLod);
         BASSERT(m_voxelsLod.get() != nullptr);
 
-        if (toSet.getInterpolation() >= 0)
-        {
-            ++m_numVoxelLargerZeroLod;
-        }
         const uint32 index_(lod*voxelCountLod + index.x*voxelLengthLod + index.y);
+        detachVoxelArrayLod();
         const t_voxel oldValue((*m_voxelsLod)[index_]);
+        m_numVoxelLargerZeroLod += (toSet.getInterpolation() >= 0) - (oldValue.getInterpolation() >= 0);
         (*m_voxelsLod)[index_] = toSet;
 
         return oldValue != toSet;
     }
+    /**
+     * @brief detachVoxelArrayLod copies the lod-arrays if a tile::surface still holds them, see getVoxelArrayLodShared().
+     */
+    void detachVoxelArrayLod()
+    {
+        if (!m_voxelsLod.isNull() && m_voxelsLod.use_count() > 1)
+        {
+            m_voxelsLod = t_voxelArrayLodPtr(new t_voxelArrayLod(*m_voxelsLod));
+        }
+    }
     /**
      * @see getVoxelLod()
      */
@@ -399,12 +482,15 @@ private:
 
 private:
     t_voxelArray m_voxels;
-    blub::scopedPointer<t_voxelArrayLod> m_voxelsLod;
+    typedef sharedPointer<t_voxelArrayLod> t_voxelArrayLodPtr;
+
+    t_voxelArrayLodPtr m_voxelsLod;
 
     bool m_calculateLod;
     int32 m_numVoxelLargerZero;
     int32 m_numVoxelLargerZeroLod;
 
+    axisAlignedBoxInt32 m_changedVoxelBoundingBox;
 
 };
 
@@ -133,6 +133,69 @@ public:
         }
     }
 
+    /**
+     * @brief setVoxelRow sets count voxel along the z-axis, beginning at pos. Faster than calling setVoxel() for every voxel.
+     * Extends changed axisAlignedBox-bounds once by the first and last changed voxel.
+     * @param pos Local position of the first voxel.
+     * @param toSet Array of count voxel.
+     * @param count pos.z + count <= voxelLength
+     */
+    void setVoxelRow(const vector3int32& pos, const t_data* toSet, const int32& count)
+    {
+        BASSERT(pos.z >= 0);
+        BASSERT(pos.z + count <= voxelLength);
+
+        const int32 indexStart(calculateIndex(pos));
+        int32 firstChanged(-1);
+        int32 lastChanged(-1);
+        for (int32 ind = 0; ind < count; ++ind)
+        {
+            if (setVoxel(indexStart + ind, toSet[ind]))
+            {
+                if (firstChanged == -1)
+                {
+                    firstChanged = ind;
+                }
+                lastChanged = ind;
+            }
+        }
+        if (firstChanged != -1)
+        {
+            m_changedVoxelBoundingBox.extend(pos + vector3int32(0, 0, firstChanged));
+            m_changedVoxelBoundingBox.extend(pos + vector3int32(0, 0, lastChanged));
+        }
+    }
+
+    /**
+     * @brief copyVoxels replaces all voxel by the ones of other. A lot faster than calling setVoxel() for every voxel.
+     * Extends the changed axisAlignedBox-bounds to the whole tile if a voxel changed.
+     * @param other The tile to copy from.
+     */
+    void copyVoxels(const container& other)
+    {
+        BASSERT(m_editing);
+
+        if (m_voxels == other.getVoxelArray())
+        {
+            return;
+        }
+        *this = other;
+        m_changedVoxelBoundingBox.extend(vector3int32(0));
+        m_changedVoxelBoundingBox.extend(vector3int32(voxelLength-1));
+    }
+
+    /**
+     * @brief extendEditedVoxelBoundingBoxToTile marks all voxel as changed. Call it if the tile replaces a tile with unknown content.
+     * @see getEditedVoxelBoundingBox()
+     */
+    void extendEditedVoxelBoundingBoxToTile()
+    {
+        BASSERT(m_editing);
+
+        m_changedVoxelBoundingBox.extend(vector3int32(0));
+        m_changedVoxelBoundingBox.extend(vector3int32(voxelLength-1));
+    }
+
     /**
      * @brief setFull sets all voxel to max.
      * @see procedural::voxel::data::setMax()
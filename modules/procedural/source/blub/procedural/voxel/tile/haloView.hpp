@@ -0,0 +1,189 @@
+#ifndef PROCEDURAL_VOXEL_TILE_HALOVIEW_HPP
+#define PROCEDURAL_VOXEL_TILE_HALOVIEW_HPP
+
+#include "blub/core/array.hpp"
+#include "blub/core/globals.hpp"
+#include "blub/core/noncopyable.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/predecl.hpp"
+#include "blub/procedural/voxel/simple/container/utils/tile.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace tile
+{
+
+
+/**
+ * @brief The haloView class gives tile::surface read access to the voxel of a container-tile and the one voxel wide halo around it, without copying.
+ * It borrows the container-tile and its 26 neighbours and resolves every voxel-position from -1 to voxelLength+1 to the tile that owns it.
+ * Full and empty neighbours get answered by a single voxel, so no data is needed for them.
+ * Replaces tile::accessor for lod 0, where no transvoxel-faces are needed. Read-lock the container as long as the view is in use.
+ */
+template <class configType>
+class haloView : public noncopyable
+{
+public:
+    typedef configType t_config;
+    typedef typename t_config::t_data t_voxel;
+    typedef typename t_config::t_container::t_tile t_tileContainer;
+    typedef simple::container::utils::tile<t_tileContainer> t_tileHolder;
+    typedef simple::container::utils::tileState t_tileState;
+
+#if defined(BOOST_NO_CXX11_CONSTEXPR)
+    static const int32 voxelLength;
+    static const int32 voxelLengthWithNormalCorrection;
+#else
+    static constexpr int32 voxelLength = t_config::voxelsPerTile;
+    static constexpr int32 voxelLengthWithNormalCorrection = voxelLength+3;
+#endif
+
+    /**
+     * @brief haloView constructor. All 27 tiles are empty until set by setTile().
+     */
+    haloView()
+    {
+        m_voxelMin.setMin();
+        m_voxelMax.setMax();
+
+        for (int32 ind = 0; ind < voxelLengthWithNormalCorrection; ++ind)
+        {
+            const int32 pos(ind-1);
+            int32 tile(1);
+            if (pos < 0)
+            {
+                tile = 0;
+            }
+            else if (pos >= voxelLength)
+            {
+                tile = 2;
+            }
+            m_axisTile[ind] = tile;
+            m_axisPosInTile[ind] = pos - (tile-1)*voxelLength;
+        }
+
+        for (int32 ind = 0; ind < 3*3*3; ++ind)
+        {
+            setSource(ind, t_tileHolder());
+        }
+    }
+
+    /**
+     * @brief setTile borrows a container-tile.
+     * @param offset Position relative to the center-tile. Every component from -1 to 1.
+     * @param holder The container-tile. Gets held until the view gets destroyed.
+     */
+    void setTile(const vector3int32& offset, const t_tileHolder& holder)
+    {
+        BASSERT(offset >= vector3int32(-1));
+        BASSERT(offset <= vector3int32(1));
+
+        setSource(((offset.x+1)*3 + offset.y+1)*3 + offset.z+1, holder);
+    }
+
+    /**
+     * @brief isUniform returns true if all tiles are full or all tiles are empty, so no surface can be inside.
+     * @return
+     */
+    bool isUniform() const
+    {
+        const t_tileState state(m_holders[0].state);
+        if (state == t_tileState::partitial)
+        {
+            return false;
+        }
+        for (const t_tileHolder& holder : m_holders)
+        {
+            if (holder.state != state)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief getVoxel returns a voxel. Same coordinates like tile::accessor::getVoxel().
+     * @param pos Every component from -1 to voxelLength+1.
+     * @return
+     */
+    const t_voxel& getVoxel(const vector3int32& pos) const
+    {
+        BASSERT(pos >= vector3int32(-1));
+        BASSERT(pos < vector3int32(voxelLengthWithNormalCorrection-1));
+
+        const vector3int32 ind(pos + vector3int32(1));
+        const source& from(m_sources[(m_axisTile[ind.x]*3 + m_axisTile[ind.y])*3 + m_axisTile[ind.z]]);
+
+        return from.data[m_axisPosInTile[ind.x]*from.stride.x +
+                         m_axisPosInTile[ind.y]*from.stride.y +
+                         m_axisPosInTile[ind.z]*from.stride.z];
+    }
+
+protected:
+    /**
+     * @brief The source struct points to the voxel of a tile. Full and empty tiles have a stride of zero and point to a single voxel.
+     */
+    struct source
+    {
+        const t_voxel* data;
+        vector3int32 stride;
+    };
+
+    void setSource(const int32& index, const t_tileHolder& holder)
+    {
+        m_holders[index] = holder;
+
+        source& result(m_sources[index]);
+        switch (holder.state)
+        {
+        case t_tileState::partitial:
+            BASSERT(!holder.data.isNull());
+            result.data = &holder.data->getVoxelArray()[0];
+            result.stride = vector3int32(voxelLength*voxelLength, voxelLength, 1);
+            break;
+        case t_tileState::full:
+            result.data = &m_voxelMax;
+            result.stride = vector3int32(0);
+            break;
+        case t_tileState::empty:
+            result.data = &m_voxelMin;
+            result.stride = vector3int32(0);
+            break;
+        default:
+            BASSERT(false);
+        }
+    }
+
+    array<t_tileHolder, 3*3*3> m_holders;
+    array<source, 3*3*3> m_sources;
+
+    array<int32, t_config::voxelsPerTile+3> m_axisTile;
+    array<int32, t_config::voxelsPerTile+3> m_axisPosInTile;
+
+    t_voxel m_voxelMin;
+    t_voxel m_voxelMax;
+
+};
+
+#if defined(BOOST_NO_CXX11_CONSTEXPR)
+template <class voxelType> const int32 haloView<voxelType>::voxelLength = t_config::voxelsPerTile;
+template <class voxelType> const int32 haloView<voxelType>::voxelLengthWithNormalCorrection = voxelLength+3;
+#else
+template <class voxelType> constexpr int32 haloView<voxelType>::voxelLength;
+template <class voxelType> constexpr int32 haloView<voxelType>::voxelLengthWithNormalCorrection;
+#endif
+
+
+}
+}
+}
+}
+
+
+#endif // PROCEDURAL_VOXEL_TILE_HALOVIEW_HPP
@@ -0,0 +1,536 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_TILE_INTERNAL_MESHDECIMATOR_HPP
+#define BLUB_PROCEDURAL_VOXEL_TILE_INTERNAL_MESHDECIMATOR_HPP
+
+#include "blub/core/globals.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/vector3.hpp"
+
+#include <algorithm>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace tile
+{
+namespace internal
+{
+
+
+/**
+ * @brief The meshDecimator class reduces the triangles of a mesh by quadric error metric edge collapses (Garland and Heckbert).
+ * It collapses half-edges: a vertex moves onto one of its neighbours, so the remaining vertices keep their position and attributes.
+ * The error of a collapse is the area-weighted mean squared distance to the planes of the original triangles around both vertices,
+ * additionally the moved vertex must stay near the new triangles.
+ * Vertices on open or non-manifold edges never move, neither do the ones marked as locked nor vertices at the same position as another one and their neighbours.
+ * Keeps its buffers between calls, so use one instance per thread.
+ */
+class meshDecimator
+{
+public:
+    meshDecimator()
+    {
+        ;
+    }
+
+    /**
+     * @brief decimate collapses edges as long as the error stays below maxError. Removes the collapsed triangles from indices.
+     * The vertices don't change, the ones no triangle uses anymore stay in the list.
+     * @param vertices Anything with the members position and normal.
+     * @param indices Three per triangle.
+     * @param locked One per vertex, vertices with a value other than 0 never move.
+     * @param maxError Maximal mean distance to the original surface.
+     */
+    template <typename vertexType, typename indexType>
+    void decimate(const vector<vertexType>& vertices, vector<indexType>& indices, const vector<uint8>& locked, const real& maxError)
+    {
+        BASSERT(locked.size() == vertices.size());
+        const int32 numVertices(vertices.size());
+        const double maxErrorSquared(static_cast<double>(maxError)*maxError);
+
+        m_quadrics.assign(numVertices, quadric());
+        for (int32 ind = 0; ind < static_cast<int32>(indices.size()); ind += 3)
+        {
+            const vector3& position0(vertices[indices[ind]].position);
+            const vector3 normal((vertices[indices[ind+1]].position - position0).crossProduct(vertices[indices[ind+2]].position - position0));
+            const real area(normal.length());
+            if (area <= 0.)
+            {
+                continue;
+            }
+            const quadric plane(normal / area, position0, area*0.5);
+            for (int32 corner = 0; corner < 3; ++corner)
+            {
+                m_quadrics[indices[ind+corner]] += plane;
+            }
+        }
+
+        m_locked.assign(locked.begin(), locked.end());
+        m_collapseTo.resize(numVertices);
+        for (int32 pass = 0; ; ++pass)
+        {
+            calculateAdjacency(indices, numVertices);
+            if (pass == 0)
+            {
+                lockOpenEdges(indices, numVertices);
+                lockCoincidentVertices(vertices, indices);
+            }
+            calculateCollapses(vertices, indices, maxErrorSquared);
+
+            // collapse greedy by error; every vertex takes part in one collapse per pass, so the adjacency stays valid
+            m_touched.assign(numVertices, 0);
+            for (int32 vertex = 0; vertex < numVertices; ++vertex)
+            {
+                m_collapseTo[vertex] = vertex;
+            }
+            int32 numCollapsed(0);
+            for (const collapse& work : m_collapses)
+            {
+                if (m_touched[work.from] != 0 || m_touched[work.to] != 0)
+                {
+                    continue;
+                }
+                if (!isCollapseValid(vertices, indices, work.from, work.to, maxError))
+                {
+                    continue;
+                }
+                m_collapseTo[work.from] = work.to;
+                m_quadrics[work.to] += m_quadrics[work.from];
+                touchNeighbours(indices, work.from);
+                touchNeighbours(indices, work.to);
+                ++numCollapsed;
+            }
+            if (numCollapsed == 0)
+            {
+                break;
+            }
+
+            // remove the triangles that lost their area
+            const int32 numTriangles(indices.size()/3);
+            int32 numIndices(0);
+            for (int32 ind = 0; ind < static_cast<int32>(indices.size()); ind += 3)
+            {
+                const int32 index0(m_collapseTo[indices[ind]]);
+                const int32 index1(m_collapseTo[indices[ind+1]]);
+                const int32 index2(m_collapseTo[indices[ind+2]]);
+                if (index0 == index1 || index0 == index2 || index1 == index2)
+                {
+                    continue;
+                }
+                indices[numIndices++] = index0;
+                indices[numIndices++] = index1;
+                indices[numIndices++] = index2;
+            }
+            indices.resize(numIndices);
+
+            // the last passes find only a few collapses, they aren't worth their time
+            if (numCollapsed*minCollapsesPerPass < numTriangles)
+            {
+                break;
+            }
+        }
+    }
+
+protected:
+    /// a pass must collapse at least 1 of minCollapsesPerPass triangles, else decimation ends after it
+    static const int32 minCollapsesPerPass = 64;
+
+    /**
+     * @brief The quadric struct is the symmetric 4x4 matrix of the summed squared distances to planes, and the summed area of the planes.
+     */
+    struct quadric
+    {
+        quadric()
+        {
+            std::fill(matrix, matrix + 10, 0.);
+            area = 0.;
+        }
+        quadric(const vector3& normal, const vector3& position, const real& weight)
+        {
+            const double nx(normal.x), ny(normal.y), nz(normal.z);
+            const double distance(-normal.dotProduct(position));
+            const double values[] = {nx*nx, nx*ny, nx*nz, nx*distance,
+                                            ny*ny, ny*nz, ny*distance,
+                                                   nz*nz, nz*distance,
+                                                          distance*distance};
+            for (int32 ind = 0; ind < 10; ++ind)
+            {
+                matrix[ind] = values[ind]*weight;
+            }
+            area = weight;
+        }
+        quadric& operator += (const quadric& other)
+        {
+            for (int32 ind = 0; ind < 10; ++ind)
+            {
+                matrix[ind] += other.matrix[ind];
+            }
+            area += other.area;
+            return *this;
+        }
+        /**
+         * @brief calculateError returns the area-weighted mean squared distance of position to the planes.
+         */
+        double calculateError(const vector3& position) const
+        {
+            if (area <= 0.)
+            {
+                return 0.;
+            }
+            const double x(position.x), y(position.y), z(position.z);
+            const double error(matrix[0]*x*x + 2.*matrix[1]*x*y + 2.*matrix[2]*x*z + 2.*matrix[3]*x
+                                             +    matrix[4]*y*y + 2.*matrix[5]*y*z + 2.*matrix[6]*y
+                                                                +    matrix[7]*z*z + 2.*matrix[8]*z
+                                                                                   +    matrix[9]);
+            return std::max(error, 0.) / area;
+        }
+
+        double matrix[10];
+        double area;
+    };
+
+    /**
+     * @brief The collapse struct moves vertex from onto vertex to.
+     */
+    struct collapse
+    {
+        int32 from;
+        int32 to;
+        double error;
+
+        bool operator < (const collapse& other) const
+        {
+            return error < other.error;
+        }
+    };
+
+    /**
+     * @brief lockCoincidentVertices locks vertices that share their position, like marching cubes creates them on a voxel with the value 0, and their neighbours.
+     * The mesh is not connected there, so a collapse could connect both sides or fold the surface onto itself without being noticed by isCollapseValid().
+     */
+    template <typename vertexType, typename indexType>
+    void lockCoincidentVertices(const vector<vertexType>& vertices, const vector<indexType>& indices)
+    {
+        m_sorted.resize(vertices.size());
+        for (int32 vertex = 0; vertex < static_cast<int32>(vertices.size()); ++vertex)
+        {
+            m_sorted[vertex] = vertex;
+        }
+        const auto isLess = [&vertices] (const int32& left, const int32& right)
+        {
+            const vector3& positionLeft(vertices[left].position);
+            const vector3& positionRight(vertices[right].position);
+            if (positionLeft.x != positionRight.x)
+            {
+                return positionLeft.x < positionRight.x;
+            }
+            if (positionLeft.y != positionRight.y)
+            {
+                return positionLeft.y < positionRight.y;
+            }
+            return positionLeft.z < positionRight.z;
+        };
+        std::sort(m_sorted.begin(), m_sorted.end(), isLess);
+        m_touched.assign(vertices.size(), 0);
+        for (int32 ind = 1; ind < static_cast<int32>(m_sorted.size()); ++ind)
+        {
+            if (vertices[m_sorted[ind-1]].position == vertices[m_sorted[ind]].position)
+            {
+                touchNeighbours(indices, m_sorted[ind-1]);
+                touchNeighbours(indices, m_sorted[ind]);
+            }
+        }
+        for (int32 vertex = 0; vertex < static_cast<int32>(vertices.size()); ++vertex)
+        {
+            if (m_touched[vertex] != 0)
+            {
+                m_locked[vertex] = 1;
+            }
+        }
+    }
+
+    template <typename indexType>
+    void calculateAdjacency(const vector<indexType>& indices, const int32& numVertices)
+    {
+        m_vertexTrianglesOffset.assign(numVertices+1, 0);
+        for (const indexType& index : indices)
+        {
+            ++m_vertexTrianglesOffset[index+1];
+        }
+        for (int32 vertex = 0; vertex < numVertices; ++vertex)
+        {
+            m_vertexTrianglesOffset[vertex+1] += m_vertexTrianglesOffset[vertex];
+        }
+        m_vertexTriangles.resize(indices.size());
+        m_fill.assign(m_vertexTrianglesOffset.begin(), m_vertexTrianglesOffset.end()-1);
+        for (int32 ind = 0; ind < static_cast<int32>(indices.size()); ++ind)
+        {
+            m_vertexTriangles[m_fill[indices[ind]]++] = ind/3;
+        }
+    }
+
+    /**
+     * @brief lockOpenEdges locks the vertices of edges that don't have exactly two triangles. Counts edge (a, b) by the triangles around a.
+     */
+    template <typename indexType>
+    void lockOpenEdges(const vector<indexType>& indices, const int32& numVertices)
+    {
+        for (int32 vertex = 0; vertex < numVertices; ++vertex)
+        {
+            m_neighbours.clear();
+            for (int32 ind = m_vertexTrianglesOffset[vertex]; ind < m_vertexTrianglesOffset[vertex+1]; ++ind)
+            {
+                const int32 triangle(m_vertexTriangles[ind]);
+                for (int32 corner = 0; corner < 3; ++corner)
+                {
+                    const int32 neighbour(indices[triangle*3 + corner]);
+                    if (neighbour != vertex)
+                    {
+                        m_neighbours.push_back(neighbour);
+                    }
+                }
+            }
+            std::sort(m_neighbours.begin(), m_neighbours.end());
+            for (vector<int32>::const_iterator it = m_neighbours.cbegin(); it != m_neighbours.cend(); )
+            {
+                const vector<int32>::const_iterator next(std::upper_bound(it, m_neighbours.cend(), *it));
+                if (next - it != 2)
+                {
+                    m_locked[vertex] = 1;
+                    m_locked[*it] = 1;
+                }
+                it = next;
+            }
+        }
+    }
+
+    template <typename vertexType, typename indexType>
+    void calculateCollapses(const vector<vertexType>& vertices, const vector<indexType>& indices, const double& maxErrorSquared)
+    {
+        m_collapses.clear();
+        for (int32 ind = 0; ind < static_cast<int32>(indices.size()); ++ind)
+        {
+            const int32 from(indices[ind]);
+            const int32 to(indices[ind - ind%3 + (ind+1)%3]);
+            // both directions of an inner edge get found, by its two triangles
+            if (m_locked[from] != 0)
+            {
+                continue;
+            }
+            quadric sum(m_quadrics[from]);
+            sum += m_quadrics[to];
+            collapse toAdd;
+            toAdd.from = from;
+            toAdd.to = to;
+            toAdd.error = sum.calculateError(vertices[to].position);
+            if (toAdd.error <= maxErrorSquared)
+            {
+                m_collapses.push_back(toAdd);
+            }
+        }
+        std::sort(m_collapses.begin(), m_collapses.end());
+    }
+
+    /**
+     * @brief isCollapseValid checks that no triangle flips or degenerates and that the mesh stays manifold.
+     */
+    template <typename vertexType, typename indexType>
+    bool isCollapseValid(const vector<vertexType>& vertices, const vector<indexType>& indices, const int32& from, const int32& to, const real& maxError)
+    {
+        // link condition: an inner edge has exactly two common neighbours
+        m_neighbours.clear();
+        for (int32 ind = m_vertexTrianglesOffset[from]; ind < m_vertexTrianglesOffset[from+1]; ++ind)
+        {
+            const int32 triangle(m_vertexTriangles[ind]);
+            for (int32 corner = 0; corner < 3; ++corner)
+            {
+                m_neighbours.push_back(indices[triangle*3 + corner]);
+            }
+        }
+        std::sort(m_neighbours.begin(), m_neighbours.end());
+        m_neighbours.erase(std::unique(m_neighbours.begin(), m_neighbours.end()), m_neighbours.end());
+        int32 numCommon(0);
+        m_neighboursTo.clear();
+        for (int32 ind = m_vertexTrianglesOffset[to]; ind < m_vertexTrianglesOffset[to+1]; ++ind)
+        {
+            const int32 triangle(m_vertexTriangles[ind]);
+            for (int32 corner = 0; corner < 3; ++corner)
+            {
+                m_neighboursTo.push_back(indices[triangle*3 + corner]);
+            }
+        }
+        std::sort(m_neighboursTo.begin(), m_neighboursTo.end());
+        m_neighboursTo.erase(std::unique(m_neighboursTo.begin(), m_neighboursTo.end()), m_neighboursTo.end());
+        for (const int32& neighbour : m_neighboursTo)
+        {
+            if (neighbour != from && neighbour != to && std::binary_search(m_neighbours.cbegin(), m_neighbours.cend(), neighbour))
+            {
+                ++numCommon;
+            }
+        }
+        if (numCommon != 2)
+        {
+            return false;
+        }
+
+        // the triangles around from, that don't get removed, must keep their orientation
+        const vector3& positionFrom(vertices[from].position);
+        const vector3& positionTo(vertices[to].position);
+        real distance(maxError + 1.);
+        for (int32 ind = m_vertexTrianglesOffset[from]; ind < m_vertexTrianglesOffset[from+1]; ++ind)
+        {
+            const int32 triangle(m_vertexTriangles[ind]);
+            const int32 index0(indices[triangle*3]);
+            const int32 index1(indices[triangle*3+1]);
+            const int32 index2(indices[triangle*3+2]);
+            if (index0 == to || index1 == to || index2 == to)
+            {
+                continue;
+            }
+            const vector3 position[] = {vertices[index0].position, vertices[index1].position, vertices[index2].position};
+            const vector3 normalBefore((position[1] - position[0]).crossProduct(position[2] - position[0]));
+            vector3 moved[] = {position[0], position[1], position[2]};
+            moved[index0 == from ? 0 : (index1 == from ? 1 : 2)] = positionTo;
+            const vector3 normalAfter((moved[1] - moved[0]).crossProduct(moved[2] - moved[0]));
+            const real lengthAfter(normalAfter.length());
+            if (lengthAfter <= 0.)
+            {
+                return false;
+            }
+            // at most 60 degrees of rotation
+            if (normalBefore.dotProduct(normalAfter) < 0.5*normalBefore.length()*lengthAfter)
+            {
+                return false;
+            }
+            // the vertex-normals don't change, they must still fit to the triangle
+            const vector3 normalVertices(vertices[index0 == from ? to : index0].normal
+                                       + vertices[index1 == from ? to : index1].normal
+                                       + vertices[index2 == from ? to : index2].normal);
+            if (normalVertices.dotProduct(normalAfter) <= 0.)
+            {
+                return false;
+            }
+            // no triangle may exist twice, like when a tetrahedron collapses
+            const int32 other0(index0 == from ? index1 : index0);
+            const int32 other1(index2 == from ? index1 : index2);
+            if (hasTriangle(indices, to, other0, other1))
+            {
+                return false;
+            }
+            distance = std::min(distance, calculateDistance(positionFrom, moved[0], moved[1], moved[2]));
+        }
+        return distance <= maxError;
+    }
+
+    /**
+     * @brief hasTriangle returns true if a triangle of vertex contains other0 and other1.
+     */
+    template <typename indexType>
+    bool hasTriangle(const vector<indexType>& indices, const int32& vertex, const int32& other0, const int32& other1) const
+    {
+        for (int32 ind = m_vertexTrianglesOffset[vertex]; ind < m_vertexTrianglesOffset[vertex+1]; ++ind)
+        {
+            const int32 triangle(m_vertexTriangles[ind]);
+            int32 numFound(0);
+            for (int32 corner = 0; corner < 3; ++corner)
+            {
+                const int32 index(indices[triangle*3 + corner]);
+                if (index == other0 || index == other1)
+                {
+                    ++numFound;
+                }
+            }
+            if (numFound == 2)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    /**
+     * @brief calculateDistance returns the distance of position to the triangle (Ericson, "Real-Time Collision Detection", 5.1.5).
+     */
+    static real calculateDistance(const vector3& position, const vector3& corner0, const vector3& corner1, const vector3& corner2)
+    {
+        const vector3 edge01(corner1 - corner0);
+        const vector3 edge02(corner2 - corner0);
+        const vector3 toPosition0(position - corner0);
+        const real dot1(edge01.dotProduct(toPosition0));
+        const real dot2(edge02.dotProduct(toPosition0));
+        if (dot1 <= 0. && dot2 <= 0.)
+        {
+            return toPosition0.length();
+        }
+        const vector3 toPosition1(position - corner1);
+        const real dot3(edge01.dotProduct(toPosition1));
+        const real dot4(edge02.dotProduct(toPosition1));
+        if (dot3 >= 0. && dot4 <= dot3)
+        {
+            return toPosition1.length();
+        }
+        const real area2(dot1*dot4 - dot3*dot2);
+        if (area2 <= 0. && dot1 >= 0. && dot3 <= 0.)
+        {
+            return (position - (corner0 + edge01*(dot1 / (dot1 - dot3)))).length();
+        }
+        const vector3 toPosition2(position - corner2);
+        const real dot5(edge01.dotProduct(toPosition2));
+        const real dot6(edge02.dotProduct(toPosition2));
+        if (dot6 >= 0. && dot5 <= dot6)
+        {
+            return toPosition2.length();
+        }
+        const real area1(dot5*dot2 - dot1*dot6);
+        if (area1 <= 0. && dot2 >= 0. && dot6 <= 0.)
+        {
+            return (position - (corner0 + edge02*(dot2 / (dot2 - dot6)))).length();
+        }
+        const real area0(dot3*dot6 - dot5*dot4);
+        if (area0 <= 0. && dot4 - dot3 >= 0. && dot5 - dot6 >= 0.)
+        {
+            return (position - (corner1 + (corner2 - corner1)*((dot4 - dot3) / ((dot4 - dot3) + (dot5 - dot6))))).length();
+        }
+        const real denominator(1. / (area0 + area1 + area2));
+        return (position - (corner0 + edge01*(area1*denominator) + edge02*(area2*denominator))).length();
+    }
+
+    template <typename indexType>
+    void touchNeighbours(const vector<indexType>& indices, const int32& vertex)
+    {
+        m_touched[vertex] = 1;
+        for (int32 ind = m_vertexTrianglesOffset[vertex]; ind < m_vertexTrianglesOffset[vertex+1]; ++ind)
+        {
+            const int32 triangle(m_vertexTriangles[ind]);
+            for (int32 corner = 0; corner < 3; ++corner)
+            {
+                m_touched[indices[triangle*3 + corner]] = 1;
+            }
+        }
+    }
+
+    vector<quadric> m_quadrics;
+    vector<uint8> m_locked;
+    vector<uint8> m_touched;
+    vector<int32> m_collapseTo;
+    vector<collapse> m_collapses;
+    vector<int32> m_vertexTrianglesOffset;
+    vector<int32> m_vertexTriangles;
+    vector<int32> m_fill;
+    vector<int32> m_neighbours;
+    vector<int32> m_neighboursTo;
+    vector<int32> m_sorted;
+
+};
+
+
+}
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_TILE_INTERNAL_MESHDECIMATOR_HPP
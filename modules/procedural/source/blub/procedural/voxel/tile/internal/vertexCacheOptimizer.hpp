@@ -0,0 +1,254 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_TILE_INTERNAL_VERTEXCACHEOPTIMIZER_HPP
+#define BLUB_PROCEDURAL_VOXEL_TILE_INTERNAL_VERTEXCACHEOPTIMIZER_HPP
+
+#include "blub/core/globals.hpp"
+#include "blub/core/vector.hpp"
+
+#include <algorithm>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace tile
+{
+namespace internal
+{
+
+
+/**
+ * @brief The vertexCacheOptimizer class reorders triangles for the post-transform vertex-cache of the gpu and vertices for fetch-locality.
+ * Implements "Tipsify" of Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw":
+ * it fans around one vertex after the other and picks as next fanning-vertex a neighbour that is still in the simulated fifo-cache.
+ * Runs in linear time. Keeps its buffers between calls, so use one instance per thread.
+ */
+class vertexCacheOptimizer
+{
+public:
+    /// size of the simulated fifo-cache
+    static const int32 cacheSize = 16;
+
+    vertexCacheOptimizer()
+    {
+        ;
+    }
+
+    /**
+     * @brief optimize reorders the triangles of indices. The triangles and their winding stay the same.
+     * @param indices Three per triangle.
+     * @param numVertices All indices must be smaller.
+     */
+    template <typename indexType>
+    void optimize(vector<indexType>& indices, const int32& numVertices)
+    {
+        const int32 numTriangles(indices.size()/3);
+        if (numTriangles < 2)
+        {
+            return;
+        }
+
+        // triangles per vertex
+        m_vertexTrianglesOffset.assign(numVertices+1, 0);
+        for (const indexType& index : indices)
+        {
+            BASSERT(static_cast<int32>(index) < numVertices);
+            ++m_vertexTrianglesOffset[index+1];
+        }
+        for (int32 vertex = 0; vertex < numVertices; ++vertex)
+        {
+            m_vertexTrianglesOffset[vertex+1] += m_vertexTrianglesOffset[vertex];
+        }
+        m_vertexTrianglesLeft.resize(numVertices);
+        for (int32 vertex = 0; vertex < numVertices; ++vertex)
+        {
+            m_vertexTrianglesLeft[vertex] = 0;
+        }
+        m_vertexTriangles.resize(indices.size());
+        for (int32 triangle = 0; triangle < numTriangles; ++triangle)
+        {
+            for (int32 ind = 0; ind < 3; ++ind)
+            {
+                const int32 vertex(indices[triangle*3 + ind]);
+                m_vertexTriangles[m_vertexTrianglesOffset[vertex] + (m_vertexTrianglesLeft[vertex]++)] = triangle;
+            }
+        }
+        m_vertexCacheTime.assign(numVertices, 0);
+        m_triangleAdded.assign(numTriangles, 0);
+        m_deadEnd.clear();
+
+        m_result.clear();
+        m_result.reserve(indices.size());
+        int32 time(cacheSize+1);
+        int32 cursor(0);
+        int32 fanning(indices[0]);
+        while (fanning != -1)
+        {
+            // add all triangles left around the fanning-vertex
+            m_candidates.clear();
+            for (int32 ind = m_vertexTrianglesOffset[fanning]; ind < m_vertexTrianglesOffset[fanning+1]; ++ind)
+            {
+                const int32 triangle(m_vertexTriangles[ind]);
+                if (m_triangleAdded[triangle] != 0)
+                {
+                    continue;
+                }
+                m_triangleAdded[triangle] = 1;
+                for (int32 corner = 0; corner < 3; ++corner)
+                {
+                    const int32 vertex(indices[triangle*3 + corner]);
+                    m_result.push_back(vertex);
+                    m_deadEnd.push_back(vertex);
+                    m_candidates.push_back(vertex);
+                    --m_vertexTrianglesLeft[vertex];
+                    if (time - m_vertexCacheTime[vertex] > cacheSize)
+                    {
+                        m_vertexCacheTime[vertex] = time;
+                        ++time;
+                    }
+                }
+            }
+
+            // the next fanning-vertex is the oldest candidate that stays in the cache while fanning around it
+            fanning = -1;
+            int32 bestPriority(-1);
+            for (const int32& vertex : m_candidates)
+            {
+                if (m_vertexTrianglesLeft[vertex] == 0)
+                {
+                    continue;
+                }
+                int32 priority(0);
+                if (time - m_vertexCacheTime[vertex] + 2*m_vertexTrianglesLeft[vertex] <= cacheSize)
+                {
+                    priority = time - m_vertexCacheTime[vertex];
+                }
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    fanning = vertex;
+                }
+            }
+            if (fanning != -1)
+            {
+                continue;
+            }
+            // dead end, go back to a recently used vertex with triangles left
+            while (!m_deadEnd.empty())
+            {
+                const int32 vertex(m_deadEnd.back());
+                m_deadEnd.pop_back();
+                if (m_vertexTrianglesLeft[vertex] > 0)
+                {
+                    fanning = vertex;
+                    break;
+                }
+            }
+            if (fanning != -1)
+            {
+                continue;
+            }
+            // no recently used vertex left, continue at the next vertex in the original order
+            while (cursor < numVertices)
+            {
+                if (m_vertexTrianglesLeft[cursor] > 0)
+                {
+                    fanning = cursor;
+                    break;
+                }
+                ++cursor;
+            }
+        }
+        BASSERT(static_cast<int32>(m_result.size()) == static_cast<int32>(indices.size()));
+
+        for (int32 ind = 0; ind < static_cast<int32>(indices.size()); ++ind)
+        {
+            indices[ind] = m_result[ind];
+        }
+    }
+
+    /**
+     * @brief calculateFetchRemap calculates a new order of the vertices: in order of their first use by indices.
+     * Vertices not referenced by indices follow in their old order.
+     * @param indices Three per triangle.
+     * @param numVertices All indices must be smaller.
+     * @param remap Gets resized to numVertices. remap[oldIndex] is the new index.
+     * @return The number of referenced vertices.
+     */
+    template <typename indexType>
+    static int32 calculateFetchRemap(const vector<indexType>& indices, const int32& numVertices, vector<int32>& remap)
+    {
+        remap.assign(numVertices, -1);
+        int32 numUsed(0);
+        for (const indexType& index : indices)
+        {
+            int32& target(remap[index]);
+            if (target == -1)
+            {
+                target = numUsed++;
+            }
+        }
+        int32 next(numUsed);
+        for (int32& target : remap)
+        {
+            if (target == -1)
+            {
+                target = next++;
+            }
+        }
+        return numUsed;
+    }
+
+    /**
+     * @brief calculateAverageCacheMissRatio simulates a fifo-cache like the one of most gpus and returns the vertex-transforms per triangle.
+     * 3 is the worst, 0.5 the best possible for a large regular grid.
+     * @param indices Three per triangle.
+     * @param numVertices All indices must be smaller.
+     * @param sizeCache Number of vertices in the simulated cache.
+     * @return 0 if there are no triangles.
+     */
+    template <typename indexType>
+    static real calculateAverageCacheMissRatio(const vector<indexType>& indices, const int32& numVertices, const int32& sizeCache)
+    {
+        const int32 numTriangles(indices.size()/3);
+        if (numTriangles == 0)
+        {
+            return 0.;
+        }
+        // the time a vertex got into the cache
+        vector<int32> inserted(numVertices, -sizeCache-1);
+        int32 misses(0);
+        for (const indexType& index : indices)
+        {
+            if (misses - inserted[index] > sizeCache)
+            {
+                inserted[index] = misses;
+                ++misses;
+            }
+        }
+        return static_cast<real>(misses) / numTriangles;
+    }
+
+protected:
+    vector<int32> m_vertexTrianglesOffset;
+    vector<int32> m_vertexTriangles;
+    vector<int32> m_vertexTrianglesLeft;
+    vector<int32> m_vertexCacheTime;
+    vector<uint8> m_triangleAdded;
+    vector<int32> m_deadEnd;
+    vector<int32> m_candidates;
+    vector<int32> m_result;
+
+};
+
+
+}
+}
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_TILE_INTERNAL_VERTEXCACHEOPTIMIZER_HPP
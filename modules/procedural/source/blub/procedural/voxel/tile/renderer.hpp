@@ -43,6 +43,28 @@ public:
      * @param aabb The axisAlignedBox that describes the bound of the vertices.
      */
     void setTileData(t_tileDataPtr convertToRenderAble, const axisAlignedBox &aabb) {;}
+    /**
+     * @brief setTileDataAttributes gets called instead of setTileData() if only the vertex-attributes changed.
+     * Indices, vertex-count, positions and normals are the same as the ones set by the last setTileData() call.
+     * Reimplement it to only update the buffers of your custom vertex-attributes. Default calls setTileData().
+     * @param convertToRenderAble Contains vertices and indices.
+     * @param aabb The axisAlignedBox that describes the bound of the vertices.
+     */
+    void setTileDataAttributes(t_tileDataPtr convertToRenderAble, const axisAlignedBox &aabb)
+    {
+        static_cast<t_thiz>(this)->setTileData(convertToRenderAble, aabb);
+    }
+    /**
+     * @brief setTileDataPartial gets called instead of setTileData() if the surface-tile got remeshed partially from the one set last, see tile::surface::calculateSurfacePartial().
+     * Only tile::surface::getChangedVertices() and tile::surface::getChangedIndices() differ, if tile::surface::getRemeshedFrom() equals the tile::surface::getRevision() of the last set tile.
+     * Reimplement it to only rewrite these ranges of your buffers. Default calls setTileData().
+     * @param convertToRenderAble Contains vertices and indices.
+     * @param aabb The axisAlignedBox that describes the bound of the vertices.
+     */
+    void setTileDataPartial(t_tileDataPtr convertToRenderAble, const axisAlignedBox &aabb)
+    {
+        static_cast<t_thiz>(this)->setTileData(convertToRenderAble, aabb);
+    }
 
     /**
      * @brief setVisible sets if a tile should get rendered. All lod-submeshes must not be rendered either.
@@ -55,6 +77,7 @@ public:
 
     /**
      * @brief setVisibleLod sets if one of the 6 crack closing submeshes (for lod) should get rendered.
+     * simple::renderer calls it with vis true only after the worker calculated the face of the last set surface-tile, see tile::surface::getIndicesLod().
      * @param indLod 0 to 6
      * @param vis
      */
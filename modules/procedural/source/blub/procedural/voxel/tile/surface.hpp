@@ -1,14 +1,26 @@
 #ifndef PROCEDURAL_VOXEL_TILE_SURFACE_HPP
 #define PROCEDURAL_VOXEL_TILE_SURFACE_HPP
 
+#include "blub/async/mutex.hpp"
+#include "blub/async/mutexLocker.hpp"
 #include "blub/core/array.hpp"
+#include "blub/core/idCreator.hpp"
 #include "blub/core/sharedPointer.hpp"
 #include "blub/core/vector.hpp"
+#include "blub/math/axisAlignedBoxInt32.hpp"
 #include "blub/math/vector2int.hpp"
 #include "blub/math/vector3.hpp"
 #include "blub/math/vector3int.hpp"
 #include "blub/procedural/voxel/tile/base.hpp"
+#include "blub/procedural/voxel/tile/haloView.hpp"
+#include "blub/procedural/voxel/tile/internal/meshDecimator.hpp"
 #include "blub/procedural/voxel/tile/internal/transvoxelTables.hpp"
+#include "blub/procedural/voxel/tile/internal/vertexCacheOptimizer.hpp"
+
+#include <boost/thread/tss.hpp>
+
+#include <algorithm>
+#include <iterator>
 
 
 namespace blub
@@ -27,7 +39,8 @@ namespace tile
  * http://www.terathon.com/voxels/
  * To understand this class and algos please read Eric Lengyel’s Dissertation: http://www.terathon.com/lengyel/Lengyel-VoxelTerrain.pdf .
  * If you got a custom voxel, that effects the resulting surface derive this class and reimplement vertexGotCreated() and vertexGotCreatedLod().
- * Private methods are undocumentated because they simply implement the code described in Eric Lengyel’s Dissertation.
+ * For another mesher derive this class and reimplement calculateSurfaceFrom() and calculateTransitionFace(), see surfaceNets.
+ * Protected methods without documentation simply implement the code described in Eric Lengyel’s Dissertation.
  */
 template <class configType>
 class surface : public base<surface<configType> >
@@ -38,14 +51,87 @@ public:
     typedef typename t_config::t_surface::t_tile* t_thiz;
     typedef typename t_config::t_accessor::t_tile t_voxelAccessor;
     typedef sharedPointer<t_voxelAccessor> t_voxelAccessorPtr;
+    typedef typename t_voxelAccessor::t_voxelArrayLodConstPtr t_voxelArrayLodPtr;
+    typedef haloView<t_config> t_haloView;
     typedef vector<typename t_config::t_vertex> t_vertices;
     typedef vector<typename t_config::t_index> t_indices;
     typedef typename t_config::t_data t_voxel;
     typedef typename t_config::t_vertex t_vertex;
+    typedef typename t_config::t_vertexQuantized t_vertexQuantized;
+    typedef vector<t_vertexQuantized> t_verticesQuantized;
+    typedef typename t_vertexQuantized::dequantization t_dequantization;
+
+    /**
+     * @brief The vertexSource struct saves which voxel got used for creating a vertex. Used by updateVertexAttributes().
+     * voxel0 and voxel1 are the same for vertices no triangle uses anymore, see calculateSurfacePartial().
+     */
+    struct vertexSource
+    {
+        /// the voxelPos parameter of createVertex() / createVertexLod()
+        vector3int32 voxelPos;
+        /// voxel-position of voxel0 in the accessor-tile
+        vector3int32 voxel0;
+        /// voxel-position of voxel1
+        vector3int32 voxel1;
+    };
+    typedef vector<vertexSource> t_vertexSources;
+
+    /**
+     * @brief The changedRange struct describes the part of a list that changed, see getChangedVertices() and getChangedIndices().
+     */
+    struct changedRange
+    {
+        changedRange()
+            : first(0)
+            , count(0)
+        {
+            ;
+        }
+
+        /// first changed element
+        int32 first;
+        /// number of changed elements, may be 0
+        int32 count;
+    };
 
     typedef array<t_voxel, 2*2*2> t_calcVoxel;
     typedef array<t_voxel, 3*3*3+2*2> t_calcVoxelLod;
 
+    /**
+     * @brief The normalMode enum defines how the vertex-normals get calculated.
+     */
+    enum class normalMode
+    {
+        /**
+         * @brief faceAverage sums up the face-normals around a vertex. For seamless normals an extra ring of cells around the tile gets calculated and thrown away.
+         */
+        faceAverage,
+        /**
+         * @brief gradient uses the central differences of the interpolation-field at the vertex. No extra ring of cells gets calculated.
+         */
+        gradient
+    };
+
+    /**
+     * @brief The vertexFormat enum defines which vertex-buffers calculateSurface() and updateVertexAttributes() leave behind.
+     */
+    enum class vertexFormat
+    {
+        /**
+         * @brief full keeps the t_vertex list only, see getVertices().
+         */
+        full,
+        /**
+         * @brief quantized keeps the t_vertexQuantized list only, see getVerticesQuantized(). The t_vertex list gets released after the calculation.
+         * Custom vertex-attributes set by createVertex() get lost.
+         */
+        quantized,
+        /**
+         * @brief fullAndQuantized keeps both lists.
+         */
+        fullAndQuantized
+    };
+
     /**
      * @brief create creates an instance.
      * @return never nullptr.
@@ -77,6 +163,9 @@ public:
 
     /**
      * @brief calculateSurface calculates the iso surface.
+     * For lod > 0 the tile keeps the lod-arrays of voxel (tile::accessor::getVoxelArrayLodShared()) as long as it lives, transvoxel reads them when a face gets requested.
+     * These are 6*tile::accessor::voxelCountLod voxel, 10 KiB with the default voxel. They are shared with the accessor-tile until it changes, simple::accessor keeps
+     * the accessor-tiles, so only a surface-tile that outlives the next change of its accessor-tile holds them on its own.
      * @param voxel Contains the voxel needed for the surface calculation.
      * @param voxelSize voxel-scale.
      * @param calculateNormalCorrection check chapter 3.3 in Eric Lengyel’s Dissertation.
@@ -90,427 +179,101 @@ public:
 #ifdef BLUB_LOG_VOXEL_SURFACE
         blub::BOUT("surface::calculateSurface(..) lod:" + blub::string::number(lod));
 #endif
-
+        BASSERT(!voxel.isNull());
 
         static_cast<t_thiz>(this)->clear();
 
-        m_voxel = voxel;
         m_lod = lod;
-
-        m_vertices.reserve(1000);
-        m_indices.reserve(2000);
-
-        const vector3int32 voxelStart(-1);
-        const vector3int32 voxelEnd(t_voxelAccessor::voxelLength+2);
-
-        const int32 vertexIndicesReuseSize(((voxelEnd.x-voxelStart.x)*3)*((voxelEnd.y-voxelStart.y)*3)*((voxelEnd.z-voxelStart.z)*3));
-        // the indexer for the vertices. *3 because gets saved with edge-id
-        int32 *vertexIndicesReuse = new int32[vertexIndicesReuseSize];
-        for (int32 index = 0; index < vertexIndicesReuseSize; ++index)
-        {
-            vertexIndicesReuse[index] = -1;
-        }
-
-        // isLevel describes at which interpolation-level a surface is generated around the voxel
-        const int8 isoLevel(0);
-        for (int32 x = voxelStart.x; x < voxelEnd.x-1; ++x)
+        m_voxelSize = voxelSize;
+        if (lod > 0)
         {
-            for (int32 y = voxelStart.y; y < voxelEnd.y-1; ++y)
-            {
-                for (int32 z = voxelStart.z; z < voxelEnd.z-1; ++z)
-                {
-                    // depending on the voxel-neighbour- the count and look, of the triangles gets calculated.
-                    uint8 tableIndex(0);
-                    const vector3int32 posVoxel(x, y, z);
-                    t_calcVoxel voxelCalc;
-                    const vector3int32 toCheck[] = {
-                        vector3int32(0, 0, 0),
-                        vector3int32(1, 0, 0),
-                        vector3int32(0, 0, 1),
-                        vector3int32(1, 0, 1),
-                        vector3int32(0, 1, 0),
-                        vector3int32(1, 1, 0),
-                        vector3int32(0, 1, 1),
-                        vector3int32(1, 1, 1)
-                    };
-                    uint16 toAddToTableIndex(1);
-                    for (uint16 indCheck = 0; indCheck < 8; ++indCheck)
-                    {
-                        voxelCalc[indCheck] = getVoxel(posVoxel + toCheck[indCheck]); // <-- acc to valgrind getVoxel is the most expensivec call;
-                        if (voxelCalc[indCheck].getInterpolation() < isoLevel) // OPTIMISE reuse "voxelCalc", instead of calling getVoxel 2 times later!
-                        {
-                            tableIndex |= toAddToTableIndex;
-                        }
-                        toAddToTableIndex*=2;
-                    }
-
-                    // Now create a triangulation of the isosurface in this
-                    // cell.
-                    if (tableIndex == 0 || tableIndex == 255)
-                    {
-                        continue;
-                    }
-                    bool calculateFaces(true);
-                    if (calculateNormalCorrection)
-                    {
-                        calculateFaces = (posVoxel >= vector3int32(0) && posVoxel < voxelEnd - vector3int32(2));
-                    }
-                    // OPTIMISE: too many vertices get calculated because of normalcorrection; optimise!
-                    const RegularCellData *data = &regularCellData[regularCellClass[tableIndex]];
-                    int32 ids[12];
-                    for (int32 ind = 0; ind < data->GetVertexCount(); ++ind)
-                    {
-                        int32 data2 = regularVertexData[tableIndex][ind];
-                        int32 corner0 = data2 & 0x0F;
-                        int32 corner1 = (data2 & 0xF0) >> 4;
-                        int32 id = calculateEdgeId(posVoxel, data2 >> 8); // for reuse
-                        BASSERT(id >= 0);
-                        BASSERT(id < vertexIndicesReuseSize);
-
-                        if (vertexIndicesReuse[id] == -1)
-                        {
-                            vector3 point = calculateIntersectionPosition(posVoxel, corner0, corner1); // OPTIMISE so dirty - use voxelCalc inside the method!
-                            // we calucluate here everything in positive values; but normal correction starts @ -1
-                            point *= voxelSize;
-                            t_voxel voxel0 = getVoxel(posVoxel + calculateCorner(corner0)); // OPTIMISE so dirty - use voxelCalc!
-                            t_voxel voxel1 = getVoxel(posVoxel + calculateCorner(corner1));
-                            const t_vertex vertex(static_cast<t_thiz>(this)->createVertex(posVoxel, voxel0, voxel1, point, vector3()));
-                            m_vertices.push_back(vertex);
-                            ids[ind] = vertexIndicesReuse[id] = m_vertices.size()-1;
-                        }
-                        else
-                        {
-                            ids[ind] = vertexIndicesReuse[id];
-                        }
-                    }
-                    for (int32 ind = 0; ind < data->GetTriangleCount()*3; ind+=3)
-                    {
-                        // calc triangle and normal
-                        const int32 vertexIndex0(ids[data->vertexIndex[ind+0]]);
-                        const int32 vertexIndex1(ids[data->vertexIndex[ind+1]]);
-                        const int32 vertexIndex2(ids[data->vertexIndex[ind+2]]);
-                        const vector3 vertex0(m_vertices.at(vertexIndex0).position);
-                        const vector3 vertex1(m_vertices.at(vertexIndex1).position);
-                        const vector3 vertex2(m_vertices.at(vertexIndex2).position);
-                        if (vertex0 == vertex1 || vertex0 == vertex2 || vertex1 == vertex2)
-                        {
-                            continue; // triangle with zero space
-                        }
-                        const vector3 addNormal = (vertex1 - vertex0).crossProduct(vertex2 - vertex0);//.normalisedCopy();
-                        // if (calculateFaces) // for normal-correction-test
-                        {
-                            m_vertices.at(vertexIndex0).normal += addNormal;
-                            m_vertices.at(vertexIndex1).normal += addNormal;
-                            m_vertices.at(vertexIndex2).normal += addNormal;
-                        }
-                        if (calculateFaces)
-                        {
-                            // insert new triangle
-                            m_indices.push_back(vertexIndex0);
-                            m_indices.push_back(vertexIndex1);
-                            m_indices.push_back(vertexIndex2);
-                        }
-                    }
-                }
-            }
+            // transvoxel reads them later, see getTransitionFace()
+            m_voxelLod = voxel->getVoxelArrayLodShared();
         }
 
-        // transvoxel
-        if (m_lod > 0)// && false)
-        {
-			typedef vector3int32 v3i;
-            const vector3int32 voxelLookups[][9] = {
-                {v3i(0, 0, 0),v3i(0, 1, 0),v3i(0, 2, 0),v3i(0, 2, 1),v3i(0, 2, 2),v3i(0, 1, 2),v3i(0, 0, 2),v3i(0, 0, 1),v3i(0, 1, 1)},
-                {v3i(0, 0, 0),v3i(1, 0, 0),v3i(2, 0, 0),v3i(2, 0, 1),v3i(2, 0, 2),v3i(1, 0, 2),v3i(0, 0, 2),v3i(0, 0, 1),v3i(1, 0, 1)},
-                {v3i(0, 0, 0),v3i(1, 0, 0),v3i(2, 0, 0),v3i(2, 1, 0),v3i(2, 2, 0),v3i(1, 2, 0),v3i(0, 2, 0),v3i(0, 1, 0),v3i(1, 1, 0)},
-                };
-            const int32 voxelLengthLodStart(t_voxelAccessor::voxelLengthLod-2);
-            const int32 voxelLengthLodEnd(t_voxelAccessor::voxelLengthLod-1);
-            const vector3int32 toIterate[][2] = {
-                {v3i(0, 0, 0),                     v3i(1, voxelLengthLodStart, voxelLengthLodStart)},
-                {v3i(voxelLengthLodStart, 0, 0),   v3i(voxelLengthLodEnd, voxelLengthLodStart, voxelLengthLodStart)},
-                {v3i(0, 0, 0),                     v3i(voxelLengthLodStart, 1, voxelLengthLodStart)},
-                {v3i(0, voxelLengthLodStart, 0),   v3i(voxelLengthLodStart, voxelLengthLodEnd, voxelLengthLodStart)},
-                {v3i(0, 0, 0),                     v3i(voxelLengthLodStart, voxelLengthLodStart, 1)},
-                {v3i(0, 0, voxelLengthLodStart),   v3i(voxelLengthLodStart, voxelLengthLodStart, voxelLengthLodEnd)}
-                };
-            const vector3int32 reuseCorrection[] = {
-                v3i(1, 0, 0),
-                v3i(1, 0, 0),
-                v3i(0, 1, 0),
-                v3i(0, 1, 0),
-                v3i(0, 0, 1),
-                v3i(0, 0, 1)
-                };
-
-            const bool toInvertTriangles[] = {
-                false, true,
-                true, false, // data from Eric Lengyel seems to have different axis-desc
-                false, true
-                };
-
-            for (int32 lod = 0; lod < 6; ++lod)
-            {
-                const int32 coord(lod/2);
-                const vector3int32& start(toIterate[lod][0]);
-                const vector3int32& end  (toIterate[lod][1]);
-                const bool invertTriangles(toInvertTriangles[lod]);
-
-                // the indexer for the vertices. *3 because gets saved with edge-id
-                const int32 vertexIndicesReuseLodSize(((t_voxelAccessor::voxelLength+1)*4)*
-                                                      ((t_voxelAccessor::voxelLength+1)*4));
-                vector<int32> vertexIndicesReuseLod(vertexIndicesReuseLodSize, -1);
-
-                for (uint32 x = start.x; x < (unsigned)end.x; x+=2)
-                {
-                    for (uint32 y = start.y; y < (unsigned)end.y; y+=2)
-                    {
-                        for (uint32 z = start.z; z < (unsigned)end.z; z+=2)
-                        {
-                            const vector3int32 voxelPos(x, y, z);
-                            {
-                                uint32 tableIndex(0);
-                                uint32 add(1);
-                                t_calcVoxelLod voxelCalc;
-                                for (uint16 ind = 0; ind < 9; ++ind)
-                                {
-                                    const vector3int32 lookUp((voxelPos-start)+voxelLookups[coord][ind]);
-                                    voxelCalc[ind] = getVoxelLod(lookUp, lod);
-                                    if (voxelCalc[ind].getInterpolation() < isoLevel)
-                                    {
-                                        tableIndex |= add;
-                                    }
-                                    add*=2;
-                                }
-                                if (tableIndex == 0 || tableIndex == 511) // no triangles
-                                {
-                                    continue;
-                                }
-
-                                uint32 classIndex = transitionCellClass[tableIndex];
-                                const TransitionCellData *data = &transitionCellData[classIndex & 0x7F]; // only the last 7 bit count
-                                uint32 ids[12];
-
-                                vector3 normalsForTransvoxel[4];
-
-                                for (uint16 ind = 0; ind < data->GetVertexCount(); ++ind)
-                                {
-                                    const uint16 data2 = transitionVertexData[tableIndex][ind];
-                                    const uint16 edge = data2 >> 8;
-                                    const uint16 edgeId = edge & 0x0F;
-                                    const uint16 edgeBetween(data2 & 0xFF);
-
-                                    if (edgeId == 0x9 || edgeId == 0x8)
-                                    {
-                                        BASSERT(edge == 0x88 || edge == 0x28 || edge == 0x89 || edge == 0x19);
-
-                                        const uint16 owner((edge & 0xF0) >> 4);
-                                        BASSERT(owner == 1 || owner == 2 || owner == 8);
-
-                                        uint16 newEdgeId(0);
-                                        uint16 newOwner(0);
-
-                                        if (coord == 0)
-                                        {
-                                            if (edgeId == 0x8)
-                                            {
-                                                newEdgeId = 0x3;
-                                            }
-                                            else
-                                            {
-                                                newEdgeId = 0x1;
-                                            }
-                                            if (owner == 0x1)
-                                            {
-                                                newOwner = 0x4;
-                                            }
-                                            if (owner == 0x2)
-                                            {
-                                                newOwner = 0x2;
-                                            }
-                                        }
-                                        if (coord == 1)
-                                        {
-                                            if (edgeId == 0x8)
-                                            {
-                                                newEdgeId = 0x2;
-                                            }
-                                            else
-                                            {
-                                                newEdgeId = 0x1;
-                                            }
-                                            newOwner = owner;
-                                        }
-                                        if (coord == 2)
-                                        {
-                                            newEdgeId = edgeId - 6;
-                                            if (owner == 0x1)
-                                            {
-                                                newOwner = 0x1;
-                                            }
-                                            if (owner == 0x2)
-                                            {
-                                                newOwner = 0x4;
-                                            }
-                                        }
-
-
-                                        uint16 newEdge((newOwner << 4) | newEdgeId);
-                                        const int32 id = calculateEdgeId((voxelPos / 2) - reuseCorrection[lod], newEdge);
-
-                                        BASSERT(vertexIndicesReuse[id] != -1);
+        static_cast<t_thiz>(this)->calculateSurfaceFrom(*voxel, voxelSize, calculateNormalCorrection);
+    }
+    /**
+     * @brief calculateSurface calculates the iso surface of lod 0 by reading the container-tiles directly, without an accessor-tile in between.
+     * @param voxel The container-tile and its neighbours. Must stay valid during the call.
+     * @param voxelSize voxel-scale.
+     * @param calculateNormalCorrection check chapter 3.3 in Eric Lengyel’s Dissertation.
+     * @see haloView
+     */
+    void calculateSurface(const t_haloView& voxel,
+                          const real &voxelSize = 1.,
+                          const bool& calculateNormalCorrection = true)
+    {
+        static_cast<t_thiz>(this)->clear();
 
-                                        ids[ind]=vertexIndicesReuse[id];
+        m_lod = 0;
+        m_voxelSize = voxelSize;
 
-                                        const vector3& normal(m_vertices.at(ids[ind]).normal);
-                                        switch (edgeBetween)
-                                        {
-                                        case 0x9A:
-                                            normalsForTransvoxel[0] = normal;
-                                            break;
-                                        case 0xAC:
-                                            normalsForTransvoxel[1] = normal;
-                                            break;
-                                        case 0xBC:
-                                            normalsForTransvoxel[2] = normal;
-                                            break;
-                                        case 0x9B:
-                                            normalsForTransvoxel[3] = normal;
-                                            break;
-                                        default:
-                                            BASSERT(false);
-                                        }
-                                    }
-                                }
-                                for (uint16 ind = 0; ind < data->GetVertexCount(); ++ind)
-                                {
-                                    const uint16 data2 = transitionVertexData[tableIndex][ind];
-                                    const uint16 edge = data2 >> 8;
-                                    const uint16 edgeId = edge & 0x0F;
-                                    const uint16 edgeBetween(data2 & 0xFF);
+        static_cast<t_thiz>(this)->calculateSurfaceFrom(voxel, voxelSize, calculateNormalCorrection);
+    }
 
-                                    if (edgeId != 0x9 && edgeId != 0x8)
-                                    {
-                                        const uint16 corner0 = data2 & 0x0F;
-                                        const uint16 corner1 = (data2 & 0xF0) >> 4;
+    /**
+     * @brief updateVertexAttributes recreates all vertices by createVertex() / createVertexLod() without recalculating the iso-surface.
+     * Position and normal of every vertex stay the same and get passed to createVertex() / createVertexLod().
+     * Call it instead of calculateSurface() if only the voxel-attributes but not the interpolation changed.
+     * @param voxel Contains the voxel, must have the same interpolation as the one used by the last calculateSurface() call.
+     */
+    void updateVertexAttributes(const t_voxelAccessorPtr voxel)
+    {
+        BASSERT(!voxel.isNull());
 
+        if (m_lod > 0)
+        {
+            m_voxelLod = voxel->getVoxelArrayLodShared();
+        }
 
-                                        const int32 id = calculateEdgeIdTransvoxel(voxelPos/2, edge, coord);
+        updateVertexAttributesFrom(*voxel);
+    }
+    /**
+     * @brief updateVertexAttributes same like above but reads the container-tiles directly. Only for surfaces calculated by calculateSurface(const t_haloView&, ...).
+     * @param voxel The container-tile and its neighbours. Must stay valid during the call.
+     */
+    void updateVertexAttributes(const t_haloView& voxel)
+    {
+        BASSERT(m_lod == 0);
 
-                                        //blub::BOUT("edge:" + blub::string::number(edge, 16) + " id:" + blub::string::number(id));
+        updateVertexAttributesFrom(voxel);
+    }
 
-                                        bool calculateVertexPosition(id == -1);
-                                        if (!calculateVertexPosition)
-                                        {
-                                            calculateVertexPosition = vertexIndicesReuseLod[id] == -1;
-                                        }
+    /**
+     * @brief calculateSurfacePartial remeshes only the cells that read a changed voxel plus a one-cell border and splices the result into the lists of the last calculation.
+     * Call it on a copy of the surface-tile (see createCopy()) instead of calculateSurface(). voxel must not differ from the last calculation outside of changed.
+     * Triangles of untouched cells keep their place in getIndices(). Vertices no triangle uses anymore stay in the list and get reused by later splices.
+     * getChangedVertices() and getChangedIndices() return what differs from the copied tile.
+     * @param voxel Contains the voxel needed for the surface calculation.
+     * @param changed Voxel-bounds that changed since the last calculation, see tile::accessor::getChangedVoxelBoundingBox().
+     * @return false if nothing got done, because the last calculation can't get spliced or a full calculation is cheaper. Call calculateSurface() then.
+     */
+    bool calculateSurfacePartial(const t_voxelAccessorPtr voxel, const axisAlignedBoxInt32& changed)
+    {
+        BASSERT(!voxel.isNull());
 
-                                        if (calculateVertexPosition)
-                                        {
-                                            vector3 point = calculateIntersectionPositionTransvoxel(voxelPos-start, corner0, corner1, voxelLookups[coord], lod);
-                                            point+=vector3(start)/2.;
-
-                                            point *= voxelSize;
-
-                                            vector3 normal;
-
-                                            switch (edgeBetween)
-                                            {
-                                            case 0x01:
-                                            case 0x12:
-                                                normal = normalsForTransvoxel[0];
-                                                break;
-                                            case 0x03:
-                                            case 0x36:
-                                                normal = normalsForTransvoxel[3];
-                                                break;
-                                            case 0x25:
-                                            case 0x58:
-                                                normal = normalsForTransvoxel[1];
-                                                break;
-                                            case 0x67:
-                                            case 0x78:
-                                                normal = normalsForTransvoxel[2];
-                                                break;
-                                            case 0x34:
-                                            case 0x14:
-                                            case 0x45:
-                                            case 0x47:
-                                                normal = normalsForTransvoxel[0] + normalsForTransvoxel[1] + normalsForTransvoxel[2] + normalsForTransvoxel[3];
-                                                break;
-                                            default:
-                                                BASSERT(false);
-                                            }
-
-                                            t_voxel voxel0 = getVoxelLod(voxelPos-start + calculateCornerTransvoxel(corner0, voxelLookups[coord]), lod); // OPTIMISE so dirty - use voxelCalc!
-                                            t_voxel voxel1 = getVoxelLod(voxelPos-start + calculateCornerTransvoxel(corner1, voxelLookups[coord]), lod);
-                                            const t_vertex vertex(static_cast<t_thiz>(this)->createVertexLod(voxelPos, voxel0, voxel1, point, normal));
-                                            m_vertices.push_back(vertex);
-
-                                            if (id == -1)
-                                            {
-                                                ids[ind] = m_vertices.size()-1;
-                                            }
-                                            else
-                                            {
-                                                ids[ind] = vertexIndicesReuseLod[id] = m_vertices.size()-1;
-                                            }
-                                        }
-                                        else
-                                        {
-                                            ids[ind] = vertexIndicesReuseLod[id];
-                                        }
-                                    }
-                                }
-                                for (uint16 ind = 0; ind < data->GetTriangleCount()*3; ind+=3)
-                                {
-                                    // calc triangle
-                                    const int32 vertexIndex0(ids[data->vertexIndex[ind+0]]);
-                                    const int32 vertexIndex1(ids[data->vertexIndex[ind+1]]);
-                                    const int32 vertexIndex2(ids[data->vertexIndex[ind+2]]);
-                                    const vector3 vertex0(m_vertices.at(vertexIndex0).position);
-                                    const vector3 vertex1(m_vertices.at(vertexIndex1).position);
-                                    const vector3 vertex2(m_vertices.at(vertexIndex2).position);
-                                    if (vertex0 == vertex1 || vertex1 == vertex2 || vertex0 == vertex2)
-                                    {
-                                        continue; // triangle with zero space
-                                    }
-                                    // insert new triangle
-                                    uint16 invert(1);
-                                    if (invertTriangles)
-                                    {
-                                        invert = 0;
-                                    }
-                                    m_indicesLod[lod].push_back(vertexIndex0);
-                                    if ((classIndex >> 7) % 2 == invert)
-                                    {
-                                        m_indicesLod[lod].push_back(vertexIndex1);
-                                        m_indicesLod[lod].push_back(vertexIndex2);
-                                    }
-                                    else
-                                    {
-                                        m_indicesLod[lod].push_back(vertexIndex2);
-                                        m_indicesLod[lod].push_back(vertexIndex1);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+        if (!calculateSurfacePartialFrom(*voxel, changed))
+        {
+            return false;
         }
-
-        delete [] vertexIndicesReuse;
-
-        // normalise normals
-        for (t_vertex& workVertex : m_vertices)
+        if (m_lod > 0)
         {
-            workVertex.normal.normalise();
+            m_voxelLod = voxel->getVoxelArrayLodShared();
         }
+        return true;
+    }
+    /**
+     * @brief calculateSurfacePartial same like above but reads the container-tiles directly. Only for surfaces calculated by calculateSurface(const t_haloView&, ...).
+     * @param voxel The container-tile and its neighbours. Must stay valid during the call.
+     * @param changed Voxel-bounds relative to the surface-tile that changed since the last calculation.
+     * @return false if nothing got done, call calculateSurface() then.
+     */
+    bool calculateSurfacePartial(const t_haloView& voxel, const axisAlignedBoxInt32& changed)
+    {
+        BASSERT(m_lod == 0);
 
-#ifdef BLUB_LOG_VOXEL_SURFACE
-        blub::BOUT("surface::calculateSurface(..) end");
-#endif
+        return calculateSurfacePartialFrom(voxel, changed);
     }
 
     /**
@@ -519,105 +282,1824 @@ public:
     void clear()
     {
         m_vertices.clear();
+        m_verticesQuantized.clear();
+        m_vertexSources.clear();
         m_indices.clear();
         for (int32 lod = 0; lod < 6; ++lod)
         {
-            m_indicesLod[lod].clear();
+            m_faceVertices[lod].clear();
         }
+        m_transitions.clear();
+        m_voxelLod.reset();
+        m_cellTriangles.clear();
+        m_freeVertices.clear();
     }
 
     /**
-     * @brief does the transvoxel algo get applied.
+     * @brief setNormalMode sets how the vertex-normals get calculated by the next calculateSurface(). Default is normalMode::faceAverage.
+     * @param toSet
+     */
+    void setNormalMode(const normalMode& toSet)
+    {
+        m_normalMode = toSet;
+    }
+    /**
+     * @brief getNormalMode returns the mode set by setNormalMode().
      * @return
      */
-    bool getCaluculateTransvoxel() const
+    const normalMode& getNormalMode() const
     {
-        return m_lod > 0;
+        return m_normalMode;
     }
 
     /**
-     * @brief same as getCaluculateTransvoxel()
-     * @see getCaluculateTransvoxel()
+     * @brief setVertexFormat sets which vertex-buffers get created by the next calculateSurface(). Default is vertexFormat::full.
+     * @param toSet
      */
-    bool getCaluculateLod() const
+    void setVertexFormat(const vertexFormat& toSet)
     {
-        return getCaluculateTransvoxel();
+        m_vertexFormat = toSet;
     }
-
     /**
-     * @brief getPositions returns resulting position-list.
+     * @brief getVertexFormat returns the format set by setVertexFormat().
      * @return
      */
-    const t_vertices& getVertices() const
+    const vertexFormat& getVertexFormat() const
     {
-        return m_vertices;
+        return m_vertexFormat;
     }
+
     /**
-     * @brief getIndices returns resulting index-list.
-     * @return
+     * @brief setOptimizeVertexCache sets if the next calculateSurface() reorders the triangles for the vertex-cache of the gpu and the vertices in order of their first use.
+     * Applies to the transvoxel-faces too. Costs time on the worker and disables calculateSurfacePartial(), the mesh stays the same. Default is false.
+     * @param toSet
+     * @see internal::vertexCacheOptimizer
      */
-    const t_indices& getIndices() const
+    void setOptimizeVertexCache(const bool& toSet)
     {
-        return m_indices;
+        m_optimizeVertexCache = toSet;
     }
     /**
-     * @brief getPositions returns resulting transvoxel-list. Vertices for these indices are in getPositions() and getNormals().
+     * @brief getOptimizeVertexCache returns the value set by setOptimizeVertexCache().
      * @return
      */
-    const t_indices& getIndicesLod(const uint16& lod) const
+    const bool& getOptimizeVertexCache() const
     {
-        BASSERT(lod < 6);
-        return m_indicesLod[lod];
+        return m_optimizeVertexCache;
     }
 
-protected:
     /**
-     * @brief surface constructor
+     * @brief setDecimation sets the error-budget with which the next calculateSurface() reduces the triangles, for far lods.
+     * Edges collapse as long as the mean distance to the marching cubes surface stays below toSet. Vertices on the border of the tile don't move,
+     * so the tile still fits to its neighbours and the transvoxel-faces. The remaining vertices keep their position.
+     * Disables calculateSurfacePartial(). Default is 0, no decimation.
+     * @param toSet Maximal error in voxel of the lod of the tile.
+     * @see internal::meshDecimator
      */
-    surface()
+    void setDecimation(const real& toSet)
     {
+        BASSERT(toSet >= 0.);
+        m_decimation = toSet;
     }
-
     /**
-     * @brief Creates a vertex
+     * @brief getDecimation returns the error-budget set by setDecimation().
+     * @return
      */
-    t_vertex createVertex(const vector3int32& /*voxelPos*/, const t_voxel &/*voxel0*/, const t_voxel &/*voxel1*/, const vector3 &position, const vector3 &normal)
+    const real& getDecimation() const
     {
-        t_vertex result;
-        result.position = position;
-        result.normal = normal;
-        return result;
+        return m_decimation;
     }
 
     /**
-     * @brief Creates a vertex for lod
+     * @brief does the transvoxel algo get applied.
+     * @return
      */
-    t_vertex createVertexLod(const vector3int32& /*voxelPos*/, const t_voxel &/*voxel0*/, const t_voxel &/*voxel1*/, const vector3 &position, const vector3 &normal)
+    bool getCaluculateTransvoxel() const
     {
-        t_vertex result;
-        result.position = position;
-        result.normal = normal;
-        return result;
+        return m_lod > 0;
     }
 
-private:
-    const t_voxel &getVoxel(const vector3int32& pos) const
-    {
-        return m_voxel->getVoxel(pos);
-    }
-    const int8 &getVoxelInterpolation(const vector3int32& pos) const
+    /**
+     * @brief same as getCaluculateTransvoxel()
+     * @see getCaluculateTransvoxel()
+     */
+    bool getCaluculateLod() const
     {
-        return getVoxel(pos).getInterpolation();
+        return getCaluculateTransvoxel();
+    }
+
+    /**
+     * @brief getPositions returns resulting position-list.
+     * @return
+     */
+    const t_vertices& getVertices() const
+    {
+        return m_vertices;
+    }
+    /**
+     * @brief getVerticesQuantized returns the resulting quantized vertex-list. Empty if the vertex-format is vertexFormat::full.
+     * Same order as getVertices(), so getIndices() and getIndicesLod() index both lists.
+     * @return
+     */
+    const t_verticesQuantized& getVerticesQuantized() const
+    {
+        return m_verticesQuantized;
+    }
+    /**
+     * @brief getDequantization returns the parameters to convert the positions of getVerticesQuantized() back to tile-space.
+     * @return
+     */
+    const t_dequantization& getDequantization() const
+    {
+        return m_dequantization;
+    }
+    /**
+     * @brief getIndices returns resulting index-list.
+     * @return
+     */
+    const t_indices& getIndices() const
+    {
+        return m_indices;
+    }
+    /**
+     * @brief getVertexId returns an id of a vertex, that is the same in every surface-tile of the same lod which calculates this vertex.
+     * Vertices on the border of a tile get calculated by both neighbours, weld them by this id. See simple::utils::meshExport.
+     * @param index Index in getVertices() or getVerticesQuantized().
+     * @param id TileId of this surface-tile.
+     * @return Derived from the absolute voxel-position of the edge the vertex lies on.
+     */
+    uint64 getVertexId(const int32& index, const vector3int32& id) const
+    {
+        BASSERT(index >= 0);
+        BASSERT(index < static_cast<int32>(m_vertexSources.size()));
+        return static_cast<const typename t_config::t_surface::t_tile*>(this)->calculateVertexId(index, id*t_voxelAccessor::voxelLength);
+    }
+    /**
+     * @brief getRevision returns an id that is unique for every calculation of any surface-tile.
+     * @return
+     * @see getRemeshedFrom()
+     */
+    const uint32& getRevision() const
+    {
+        return m_revision;
+    }
+    /**
+     * @brief getRemeshedFrom returns the revision of the tile calculateSurfacePartial() spliced into. A renderer holding that tile may update only the changed ranges.
+     * @return 0 if the last calculation wasn't partial.
+     */
+    const uint32& getRemeshedFrom() const
+    {
+        return m_remeshedFrom;
+    }
+    /**
+     * @brief getRemeshedPartially returns true if the last calculation was calculateSurfacePartial().
+     * @return
+     */
+    bool getRemeshedPartially() const
+    {
+        return m_remeshedFrom != 0;
+    }
+    /**
+     * @brief getChangedVertices returns the range of getVertices() and getVerticesQuantized() that differs from the tile of getRemeshedFrom().
+     * Vertices behind the vertex-count of that tile got appended. Returns the whole list if the last calculation wasn't partial.
+     * @return
+     */
+    const changedRange& getChangedVertices() const
+    {
+        return m_changedVertices;
+    }
+    /**
+     * @brief getChangedIndices returns the range of getIndices() that differs from the tile of getRemeshedFrom().
+     * If the number of triangles changed, the range lasts to the end of the list. Returns the whole list if the last calculation wasn't partial.
+     * @return
+     */
+    const changedRange& getChangedIndices() const
+    {
+        return m_changedIndices;
+    }
+    /**
+     * @brief getIndicesLod returns the transvoxel-triangles of a face, which close the crack to a neighbour with a finer lod.
+     * The indices index getVerticesLod(), every face is a mesh on its own.
+     * A face gets calculated on the first call of getIndicesLod(), getVerticesLod() or getVerticesQuantizedLod() and cached as long as the tile lives. Threadsafe.
+     * Make the first call on a worker-thread, simple::renderer does so before it sets a face visible.
+     * @param lod The face, 0 to 5.
+     * @return Empty if getCaluculateLod() is false.
+     * @see getTransitionFaceCalculated()
+     */
+    const t_indices& getIndicesLod(const uint16& lod) const
+    {
+        return getTransitionFace(lod).indices;
+    }
+    /**
+     * @brief getVerticesLod returns the vertices of a transvoxel-face. Contains copies of the marching cubes vertices on the face.
+     * Empty if the vertex-format is vertexFormat::quantized.
+     * @param lod The face, 0 to 5.
+     * @return
+     * @see getIndicesLod()
+     */
+    const t_vertices& getVerticesLod(const uint16& lod) const
+    {
+        return getTransitionFace(lod).vertices;
+    }
+    /**
+     * @brief getVerticesQuantizedLod same as getVerticesLod() but quantized. Empty if the vertex-format is vertexFormat::full.
+     * @param lod The face, 0 to 5.
+     * @return
+     * @see getIndicesLod()
+     */
+    const t_verticesQuantized& getVerticesQuantizedLod(const uint16& lod) const
+    {
+        return getTransitionFace(lod).verticesQuantized;
+    }
+    /**
+     * @brief getTransitionFaceCalculated returns true if a face got calculated already, so getIndicesLod() returns without calculating it. Threadsafe.
+     * @param lod The face, 0 to 5.
+     * @return
+     */
+    bool getTransitionFaceCalculated(const uint16& lod) const
+    {
+        BASSERT(lod < 6);
+
+        async::mutexLocker locker(m_transitions.mutex);
+        return m_transitions.faces[lod].calculated;
+    }
+
+protected:
+    /**
+     * @brief surface constructor
+     */
+    surface()
+        : m_lod(0)
+        , m_voxelSize(1.)
+        , m_normalCorrection(true)
+        , m_normalMode(normalMode::faceAverage)
+        , m_vertexFormat(vertexFormat::full)
+        , m_optimizeVertexCache(false)
+        , m_decimation(0.)
+        , m_revision(0)
+        , m_remeshedFrom(0)
+    {
+    }
+
+    /**
+     * @brief Creates a vertex
+     */
+    t_vertex createVertex(const vector3int32& /*voxelPos*/, const t_voxel &/*voxel0*/, const t_voxel &/*voxel1*/, const vector3 &position, const vector3 &normal)
+    {
+        t_vertex result;
+        result.position = position;
+        result.normal = normal;
+        return result;
+    }
+
+    /**
+     * @brief Creates a vertex for lod
+     */
+    t_vertex createVertexLod(const vector3int32& /*voxelPos*/, const t_voxel &/*voxel0*/, const t_voxel &/*voxel1*/, const vector3 &position, const vector3 &normal)
+    {
+        t_vertex result;
+        result.position = position;
+        result.normal = normal;
+        return result;
+    }
+
+protected:
+    /**
+     * @brief The faceVertex struct remembers a marching cubes vertex on a face of the tile, transvoxel reuses them.
+     */
+    struct faceVertex
+    {
+        /// see calculateVertexIdFace()
+        int32 id;
+        /// index in m_vertices
+        int32 vertex;
+
+        bool operator < (const faceVertex& other) const
+        {
+            return id < other.id;
+        }
+    };
+    typedef vector<faceVertex> t_faceVertices;
+
+    /**
+     * @brief The cellTriangles struct maps a marching cubes cell to its triangles in m_indices. Cells without triangles have no entry.
+     */
+    struct cellTriangles
+    {
+        /// see calculateCellId()
+        int32 cell;
+        /// first index in m_indices, the triangles last up to the index of the next entry
+        int32 index;
+
+        bool operator < (const cellTriangles& other) const
+        {
+            return cell < other.cell;
+        }
+    };
+    typedef vector<cellTriangles> t_cellTriangles;
+
+    /**
+     * @brief The partialVertex struct is a vertex calculated by calculateSurfacePartialFrom().
+     */
+    struct partialVertex
+    {
+        t_vertex vertex;
+        vertexSource source;
+        /// see calculateEdgeKeyPartial()
+        int32 key;
+        /// edge-owner and edge like in calculateSurfaceFrom(), for the transvoxel-faces
+        vector3int32 owner;
+        int32 edge;
+        /// index in m_vertices. -1 if no spliced cell uses the vertex, -2 if it needs a new place
+        int32 target;
+    };
+
+    /**
+     * @brief The transitionFace struct holds the results of transvoxel for one face.
+     */
+    struct transitionFace
+    {
+        transitionFace()
+            : calculated(false)
+        {
+            ;
+        }
+
+        bool calculated;
+        t_vertices vertices;
+        t_verticesQuantized verticesQuantized;
+        t_indices indices;
+    };
+    /**
+     * @brief The transitionCache struct holds the six faces calculated by getTransitionFace(). A copy starts empty and calculates its faces again.
+     */
+    struct transitionCache
+    {
+        transitionCache()
+        {
+            ;
+        }
+        transitionCache(const transitionCache& /*toCopy*/)
+        {
+            ;
+        }
+        transitionCache& operator = (const transitionCache& /*toCopy*/)
+        {
+            clear();
+            return *this;
+        }
+        void clear()
+        {
+            async::mutexLocker locker(mutex);
+            for (transitionFace& face : faces)
+            {
+                face = transitionFace();
+            }
+        }
+
+        async::mutex mutex;
+        transitionFace faces[6];
+    };
+
+    /**
+     * @brief The reuseBuffer struct holds the vertex-indices for reusing vertices during calculateSurface(). One per thread, see getReuseBuffer().
+     */
+    struct reuseBuffer
+    {
+        reuseBuffer()
+            : vertexIndices(2*t_voxelAccessor::voxelLengthWithNormalCorrection*t_voxelAccessor::voxelLengthWithNormalCorrection*3)
+            , vertexIndicesFace(6*t_voxelAccessor::voxelLengthWithNormalCorrection*t_voxelAccessor::voxelLengthWithNormalCorrection*3)
+            , vertexIndicesLod(2*(t_voxelAccessor::voxelLength+1)*4)
+            , signs(t_voxelAccessor::voxelLengthWithNormalCorrection*t_voxelAccessor::voxelLengthWithNormalCorrection)
+        {
+            ;
+        }
+
+        /**
+         * @brief vertexIndices two x-slices of marching cubes.
+         */
+        vector<int32> vertexIndices;
+        /**
+         * @brief vertexIndicesFace the marching cubes vertices on the six borders of the tile.
+         */
+        vector<int32> vertexIndicesFace;
+        /**
+         * @brief vertexIndicesLod two rows of a transvoxel face.
+         */
+        vector<int32> vertexIndicesLod;
+        /**
+         * @brief signs one bitmask per row along z, see calculateSurfaceFrom().
+         */
+        vector<uint32> signs;
+        /**
+         * @brief vertices, vertexSources, indices and cellTriangles are the arena calculateSurfaceFrom() writes to.
+         * They keep their capacity, so remeshing allocates only the exactly sized results of the tile.
+         */
+        t_vertices vertices;
+        t_vertexSources vertexSources;
+        t_indices indices;
+        t_cellTriangles cellTriangles;
+        /**
+         * @brief verticesFace, indicesFace and faceVerticesLocal are the arena of calculateTransitionFace().
+         */
+        t_vertices verticesFace;
+        t_indices indicesFace;
+        vector<int32> faceVerticesLocal;
+        /**
+         * @brief the buffers of calculateSurfacePartialFrom().
+         */
+        vector<partialVertex> verticesPartial;
+        vector<int32> edgesPartial;
+        vector<int32> edgesOld;
+        vector<int32> indicesPartial;
+        t_cellTriangles cellTrianglesPartial;
+        vector<int32> verticesOld;
+        vector<int32> verticesKeep;
+        vector<int32> verticesFreed;
+        t_indices indicesSplice;
+        t_cellTriangles cellTrianglesSplice;
+        /**
+         * @brief the buffers of optimizeVertexCache() and optimizeVertexCacheFace().
+         */
+        internal::vertexCacheOptimizer optimizer;
+        vector<int32> remap;
+        /**
+         * @brief the buffers of decimate().
+         */
+        internal::meshDecimator decimator;
+        vector<uint8> verticesLocked;
+        t_vertices verticesOptimized;
+        t_vertexSources vertexSourcesOptimized;
+        t_verticesQuantized verticesQuantizedOptimized;
+    };
+    /**
+     * @brief getReuseBuffer returns the reuseBuffer of the calling thread, so no buffer gets allocated per calculateSurface().
+     */
+    static reuseBuffer& getReuseBuffer()
+    {
+        static boost::thread_specific_ptr<reuseBuffer> buffer;
+        if (buffer.get() == nullptr)
+        {
+            buffer.reset(new reuseBuffer());
+        }
+        return *buffer;
+    }
+
+    /**
+     * @brief calculateSurfaceFrom calculates the iso surface, called by calculateSurface(). Set m_lod and m_voxelLod before.
+     * Marching cubes reads through voxel, so it works for accessor-tiles and haloView alike.
+     * Transvoxel runs later per face on demand, see getTransitionFace().
+     */
+    template <class voxelSourceType>
+    void calculateSurfaceFrom(const voxelSourceType& voxel, const real &voxelSize, const bool& calculateNormalCorrection)
+    {
+        const vector3int32 voxelStart(-1);
+        const vector3int32 voxelEnd(t_voxelAccessor::voxelLength+2);
+
+        m_normalCorrection = calculateNormalCorrection;
+
+        // the results get written to the arena of the thread and get copied to the tile at the end, see moveResultsFromArena()
+        reuseBuffer& buffer(getReuseBuffer());
+        moveResultsToArena(buffer);
+
+        // the indexer for the vertices of the current and the last x-slice. *3 because gets saved with edge-id
+        vector<int32>& vertexIndicesReuse(buffer.vertexIndices);
+        std::fill(vertexIndicesReuse.begin(), vertexIndicesReuse.end(), -1);
+        // the vertices on the border of the tile, transvoxel reuses them
+        vector<int32>& vertexIndicesReuseFace(buffer.vertexIndicesFace);
+        if (m_lod > 0)
+        {
+            std::fill(vertexIndicesReuseFace.begin(), vertexIndicesReuseFace.end(), -1);
+        }
+
+        // isLevel describes at which interpolation-level a surface is generated around the voxel
+        const int8 isoLevel(0);
+
+        // one bit per voxel along z, set if the voxel is below isoLevel. Every voxel gets read only once.
+        const int32 length(voxelEnd.z-voxelStart.z);
+        BASSERT(length <= 32);
+        vector<uint32>& signs(buffer.signs);
+        for (int32 x = voxelStart.x; x < voxelEnd.x; ++x)
+        {
+            for (int32 y = voxelStart.y; y < voxelEnd.y; ++y)
+            {
+                uint32 row(0);
+                for (int32 z = voxelStart.z; z < voxelEnd.z; ++z)
+                {
+                    if (voxel.getVoxel(vector3int32(x, y, z)).getInterpolation() < isoLevel)
+                    {
+                        row |= 1u << (z-voxelStart.z);
+                    }
+                }
+                signs[(x-voxelStart.x)*length + (y-voxelStart.y)] = row;
+            }
+        }
+        const uint32 rowAll(length == 32 ? ~0u : (1u << length) - 1);
+
+        // the gradient needs no ring of cells around the tile for the normals
+        const bool gradient(m_normalMode == normalMode::gradient);
+        const vector3int32 cellStart(gradient ? vector3int32(0) : voxelStart);
+        const vector3int32 cellEnd(gradient ? vector3int32(t_voxelAccessor::voxelLength) : voxelEnd - vector3int32(1));
+        const uint32 rowCells(((1u << (cellEnd.z-voxelStart.z)) - 1) & ~((1u << (cellStart.z-voxelStart.z)) - 1));
+
+        // count the cells with surface, so the arena grows at most once. Marching cubes creates at most 5 triangles per cell and about 3 vertices.
+        {
+            int32 numCells(0);
+            for (int32 x = cellStart.x; x < cellEnd.x; ++x)
+            {
+                const uint32* signs0(&signs[(x-voxelStart.x)*length]);
+                const uint32* signs1(signs0 + length);
+                for (int32 y = cellStart.y-voxelStart.y; y < cellEnd.y-voxelStart.y; ++y)
+                {
+                    const uint32 any(signs0[y] | signs1[y] | signs0[y+1] | signs1[y+1]);
+                    const uint32 all(signs0[y] & signs1[y] & signs0[y+1] & signs1[y+1]);
+                    for (uint32 crossing((any | (any >> 1)) & ~(all & (all >> 1)) & rowCells); crossing != 0; crossing &= crossing-1)
+                    {
+                        ++numCells;
+                    }
+                }
+            }
+            m_vertices.reserve(numCells*3);
+            m_vertexSources.reserve(numCells*3);
+            m_indices.reserve(numCells*5*3);
+            m_cellTriangles.reserve(numCells);
+        }
+
+        for (int32 x = cellStart.x; x < cellEnd.x; ++x)
+        {
+            // cells of slice x own vertices of slice x and x-1, so the slice x-2 can get overwritten
+            const int32 sliceSize(vertexIndicesReuse.size()/2);
+            const vector<int32>::iterator slice(vertexIndicesReuse.begin() + ((x+2) & 1)*sliceSize);
+            std::fill(slice, slice + sliceSize, -1);
+
+            const uint32* signs0(&signs[(x-voxelStart.x)*length]);
+            const uint32* signs1(signs0 + length);
+
+            // skip the slab if no sign changes between the slices x and x+1
+            uint32 slabAny(0);
+            uint32 slabAll(rowAll);
+            for (int32 y = 0; y < length; ++y)
+            {
+                slabAny |= signs0[y] | signs1[y];
+                slabAll &= signs0[y] & signs1[y];
+            }
+            if (slabAny == 0 || slabAll == rowAll)
+            {
+                continue;
+            }
+
+            for (int32 y = cellStart.y; y < cellEnd.y; ++y)
+            {
+                const int32 indY(y-voxelStart.y);
+                const uint32 sign00(signs0[indY]);
+                const uint32 sign10(signs1[indY]);
+                const uint32 sign01(signs0[indY+1]);
+                const uint32 sign11(signs1[indY+1]);
+
+                // bit z is set for every cell from z to z+1 that has corners on both sides of the iso-surface
+                const uint32 any(sign00 | sign10 | sign01 | sign11);
+                const uint32 all(sign00 & sign10 & sign01 & sign11);
+                uint32 crossing((any | (any >> 1)) & ~(all & (all >> 1)) & rowCells);
+
+                for (int32 z = voxelStart.z; crossing != 0; ++z, crossing >>= 1)
+                {
+                    if ((crossing & 1) == 0)
+                    {
+                        continue;
+                    }
+
+                    // depending on the voxel-neighbour- the count and look, of the triangles gets calculated.
+                    // bit order like the corners of calculateCorner()
+                    const int32 bit(z-voxelStart.z);
+                    const uint8 tableIndex(((sign00 >> bit) & 1) |
+                                           (((sign10 >> bit) & 1) << 1) |
+                                           (((sign00 >> (bit+1)) & 1) << 2) |
+                                           (((sign10 >> (bit+1)) & 1) << 3) |
+                                           (((sign01 >> bit) & 1) << 4) |
+                                           (((sign11 >> bit) & 1) << 5) |
+                                           (((sign01 >> (bit+1)) & 1) << 6) |
+                                           (((sign11 >> (bit+1)) & 1) << 7));
+                    BASSERT(tableIndex != 0 && tableIndex != 255);
+                    const vector3int32 posVoxel(x, y, z);
+
+                    bool calculateFaces(true);
+                    if (calculateNormalCorrection)
+                    {
+                        calculateFaces = (posVoxel >= vector3int32(0) && posVoxel < voxelEnd - vector3int32(2));
+                    }
+                    // OPTIMISE: too many vertices get calculated because of normalcorrection; optimise!
+                    const RegularCellData *data = &regularCellData[regularCellClass[tableIndex]];
+                    int32 ids[12];
+                    for (int32 ind = 0; ind < data->GetVertexCount(); ++ind)
+                    {
+                        int32 data2 = regularVertexData[tableIndex][ind];
+                        int32 corner0 = data2 & 0x0F;
+                        int32 corner1 = (data2 & 0xF0) >> 4;
+                        const vector3int32 owner(calculateEdgeOwner(posVoxel, data2 >> 8));
+                        const int32 edge(((data2 >> 8) & 0x0F) - 1);
+                        const int32 id(calculateVertexId(owner) + edge); // for reuse
+                        BASSERT(id >= 0);
+                        BASSERT(id < (int32)vertexIndicesReuse.size());
+
+                        if (vertexIndicesReuse[id] == -1)
+                        {
+                            vector3 point = calculateIntersectionPosition(voxel, posVoxel, corner0, corner1); // OPTIMISE so dirty - use voxelCalc inside the method!
+                            // we calucluate here everything in positive values; but normal correction starts @ -1
+                            point *= voxelSize;
+                            t_voxel voxel0 = voxel.getVoxel(posVoxel + calculateCorner(corner0)); // OPTIMISE so dirty - use voxelCalc!
+                            t_voxel voxel1 = voxel.getVoxel(posVoxel + calculateCorner(corner1));
+                            vector3 normal;
+                            if (gradient)
+                            {
+                                normal = calculateGradientNormal(voxel, posVoxel + calculateCorner(corner0), posVoxel + calculateCorner(corner1));
+                            }
+                            const t_vertex vertex(static_cast<t_thiz>(this)->createVertex(posVoxel, voxel0, voxel1, point, normal));
+                            m_vertices.push_back(vertex);
+                            addVertexSource(posVoxel, posVoxel + calculateCorner(corner0), posVoxel + calculateCorner(corner1));
+                            ids[ind] = vertexIndicesReuse[id] = m_vertices.size()-1;
+                            if (m_lod > 0)
+                            {
+                                addVertexOnFaces(vertexIndicesReuseFace, owner, edge, ids[ind]);
+                            }
+                        }
+                        else
+                        {
+                            ids[ind] = vertexIndicesReuse[id];
+                        }
+                    }
+                    const int32 indicesBefore(m_indices.size());
+                    for (int32 ind = 0; ind < data->GetTriangleCount()*3; ind+=3)
+                    {
+                        // calc triangle and normal
+                        const int32 vertexIndex0(ids[data->vertexIndex[ind+0]]);
+                        const int32 vertexIndex1(ids[data->vertexIndex[ind+1]]);
+                        const int32 vertexIndex2(ids[data->vertexIndex[ind+2]]);
+                        const vector3 vertex0(m_vertices.at(vertexIndex0).position);
+                        const vector3 vertex1(m_vertices.at(vertexIndex1).position);
+                        const vector3 vertex2(m_vertices.at(vertexIndex2).position);
+                        if (vertex0 == vertex1 || vertex0 == vertex2 || vertex1 == vertex2)
+                        {
+                            continue; // triangle with zero space
+                        }
+                        const vector3 addNormal = (vertex1 - vertex0).crossProduct(vertex2 - vertex0);//.normalisedCopy();
+                        // if (calculateFaces) // for normal-correction-test
+                        if (!gradient)
+                        {
+                            m_vertices.at(vertexIndex0).normal += addNormal;
+                            m_vertices.at(vertexIndex1).normal += addNormal;
+                            m_vertices.at(vertexIndex2).normal += addNormal;
+                        }
+                        if (calculateFaces)
+                        {
+                            // insert new triangle
+                            m_indices.push_back(vertexIndex0);
+                            m_indices.push_back(vertexIndex1);
+                            m_indices.push_back(vertexIndex2);
+                        }
+                    }
+                    // remember the triangles of the cell for calculateSurfacePartial()
+                    if (calculateNormalCorrection && static_cast<int32>(m_indices.size()) != indicesBefore)
+                    {
+                        cellTriangles toAdd;
+                        toAdd.cell = calculateCellId(posVoxel);
+                        toAdd.index = indicesBefore;
+                        m_cellTriangles.push_back(toAdd);
+                    }
+                }
+            }
+        }
+
+        // remember the marching cubes vertices on the faces, transvoxel reuses them on demand, see getTransitionFace()
+        if (m_lod > 0)
+        {
+            const int32 faceSize(vertexIndicesReuseFace.size()/6);
+            for (int32 face = 0; face < 6; ++face)
+            {
+                const vector<int32>::const_iterator faceBegin(vertexIndicesReuseFace.begin() + face*faceSize);
+                t_faceVertices result;
+                result.reserve(faceSize - std::count(faceBegin, faceBegin + faceSize, -1));
+                for (int32 id = face*faceSize; id < (face+1)*faceSize; ++id)
+                {
+                    if (vertexIndicesReuseFace[id] != -1)
+                    {
+                        faceVertex toAdd;
+                        toAdd.id = id;
+                        toAdd.vertex = vertexIndicesReuseFace[id];
+                        result.push_back(toAdd);
+                    }
+                }
+                m_faceVertices[face].swap(result);
+            }
+        }
+
+        // normalise normals
+        for (t_vertex& workVertex : m_vertices)
+        {
+            workVertex.normal.normalise();
+        }
+
+        if (m_decimation > 0.)
+        {
+            decimate(buffer, m_decimation);
+        }
+        if (m_optimizeVertexCache)
+        {
+            optimizeVertexCache(buffer);
+        }
+
+        m_dequantization = calculateDequantization(voxelSize);
+        if (m_vertexFormat != vertexFormat::full)
+        {
+            quantizeVertices();
+        }
+        moveResultsFromArena(buffer);
+
+        m_revision = createRevision();
+        m_remeshedFrom = 0;
+        setChangedAll();
+
+#ifdef BLUB_LOG_VOXEL_SURFACE
+        blub::BOUT("surface::calculateSurface(..) end");
+#endif
+    }
+
+    /**
+     * @brief calculateSurfacePartialFrom does the work of calculateSurfacePartial().
+     * Marching cubes runs on the cells to splice and, for normalMode::faceAverage, on one more ring of cells that only adds to the normals.
+     * The new vertices get matched with the ones of the last calculation by their edge, so triangles outside keep their vertex-indices.
+     */
+    template <class voxelSourceType>
+    bool calculateSurfacePartialFrom(const voxelSourceType& voxel, const axisAlignedBoxInt32& changed)
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+
+        // the quantized vertices alone can't get spliced without loss
+        if (!m_normalCorrection || m_vertices.empty() || m_cellTriangles.empty() || !changed.isValid())
+        {
+            return false;
+        }
+
+        // a cell reads the voxel from its position to its position+1. The border shares its vertices with those cells
+        vector3int32 spliceMin(changed.getMinimum() - vector3int32(2));
+        spliceMin = spliceMin.getMaximum(vector3int32(0));
+        vector3int32 spliceMax(changed.getMaximum() + vector3int32(1));
+        spliceMax = spliceMax.getMinimum(vector3int32(voxelLength-1));
+        const vector3int32 spliceSize(spliceMax - spliceMin + vector3int32(1));
+        if (spliceSize.x*spliceSize.y*spliceSize.z*2 > voxelLength*voxelLength*voxelLength)
+        {
+            return false;
+        }
+
+        m_remeshedFrom = m_revision;
+        m_revision = createRevision();
+        m_changedVertices = changedRange();
+        m_changedIndices = changedRange();
+        m_transitions.clear();
+        if (!(spliceMin <= spliceMax))
+        {
+            // only voxel outside of the tile changed, that no triangle reads
+            return true;
+        }
+
+        // faceAverage: the ring around the spliced cells completes the normals of their vertices
+        const bool gradient(m_normalMode == normalMode::gradient);
+        vector3int32 cellMin(spliceMin);
+        vector3int32 cellMax(spliceMax);
+        if (!gradient)
+        {
+            cellMin = (spliceMin - vector3int32(1)).getMaximum(vector3int32(-1));
+            cellMax = (spliceMax + vector3int32(1)).getMinimum(vector3int32(voxelLength));
+        }
+
+        // the edges get indexed relative to the voxel of the spliced cells and their ring
+        const vector3int32 edgesMin(spliceMin - vector3int32(1));
+        const vector3int32 edgesSize(spliceMax + vector3int32(3) - edgesMin);
+
+        reuseBuffer& buffer(getReuseBuffer());
+        vector<partialVertex>& vertices(buffer.verticesPartial);
+        vertices.clear();
+        vector<int32>& edges(buffer.edgesPartial);
+        edges.assign(edgesSize.x*edgesSize.y*edgesSize.z*3, -1);
+        // indices into vertices
+        vector<int32>& indices(buffer.indicesPartial);
+        indices.clear();
+        t_cellTriangles& cells(buffer.cellTrianglesPartial);
+        cells.clear();
+
+        const int8 isoLevel(0);
+        for (int32 x = cellMin.x; x <= cellMax.x; ++x)
+        {
+            for (int32 y = cellMin.y; y <= cellMax.y; ++y)
+            {
+                for (int32 z = cellMin.z; z <= cellMax.z; ++z)
+                {
+                    const vector3int32 posVoxel(x, y, z);
+
+                    uint8 tableIndex(0);
+                    for (int32 corner = 0; corner < 8; ++corner)
+                    {
+                        if (voxel.getVoxel(posVoxel + calculateCorner(corner)).getInterpolation() < isoLevel)
+                        {
+                            tableIndex |= 1 << corner;
+                        }
+                    }
+                    if (tableIndex == 0 || tableIndex == 255)
+                    {
+                        continue;
+                    }
+                    const bool toSplice(posVoxel >= spliceMin && posVoxel <= spliceMax);
+
+                    const RegularCellData *data = &regularCellData[regularCellClass[tableIndex]];
+                    int32 ids[12];
+                    for (int32 ind = 0; ind < data->GetVertexCount(); ++ind)
+                    {
+                        const int32 data2 = regularVertexData[tableIndex][ind];
+                        const int32 corner0 = data2 & 0x0F;
+                        const int32 corner1 = (data2 & 0xF0) >> 4;
+                        const vector3int32 posVoxel0(posVoxel + calculateCorner(corner0));
+                        const vector3int32 posVoxel1(posVoxel + calculateCorner(corner1));
+                        const int32 key(calculateEdgeKeyPartial(posVoxel0, posVoxel1, edgesMin, edgesSize));
+
+                        if (edges[key] == -1)
+                        {
+                            vector3 point = calculateIntersectionPosition(voxel, posVoxel, corner0, corner1);
+                            point *= m_voxelSize;
+                            const t_voxel& voxel0(voxel.getVoxel(posVoxel0));
+                            const t_voxel& voxel1(voxel.getVoxel(posVoxel1));
+                            vector3 normal;
+                            if (gradient)
+                            {
+                                normal = calculateGradientNormal(voxel, posVoxel0, posVoxel1);
+                            }
+
+                            partialVertex toAdd;
+                            toAdd.vertex = static_cast<t_thiz>(this)->createVertex(posVoxel, voxel0, voxel1, point, normal);
+                            toAdd.source.voxelPos = posVoxel;
+                            toAdd.source.voxel0 = posVoxel0;
+                            toAdd.source.voxel1 = posVoxel1;
+                            toAdd.key = key;
+                            toAdd.owner = calculateEdgeOwner(posVoxel, data2 >> 8);
+                            toAdd.edge = ((data2 >> 8) & 0x0F) - 1;
+                            toAdd.target = -1;
+                            vertices.push_back(toAdd);
+                            edges[key] = vertices.size()-1;
+                        }
+                        ids[ind] = edges[key];
+                        if (toSplice)
+                        {
+                            vertices[ids[ind]].target = -2;
+                        }
+                    }
+
+                    const int32 indicesBefore(indices.size());
+                    for (int32 ind = 0; ind < data->GetTriangleCount()*3; ind+=3)
+                    {
+                        const int32 vertexIndex0(ids[data->vertexIndex[ind+0]]);
+                        const int32 vertexIndex1(ids[data->vertexIndex[ind+1]]);
+                        const int32 vertexIndex2(ids[data->vertexIndex[ind+2]]);
+                        const vector3 vertex0(vertices[vertexIndex0].vertex.position);
+                        const vector3 vertex1(vertices[vertexIndex1].vertex.position);
+                        const vector3 vertex2(vertices[vertexIndex2].vertex.position);
+                        if (vertex0 == vertex1 || vertex0 == vertex2 || vertex1 == vertex2)
+                        {
+                            continue; // triangle with zero space
+                        }
+                        if (!gradient)
+                        {
+                            const vector3 addNormal = (vertex1 - vertex0).crossProduct(vertex2 - vertex0);
+                            vertices[vertexIndex0].vertex.normal += addNormal;
+                            vertices[vertexIndex1].vertex.normal += addNormal;
+                            vertices[vertexIndex2].vertex.normal += addNormal;
+                        }
+                        if (toSplice)
+                        {
+                            indices.push_back(vertexIndex0);
+                            indices.push_back(vertexIndex1);
+                            indices.push_back(vertexIndex2);
+                        }
+                    }
+                    if (static_cast<int32>(indices.size()) != indicesBefore)
+                    {
+                        cellTriangles toAdd;
+                        toAdd.cell = calculateCellId(posVoxel);
+                        toAdd.index = indicesBefore;
+                        cells.push_back(toAdd);
+                    }
+                }
+            }
+        }
+        for (partialVertex& work : vertices)
+        {
+            work.vertex.normal.normalise();
+        }
+
+        // the old vertices on the edges of the spliced cells and their ring
+        vector<int32>& edgesOld(buffer.edgesOld);
+        edgesOld.assign(edges.size(), -1);
+        vector<int32>& verticesOld(buffer.verticesOld);
+        verticesOld.clear();
+        for (int32 index = 0; index < static_cast<int32>(m_vertexSources.size()); ++index)
+        {
+            const vertexSource& source(m_vertexSources[index]);
+            const vector3int32 lower(vector3int32(source.voxel0).getMinimum(source.voxel1));
+            if (source.voxel0 == source.voxel1 || !(lower >= edgesMin && lower < edgesMin + edgesSize))
+            {
+                continue;
+            }
+            edgesOld[calculateEdgeKeyPartial(source.voxel0, source.voxel1, edgesMin, edgesSize)] = index;
+            // the cells sharing the edge
+            const vector3int32 cellsMin(lower - vector3int32(1) + (vector3int32(source.voxel1) - source.voxel0).getMaximum(source.voxel0 - source.voxel1));
+            if (cellsMin <= spliceMax && lower >= spliceMin)
+            {
+                verticesOld.push_back(index);
+            }
+        }
+
+        // vertices of the spliced cells replace the old vertex on the same edge, the others get a free place later
+        vector<int32>& verticesKeep(buffer.verticesKeep);
+        verticesKeep.clear();
+        for (partialVertex& work : vertices)
+        {
+            if (work.target == -2 && edgesOld[work.key] != -1)
+            {
+                work.target = edgesOld[work.key];
+                verticesKeep.push_back(work.target);
+            }
+        }
+
+        // old vertices on the edges of the spliced cells that didn't get replaced get free
+        std::sort(verticesKeep.begin(), verticesKeep.end());
+        vector<int32>& verticesFreed(buffer.verticesFreed);
+        verticesFreed.clear();
+        std::set_difference(verticesOld.begin(), verticesOld.end(), verticesKeep.begin(), verticesKeep.end(), std::back_inserter(verticesFreed));
+        for (const int32& freed : verticesFreed)
+        {
+            vertexSource& source(m_vertexSources[freed]);
+            source.voxel1 = source.voxel0;
+            m_freeVertices.push_back(freed);
+        }
+        if (m_lod > 0 && !verticesFreed.empty())
+        {
+            for (int32 face = 0; face < 6; ++face)
+            {
+                t_faceVertices& faceVertices(m_faceVertices[face]);
+                typename t_faceVertices::iterator it(faceVertices.begin());
+                for (const faceVertex& work : faceVertices)
+                {
+                    if (!std::binary_search(verticesFreed.cbegin(), verticesFreed.cend(), work.vertex))
+                    {
+                        *it = work;
+                        ++it;
+                    }
+                }
+                faceVertices.erase(it, faceVertices.end());
+            }
+        }
+
+        // write the vertices
+        int32 changedMin(m_vertices.size());
+        int32 changedMax(-1);
+        for (partialVertex& work : vertices)
+        {
+            if (work.target == -1)
+            {
+                continue;
+            }
+            if (work.target == -2)
+            {
+                if (m_freeVertices.empty())
+                {
+                    work.target = m_vertices.size();
+                    m_vertices.push_back(work.vertex);
+                    m_vertexSources.push_back(work.source);
+                }
+                else
+                {
+                    work.target = m_freeVertices.back();
+                    m_freeVertices.pop_back();
+                }
+                if (m_lod > 0)
+                {
+                    addVertexOnFacesPartial(work.owner, work.edge, work.target);
+                }
+            }
+            m_vertices[work.target] = work.vertex;
+            m_vertexSources[work.target] = work.source;
+            changedMin = math::min(changedMin, work.target);
+            changedMax = math::max(changedMax, work.target);
+        }
+        if (changedMax != -1)
+        {
+            m_changedVertices.first = changedMin;
+            m_changedVertices.count = changedMax - changedMin + 1;
+        }
+        if (m_vertexFormat == vertexFormat::fullAndQuantized)
+        {
+            m_verticesQuantized.resize(m_vertices.size());
+            for (int32 index = changedMin; index <= changedMax; ++index)
+            {
+                const t_vertex& workVertex(m_vertices[index]);
+                m_verticesQuantized[index] = t_vertexQuantized::encode(workVertex.position, workVertex.normal, m_dequantization);
+            }
+        }
+
+        // splice the triangles, the cells in between the first and the last spliced cell get copied
+        cellTriangles toFind;
+        toFind.cell = calculateCellId(spliceMin);
+        const typename t_cellTriangles::const_iterator oldBegin(std::lower_bound(m_cellTriangles.cbegin(), m_cellTriangles.cend(), toFind));
+        toFind.cell = calculateCellId(spliceMax);
+        const typename t_cellTriangles::const_iterator oldEnd(std::upper_bound(m_cellTriangles.cbegin(), m_cellTriangles.cend(), toFind));
+        const int32 indexBegin(oldBegin == m_cellTriangles.cend() ? m_indices.size() : oldBegin->index);
+        const int32 indexEnd(oldEnd == m_cellTriangles.cend() ? m_indices.size() : oldEnd->index);
+
+        t_indices& resultIndices(buffer.indicesSplice);
+        resultIndices.clear();
+        resultIndices.reserve(m_indices.size() + indices.size());
+        resultIndices.insert(resultIndices.end(), m_indices.cbegin(), m_indices.cbegin() + indexBegin);
+        t_cellTriangles& resultCells(buffer.cellTrianglesSplice);
+        resultCells.clear();
+        resultCells.reserve(m_cellTriangles.size() + cells.size());
+        resultCells.insert(resultCells.end(), m_cellTriangles.cbegin(), oldBegin);
+
+        typename t_cellTriangles::const_iterator itOld(oldBegin);
+        typename t_cellTriangles::const_iterator itNew(cells.cbegin());
+        while (itOld != oldEnd || itNew != cells.cend())
+        {
+            cellTriangles toAdd;
+            toAdd.index = resultIndices.size();
+            if (itOld == oldEnd || (itNew != cells.cend() && itNew->cell < itOld->cell))
+            {
+                toAdd.cell = itNew->cell;
+                const int32 end(itNew+1 == cells.cend() ? indices.size() : (itNew+1)->index);
+                for (int32 index = itNew->index; index < end; ++index)
+                {
+                    resultIndices.push_back(vertices[indices[index]].target);
+                }
+                ++itNew;
+            }
+            else
+            {
+                const bool spliced(isCellInside(itOld->cell, spliceMin, spliceMax));
+                toAdd.cell = itOld->cell;
+                const int32 end(itOld+1 == m_cellTriangles.cend() ? m_indices.size() : (itOld+1)->index);
+                const int32 begin(itOld->index);
+                ++itOld;
+                if (spliced)
+                {
+                    continue;
+                }
+                resultIndices.insert(resultIndices.end(), m_indices.cbegin() + begin, m_indices.cbegin() + end);
+            }
+            resultCells.push_back(toAdd);
+        }
+
+        const int32 shift(resultIndices.size() - indexEnd);
+        m_changedIndices.first = indexBegin;
+        m_changedIndices.count = resultIndices.size() - indexBegin;
+        if (shift != 0)
+        {
+            m_changedIndices.count += m_indices.size() - indexEnd;
+        }
+        resultIndices.insert(resultIndices.end(), m_indices.cbegin() + indexEnd, m_indices.cend());
+        for (typename t_cellTriangles::const_iterator it(oldEnd); it != m_cellTriangles.cend(); ++it)
+        {
+            cellTriangles toAdd(*it);
+            toAdd.index += shift;
+            resultCells.push_back(toAdd);
+        }
+        copyExactly(resultIndices, m_indices);
+        copyExactly(resultCells, m_cellTriangles);
+
+        return true;
+    }
+    /**
+     * @brief calculateTransitionFace calculates the transvoxel-cells of one face, called by getTransitionFace().
+     * The marching cubes vertices on the face get reused by m_faceVertices and copied to the face, so every face is a mesh on its own.
+     */
+    void calculateTransitionFace(const int32& lod, transitionFace& result) const
+    {
+        BASSERT(!m_voxelLod.isNull());
+
+        // createVertexLod() of derived classes isn't const, calculating a face doesn't change the results of the other getters though
+        const t_thiz thiz(static_cast<t_thiz>(const_cast<surface*>(this)));
+        const real& voxelSize(m_voxelSize);
+        const int8 isoLevel(0);
+
+        reuseBuffer& buffer(getReuseBuffer());
+        t_vertices& vertices(buffer.verticesFace);
+        vertices.clear();
+        t_indices& indices(buffer.indicesFace);
+        indices.clear();
+        // the index in vertices for every entry of m_faceVertices[lod]
+        const t_faceVertices& faceVertices(m_faceVertices[lod]);
+        vector<int32>& faceVerticesLocal(buffer.faceVerticesLocal);
+        faceVerticesLocal.assign(faceVertices.size(), -1);
+
+        typedef vector3int32 v3i;
+        const vector3int32 voxelLookups[][9] = {
+            {v3i(0, 0, 0),v3i(0, 1, 0),v3i(0, 2, 0),v3i(0, 2, 1),v3i(0, 2, 2),v3i(0, 1, 2),v3i(0, 0, 2),v3i(0, 0, 1),v3i(0, 1, 1)},
+            {v3i(0, 0, 0),v3i(1, 0, 0),v3i(2, 0, 0),v3i(2, 0, 1),v3i(2, 0, 2),v3i(1, 0, 2),v3i(0, 0, 2),v3i(0, 0, 1),v3i(1, 0, 1)},
+            {v3i(0, 0, 0),v3i(1, 0, 0),v3i(2, 0, 0),v3i(2, 1, 0),v3i(2, 2, 0),v3i(1, 2, 0),v3i(0, 2, 0),v3i(0, 1, 0),v3i(1, 1, 0)},
+            };
+        const int32 voxelLengthLodStart(t_voxelAccessor::voxelLengthLod-2);
+        const int32 voxelLengthLodEnd(t_voxelAccessor::voxelLengthLod-1);
+        const vector3int32 toIterate[][2] = {
+            {v3i(0, 0, 0),                     v3i(1, voxelLengthLodStart, voxelLengthLodStart)},
+            {v3i(voxelLengthLodStart, 0, 0),   v3i(voxelLengthLodEnd, voxelLengthLodStart, voxelLengthLodStart)},
+            {v3i(0, 0, 0),                     v3i(voxelLengthLodStart, 1, voxelLengthLodStart)},
+            {v3i(0, voxelLengthLodStart, 0),   v3i(voxelLengthLodStart, voxelLengthLodEnd, voxelLengthLodStart)},
+            {v3i(0, 0, 0),                     v3i(voxelLengthLodStart, voxelLengthLodStart, 1)},
+            {v3i(0, 0, voxelLengthLodStart),   v3i(voxelLengthLodStart, voxelLengthLodStart, voxelLengthLodEnd)}
+            };
+        const vector3int32 reuseCorrection[] = {
+            v3i(1, 0, 0),
+            v3i(1, 0, 0),
+            v3i(0, 1, 0),
+            v3i(0, 1, 0),
+            v3i(0, 0, 1),
+            v3i(0, 0, 1)
+            };
+
+        const bool toInvertTriangles[] = {
+            false, true,
+            true, false, // data from Eric Lengyel seems to have different axis-desc
+            false, true
+            };
+
+            const int32 coord(lod/2);
+            const vector3int32& start(toIterate[lod][0]);
+            const vector3int32& end  (toIterate[lod][1]);
+            const bool invertTriangles(toInvertTriangles[lod]);
+
+            // the indexer for the vertices of the current and the last row. *4 because gets saved with edge-id
+            vector<int32>& vertexIndicesReuseLod(buffer.vertexIndicesLod);
+            std::fill(vertexIndicesReuseLod.begin(), vertexIndicesReuseLod.end(), -1);
+            const int32 rowSize(vertexIndicesReuseLod.size()/2);
+            int32 rowLast(-1);
+
+            for (uint32 x = start.x; x < (unsigned)end.x; x+=2)
+            {
+                for (uint32 y = start.y; y < (unsigned)end.y; y+=2)
+                {
+                    for (uint32 z = start.z; z < (unsigned)end.z; z+=2)
+                    {
+                        const vector3int32 voxelPos(x, y, z);
+                        // rows run along the first face-coordinate, see calculateEdgeIdTransvoxel()
+                        const int32 row((coord == 0 ? y : x) / 2);
+                        if (row != rowLast)
+                        {
+                            const vector<int32>::iterator toClear(vertexIndicesReuseLod.begin() + ((row+1) & 1)*rowSize);
+                            std::fill(toClear, toClear + rowSize, -1);
+                            rowLast = row;
+                        }
+                        {
+                            uint32 tableIndex(0);
+                            uint32 add(1);
+                            t_calcVoxelLod voxelCalc;
+                            for (uint16 ind = 0; ind < 9; ++ind)
+                            {
+                                const vector3int32 lookUp((voxelPos-start)+voxelLookups[coord][ind]);
+                                voxelCalc[ind] = getVoxelLod(lookUp, lod);
+                                if (voxelCalc[ind].getInterpolation() < isoLevel)
+                                {
+                                    tableIndex |= add;
+                                }
+                                add*=2;
+                            }
+                            if (tableIndex == 0 || tableIndex == 511) // no triangles
+                            {
+                                continue;
+                            }
+
+                            uint32 classIndex = transitionCellClass[tableIndex];
+                            const TransitionCellData *data = &transitionCellData[classIndex & 0x7F]; // only the last 7 bit count
+                            uint32 ids[12];
+
+                            vector3 normalsForTransvoxel[4];
+
+                            for (uint16 ind = 0; ind < data->GetVertexCount(); ++ind)
+                            {
+                                const uint16 data2 = transitionVertexData[tableIndex][ind];
+                                const uint16 edge = data2 >> 8;
+                                const uint16 edgeId = edge & 0x0F;
+                                const uint16 edgeBetween(data2 & 0xFF);
+
+                                if (edgeId == 0x9 || edgeId == 0x8)
+                                {
+                                    BASSERT(edge == 0x88 || edge == 0x28 || edge == 0x89 || edge == 0x19);
+
+                                    const uint16 owner((edge & 0xF0) >> 4);
+                                    BASSERT(owner == 1 || owner == 2 || owner == 8);
+
+                                    uint16 newEdgeId(0);
+                                    uint16 newOwner(0);
+
+                                    if (coord == 0)
+                                    {
+                                        if (edgeId == 0x8)
+                                        {
+                                            newEdgeId = 0x3;
+                                        }
+                                        else
+                                        {
+                                            newEdgeId = 0x1;
+                                        }
+                                        if (owner == 0x1)
+                                        {
+                                            newOwner = 0x4;
+                                        }
+                                        if (owner == 0x2)
+                                        {
+                                            newOwner = 0x2;
+                                        }
+                                    }
+                                    if (coord == 1)
+                                    {
+                                        if (edgeId == 0x8)
+                                        {
+                                            newEdgeId = 0x2;
+                                        }
+                                        else
+                                        {
+                                            newEdgeId = 0x1;
+                                        }
+                                        newOwner = owner;
+                                    }
+                                    if (coord == 2)
+                                    {
+                                        newEdgeId = edgeId - 6;
+                                        if (owner == 0x1)
+                                        {
+                                            newOwner = 0x1;
+                                        }
+                                        if (owner == 0x2)
+                                        {
+                                            newOwner = 0x4;
+                                        }
+                                    }
+
+
+                                    uint16 newEdge((newOwner << 4) | newEdgeId);
+                                    const vector3int32 ownerVoxel(calculateEdgeOwner((voxelPos / 2) - reuseCorrection[lod], newEdge));
+                                    const int32 id(calculateVertexIdFace(lod, ownerVoxel, newEdgeId-1));
+
+                                    ids[ind] = addFaceVertex(id, faceVertices, faceVerticesLocal, vertices);
+
+                                    const vector3& normal(vertices[ids[ind]].normal);
+                                    switch (edgeBetween)
+                                    {
+                                    case 0x9A:
+                                        normalsForTransvoxel[0] = normal;
+                                        break;
+                                    case 0xAC:
+                                        normalsForTransvoxel[1] = normal;
+                                        break;
+                                    case 0xBC:
+                                        normalsForTransvoxel[2] = normal;
+                                        break;
+                                    case 0x9B:
+                                        normalsForTransvoxel[3] = normal;
+                                        break;
+                                    default:
+                                        BASSERT(false);
+                                    }
+                                }
+                            }
+                            for (uint16 ind = 0; ind < data->GetVertexCount(); ++ind)
+                            {
+                                const uint16 data2 = transitionVertexData[tableIndex][ind];
+                                const uint16 edge = data2 >> 8;
+                                const uint16 edgeId = edge & 0x0F;
+                                const uint16 edgeBetween(data2 & 0xFF);
+
+                                if (edgeId != 0x9 && edgeId != 0x8)
+                                {
+                                    const uint16 corner0 = data2 & 0x0F;
+                                    const uint16 corner1 = (data2 & 0xF0) >> 4;
+
+
+                                    const int32 id = calculateEdgeIdTransvoxel(voxelPos/2, edge, coord);
+
+                                    //blub::BOUT("edge:" + blub::string::number(edge, 16) + " id:" + blub::string::number(id));
+
+                                    bool calculateVertexPosition(id == -1);
+                                    if (!calculateVertexPosition)
+                                    {
+                                        calculateVertexPosition = vertexIndicesReuseLod[id] == -1;
+                                    }
+
+                                    if (calculateVertexPosition)
+                                    {
+                                        vector3 point = calculateIntersectionPositionTransvoxel(voxelPos-start, corner0, corner1, voxelLookups[coord], lod);
+                                        point+=vector3(start)/2.;
+
+                                        point *= voxelSize;
+
+                                        vector3 normal;
+
+                                        switch (edgeBetween)
+                                        {
+                                        case 0x01:
+                                        case 0x12:
+                                            normal = normalsForTransvoxel[0];
+                                            break;
+                                        case 0x03:
+                                        case 0x36:
+                                            normal = normalsForTransvoxel[3];
+                                            break;
+                                        case 0x25:
+                                        case 0x58:
+                                            normal = normalsForTransvoxel[1];
+                                            break;
+                                        case 0x67:
+                                        case 0x78:
+                                            normal = normalsForTransvoxel[2];
+                                            break;
+                                        case 0x34:
+                                        case 0x14:
+                                        case 0x45:
+                                        case 0x47:
+                                            normal = normalsForTransvoxel[0] + normalsForTransvoxel[1] + normalsForTransvoxel[2] + normalsForTransvoxel[3];
+                                            break;
+                                        default:
+                                            BASSERT(false);
+                                        }
+
+                                        const vector3int32 posVoxel0(voxelPos-start + calculateCornerTransvoxel(corner0, voxelLookups[coord]));
+                                        const vector3int32 posVoxel1(voxelPos-start + calculateCornerTransvoxel(corner1, voxelLookups[coord]));
+                                        t_voxel voxel0 = getVoxelLod(posVoxel0, lod); // OPTIMISE so dirty - use voxelCalc!
+                                        t_voxel voxel1 = getVoxelLod(posVoxel1, lod);
+                                        const t_vertex vertex(thiz->createVertexLod(voxelPos, voxel0, voxel1, point, normal));
+                                        vertices.push_back(vertex);
+
+                                        if (id == -1)
+                                        {
+                                            ids[ind] = vertices.size()-1;
+                                        }
+                                        else
+                                        {
+                                            ids[ind] = vertexIndicesReuseLod[id] = vertices.size()-1;
+                                        }
+                                    }
+                                    else
+                                    {
+                                        ids[ind] = vertexIndicesReuseLod[id];
+                                    }
+                                }
+                            }
+                            for (uint16 ind = 0; ind < data->GetTriangleCount()*3; ind+=3)
+                            {
+                                // calc triangle
+                                const int32 vertexIndex0(ids[data->vertexIndex[ind+0]]);
+                                const int32 vertexIndex1(ids[data->vertexIndex[ind+1]]);
+                                const int32 vertexIndex2(ids[data->vertexIndex[ind+2]]);
+                                const vector3 vertex0(vertices.at(vertexIndex0).position);
+                                const vector3 vertex1(vertices.at(vertexIndex1).position);
+                                const vector3 vertex2(vertices.at(vertexIndex2).position);
+                                if (vertex0 == vertex1 || vertex1 == vertex2 || vertex0 == vertex2)
+                                {
+                                    continue; // triangle with zero space
+                                }
+                                // insert new triangle
+                                uint16 invert(1);
+                                if (invertTriangles)
+                                {
+                                    invert = 0;
+                                }
+                                indices.push_back(vertexIndex0);
+                                if ((classIndex >> 7) % 2 == invert)
+                                {
+                                    indices.push_back(vertexIndex1);
+                                    indices.push_back(vertexIndex2);
+                                }
+                                else
+                                {
+                                    indices.push_back(vertexIndex2);
+                                    indices.push_back(vertexIndex1);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+        // normalise normals
+        for (t_vertex& workVertex : vertices)
+        {
+            workVertex.normal.normalise();
+        }
+
+        if (m_vertexFormat != vertexFormat::full)
+        {
+            result.verticesQuantized.reserve(vertices.size());
+            for (const t_vertex& workVertex : vertices)
+            {
+                result.verticesQuantized.push_back(t_vertexQuantized::encode(workVertex.position, workVertex.normal, m_dequantization));
+            }
+        }
+        if (m_vertexFormat != vertexFormat::quantized)
+        {
+            copyExactly(vertices, result.vertices);
+        }
+        copyExactly(indices, result.indices);
+    }
+    /**
+     * @brief addFaceVertex copies a marching cubes vertex on the face to vertices, once per face.
+     * @param id See calculateVertexIdFace().
+     * @return The index in vertices.
+     */
+    int32 addFaceVertex(const int32& id, const t_faceVertices& faceVertices, vector<int32>& faceVerticesLocal, t_vertices& vertices) const
+    {
+        faceVertex toFind;
+        toFind.id = id;
+        const typename t_faceVertices::const_iterator it(std::lower_bound(faceVertices.begin(), faceVertices.end(), toFind));
+        BASSERT(it != faceVertices.end() && it->id == id);
+
+        int32& result(faceVerticesLocal[it - faceVertices.begin()]);
+        if (result == -1)
+        {
+            vertices.push_back(getVertex(it->vertex));
+            result = vertices.size()-1;
+        }
+        return result;
+    }
+    /**
+     * @brief calculateVertexId calculates getVertexId(). A marching cubes vertex is identified by its edge.
+     * A vertex exactly on a voxel gets created by every crossing edge of the voxel, the neighbour may use another one. So it is identified by the voxel.
+     * @param index
+     * @param voxelStart Absolute voxel-position of the voxel 0 of the tile.
+     */
+    uint64 calculateVertexId(const int32& index, const vector3int32& voxelStart) const
+    {
+        const vertexSource& source(m_vertexSources[index]);
+        const vector3 position(getVertex(index).position);
+        if (position == vector3(source.voxel0)*m_voxelSize)
+        {
+            return packVertexId(voxelStart + source.voxel0, 3);
+        }
+        if (position == vector3(source.voxel1)*m_voxelSize)
+        {
+            return packVertexId(voxelStart + source.voxel1, 3);
+        }
+
+        const vector3int32 edge(source.voxel1 - source.voxel0);
+        BASSERT(edge.x*edge.x + edge.y*edge.y + edge.z*edge.z == 1);
+        const int32 axis(edge.x != 0 ? 0 : (edge.y != 0 ? 1 : 2));
+        return packVertexId(voxelStart + vector3int32(source.voxel0).getMinimum(source.voxel1), axis);
+    }
+    /**
+     * @brief packVertexId packs an absolute voxel-position and a kind (0 to 7) to 64 bit, 20 bit per coordinate.
+     */
+    static uint64 packVertexId(const vector3int32& pos, const int32& kind)
+    {
+        const int32 range(1 << 19);
+        BASSERT(pos >= vector3int32(-range));
+        BASSERT(pos < vector3int32(range));
+        BASSERT(kind >= 0 && kind < 8);
+        return (static_cast<uint64>(pos.x + range) << 43) |
+               (static_cast<uint64>(pos.y + range) << 23) |
+               (static_cast<uint64>(pos.z + range) << 3) |
+               static_cast<uint64>(kind);
+    }
+    /**
+     * @brief getVertex returns a marching cubes vertex. Decodes it if the vertex-format is vertexFormat::quantized.
+     */
+    t_vertex getVertex(const int32& index) const
+    {
+        if (!m_vertices.empty())
+        {
+            return m_vertices[index];
+        }
+        const t_vertexQuantized& quantized(m_verticesQuantized[index]);
+        t_vertex result;
+        result.position = quantized.decodePosition(m_dequantization);
+        result.normal = quantized.decodeNormal();
+        return result;
+    }
+    /**
+     * @brief updateVertexAttributesFrom recreates all vertices, called by updateVertexAttributes(). Set m_voxelLod before.
+     */
+    template <class voxelSourceType>
+    void updateVertexAttributesFrom(const voxelSourceType& voxel)
+    {
+        if (m_vertices.empty() && !m_verticesQuantized.empty())
+        {
+            // vertexFormat::quantized released the float vertices, position and normal get decoded
+            m_vertices.reserve(m_verticesQuantized.size());
+            for (const t_vertexQuantized& quantized : m_verticesQuantized)
+            {
+                t_vertex decoded;
+                decoded.position = quantized.decodePosition(m_dequantization);
+                decoded.normal = quantized.decodeNormal();
+                m_vertices.push_back(decoded);
+            }
+        }
+        BASSERT(m_vertexSources.size() == m_vertices.size());
+
+        for (uint32 index = 0; index < m_vertices.size(); ++index)
+        {
+            const vertexSource& source(m_vertexSources[index]);
+            if (source.voxel0 == source.voxel1)
+            {
+                continue; // unused, see calculateSurfacePartial()
+            }
+            const t_vertex& oldVertex(m_vertices[index]);
+            const t_voxel& voxel0(voxel.getVoxel(source.voxel0));
+            const t_voxel& voxel1(voxel.getVoxel(source.voxel1));
+            BASSERT((voxel0.getInterpolation() < 0) != (voxel1.getInterpolation() < 0));
+
+            m_vertices[index] = static_cast<t_thiz>(this)->createVertex(source.voxelPos, voxel0, voxel1, oldVertex.position, oldVertex.normal);
+        }
+        // the faces copied the old vertices
+        m_transitions.clear();
+
+        if (m_vertexFormat != vertexFormat::full)
+        {
+            quantizeVertices();
+        }
+        if (m_vertexFormat == vertexFormat::quantized)
+        {
+            t_vertices().swap(m_vertices);
+        }
+
+        m_revision = createRevision();
+        m_remeshedFrom = 0;
+        setChangedAll();
+    }
+    /**
+     * @brief moveResultsToArena swaps the empty result-lists with the arena of the thread and empties the arena.
+     */
+    void moveResultsToArena(reuseBuffer& buffer)
+    {
+        m_vertices.swap(buffer.vertices);
+        m_vertices.clear();
+        m_vertexSources.swap(buffer.vertexSources);
+        m_vertexSources.clear();
+        m_indices.swap(buffer.indices);
+        m_indices.clear();
+        m_cellTriangles.swap(buffer.cellTriangles);
+        m_cellTriangles.clear();
+    }
+    /**
+     * @brief moveResultsFromArena gives the arena back to the thread and copies the results exactly sized to the tile.
+     * With vertexFormat::quantized the float vertices don't get copied.
+     */
+    void moveResultsFromArena(reuseBuffer& buffer)
+    {
+        m_vertices.swap(buffer.vertices);
+        if (m_vertexFormat != vertexFormat::quantized)
+        {
+            copyExactly(buffer.vertices, m_vertices);
+        }
+        m_vertexSources.swap(buffer.vertexSources);
+        copyExactly(buffer.vertexSources, m_vertexSources);
+        m_indices.swap(buffer.indices);
+        copyExactly(buffer.indices, m_indices);
+        m_cellTriangles.swap(buffer.cellTriangles);
+        copyExactly(buffer.cellTriangles, m_cellTriangles);
+    }
+    /**
+     * @brief calculateVerticesLocked marks the vertices decimate() mustn't move: the ones on the faces of the tile, they are shared with the neighbours.
+     * @param locked Gets resized to the number of vertices.
+     */
+    void calculateVerticesLocked(vector<uint8>& locked) const
+    {
+        locked.resize(m_vertices.size());
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        for (int32 index = 0; index < static_cast<int32>(m_vertexSources.size()); ++index)
+        {
+            const vertexSource& source(m_vertexSources[index]);
+            locked[index] = 0;
+            for (int32 coord = 0; coord < 3; ++coord)
+            {
+                if (source.voxel0[coord] == source.voxel1[coord] && (source.voxel0[coord] == 0 || source.voxel0[coord] == voxelLength))
+                {
+                    locked[index] = 1;
+                }
+            }
+        }
+    }
+    /**
+     * @brief decimate reduces the triangles of m_indices, see setDecimation(). Call it before quantizeVertices().
+     * Afterwards m_vertices contains only the vertices used by a triangle, by m_faceVertices or locked by calculateVerticesLocked(); m_cellTriangles gets cleared.
+     * @param buffer
+     * @param maxError In voxel of the lod of the tile.
+     * @return remap[oldIndex] is the new index of a vertex or -1 if it got removed, for the lists of a derived class.
+     */
+    const vector<int32>& decimate(reuseBuffer& buffer, const real& maxError)
+    {
+        vector<uint8>& locked(buffer.verticesLocked);
+        static_cast<t_thiz>(this)->calculateVerticesLocked(locked);
+        buffer.decimator.decimate(m_vertices, m_indices, locked, maxError*m_voxelSize);
+
+        // remove the vertices no triangle uses anymore, and the ones of the normal-correction
+        vector<int32>& remap(buffer.remap);
+        remap.assign(m_vertices.size(), -1);
+        for (int32 index = 0; index < static_cast<int32>(locked.size()); ++index)
+        {
+            if (locked[index] != 0)
+            {
+                remap[index] = 0;
+            }
+        }
+        for (const typename t_indices::value_type& index : m_indices)
+        {
+            remap[index] = 0;
+        }
+        for (int32 lod = 0; lod < 6; ++lod)
+        {
+            for (const faceVertex& work : m_faceVertices[lod])
+            {
+                remap[work.vertex] = 0;
+            }
+        }
+        int32 numVertices(0);
+        for (int32 index = 0; index < static_cast<int32>(remap.size()); ++index)
+        {
+            if (remap[index] == -1)
+            {
+                continue;
+            }
+            remap[index] = numVertices;
+            m_vertices[numVertices] = m_vertices[index];
+            m_vertexSources[numVertices] = m_vertexSources[index];
+            ++numVertices;
+        }
+        m_vertices.resize(numVertices);
+        m_vertexSources.resize(numVertices);
+
+        for (typename t_indices::value_type& index : m_indices)
+        {
+            index = remap[index];
+        }
+        for (int32 lod = 0; lod < 6; ++lod)
+        {
+            for (faceVertex& work : m_faceVertices[lod])
+            {
+                work.vertex = remap[work.vertex];
+            }
+        }
+        m_cellTriangles.clear();
+
+        return remap;
+    }
+    /**
+     * @brief optimizeVertexCache reorders m_indices for the vertex-cache and m_vertices in order of their first use, see setOptimizeVertexCache().
+     * Call it before quantizeVertices(). m_vertexSources and m_faceVertices get remapped, m_cellTriangles gets cleared, because the triangles of a cell aren't in one piece anymore.
+     * @param buffer
+     * @return remap[oldIndex] is the new index of a vertex, for the lists of a derived class.
+     */
+    const vector<int32>& optimizeVertexCache(reuseBuffer& buffer)
+    {
+        buffer.optimizer.optimize(m_indices, m_vertices.size());
+        internal::vertexCacheOptimizer::calculateFetchRemap(m_indices, m_vertices.size(), buffer.remap);
+        const vector<int32>& remap(buffer.remap);
+
+        t_vertices& vertices(buffer.verticesOptimized);
+        vertices.resize(m_vertices.size());
+        t_vertexSources& vertexSources(buffer.vertexSourcesOptimized);
+        vertexSources.resize(m_vertexSources.size());
+        for (int32 index = 0; index < static_cast<int32>(remap.size()); ++index)
+        {
+            vertices[remap[index]] = m_vertices[index];
+            vertexSources[remap[index]] = m_vertexSources[index];
+        }
+        // the old lists stay in the arena
+        m_vertices.swap(vertices);
+        m_vertexSources.swap(vertexSources);
+
+        for (typename t_indices::value_type& index : m_indices)
+        {
+            index = remap[index];
+        }
+        for (int32 lod = 0; lod < 6; ++lod)
+        {
+            for (faceVertex& work : m_faceVertices[lod])
+            {
+                work.vertex = remap[work.vertex];
+            }
+        }
+        m_cellTriangles.clear();
+
+        return remap;
+    }
+    /**
+     * @brief optimizeVertexCacheFace does the same as optimizeVertexCache() for a transvoxel-face.
+     * @param toOptimize
+     */
+    void optimizeVertexCacheFace(transitionFace& toOptimize) const
+    {
+        const int32 numVertices(toOptimize.vertices.empty() ? toOptimize.verticesQuantized.size() : toOptimize.vertices.size());
+        reuseBuffer& buffer(getReuseBuffer());
+        buffer.optimizer.optimize(toOptimize.indices, numVertices);
+        internal::vertexCacheOptimizer::calculateFetchRemap(toOptimize.indices, numVertices, buffer.remap);
+        const vector<int32>& remap(buffer.remap);
+
+        if (!toOptimize.vertices.empty())
+        {
+            t_vertices& vertices(buffer.verticesOptimized);
+            vertices.resize(numVertices);
+            for (int32 index = 0; index < numVertices; ++index)
+            {
+                vertices[remap[index]] = toOptimize.vertices[index];
+            }
+            std::copy(vertices.cbegin(), vertices.cend(), toOptimize.vertices.begin());
+        }
+        if (!toOptimize.verticesQuantized.empty())
+        {
+            t_verticesQuantized& vertices(buffer.verticesQuantizedOptimized);
+            vertices.resize(numVertices);
+            for (int32 index = 0; index < numVertices; ++index)
+            {
+                vertices[remap[index]] = toOptimize.verticesQuantized[index];
+            }
+            std::copy(vertices.cbegin(), vertices.cend(), toOptimize.verticesQuantized.begin());
+        }
+        for (typename t_indices::value_type& index : toOptimize.indices)
+        {
+            index = remap[index];
+        }
+    }
+    template <typename listType>
+    static void copyExactly(const listType& from, listType& to)
+    {
+        listType result;
+        result.reserve(from.size());
+        result.insert(result.end(), from.begin(), from.end());
+        to.swap(result);
+    }
+    /**
+     * @brief calculateDequantization returns a fixed grid for all tiles of the same voxelSize, so vertices on a tile-border quantize the same in both tiles.
+     * The grid covers the voxel from -2 to voxelLength+2 and has a power of two steps per voxel.
+     */
+    static t_dequantization calculateDequantization(const real& voxelSize)
+    {
+        const int32 voxelRange(t_voxelAccessor::voxelLength+4);
+        int32 stepsPerVoxel(1);
+        while (voxelRange*stepsPerVoxel*2 <= 65535)
+        {
+            stepsPerVoxel *= 2;
+        }
+
+        t_dequantization result;
+        result.offset = vector3(-2.*voxelSize);
+        result.scale = voxelSize / stepsPerVoxel;
+        return result;
+    }
+    /**
+     * @brief quantizeVertices fills m_verticesQuantized by m_vertices.
+     */
+    void quantizeVertices()
+    {
+        t_verticesQuantized result;
+        result.reserve(m_vertices.size());
+        for (const t_vertex& workVertex : m_vertices)
+        {
+            result.push_back(t_vertexQuantized::encode(workVertex.position, workVertex.normal, m_dequantization));
+        }
+        m_verticesQuantized.swap(result);
+    }
+    void addVertexSource(const vector3int32& voxelPos, const vector3int32& voxel0, const vector3int32& voxel1)
+    {
+        vertexSource source;
+        source.voxelPos = voxelPos;
+        source.voxel0 = voxel0;
+        source.voxel1 = voxel1;
+        m_vertexSources.push_back(source);
+    }
+    /**
+     * @brief getTransitionFace returns a face, calculates it on the first call.
+     */
+    const transitionFace& getTransitionFace(const int32& lod) const
+    {
+        BASSERT(lod >= 0);
+        BASSERT(lod < 6);
+
+        async::mutexLocker locker(m_transitions.mutex);
+        transitionFace& result(m_transitions.faces[lod]);
+        if (!result.calculated)
+        {
+            if (m_lod > 0)
+            {
+                static_cast<const typename t_config::t_surface::t_tile*>(this)->calculateTransitionFace(lod, result);
+                if (m_optimizeVertexCache)
+                {
+                    optimizeVertexCacheFace(result);
+                }
+            }
+            result.calculated = true;
+        }
+        return result;
     }
     const t_voxel &getVoxelLod(const vector3int32& pos, const uint16 &lod) const
     {
-        return m_voxel->getVoxelLod(pos, lod);
+        return (*m_voxelLod)[t_voxelAccessor::calculateIndexLod(pos, lod)];
     }
     const int8 &getVoxelInterpolationLod(const vector3int32& pos, const uint16 &lod) const
     {
         return getVoxelLod(pos, lod).getInterpolation();
     }
-    int32 calculateEdgeId(const vector3int32& pos, const int32& edgeInformation) const
+    vector3int32 calculateEdgeOwner(const vector3int32& pos, const int32& edgeInformation) const
     {
         const int32 edge(edgeInformation & 0x0F);
         const int32 owner((edgeInformation & 0xF0) >> 4);
@@ -629,7 +2111,10 @@ private:
         BASSERT((diffY == 0) || (diffY == 1));
         BASSERT((diffZ == 0) || (diffZ == 1));
 
-        return calculateVertexId(pos - vector3int32(diffX, diffY, diffZ)) + (edge-1);
+        BASSERT(edge >= 1);
+        BASSERT(edge <= 3);
+
+        return pos - vector3int32(diffX, diffY, diffZ);
     }
     int32 calculateEdgeIdTransvoxel(const vector3int32& pos, const int32& edgeInformation, const int32& coord) const
     {
@@ -664,30 +2149,173 @@ private:
     }
     int32 calculateVertexId(const vector3int32& pos) const
     {
-        return (
-                ((pos.x+2)*3) * ((t_voxelAccessor::voxelLengthWithNormalCorrection)*3)*((t_voxelAccessor::voxelLengthWithNormalCorrection)*3) +
-                ((pos.y+2)*3) * ((t_voxelAccessor::voxelLengthWithNormalCorrection)*3) +
-                ((pos.z+2)*3)
-                );
+        const int32 length(t_voxelAccessor::voxelLengthWithNormalCorrection);
+        return ((((pos.x+2) & 1)*length + (pos.y+2))*length + (pos.z+2))*3;
+    }
+    int32 calculateVertexIdFace(const int32& face, const vector3int32& owner, const int32& edge) const
+    {
+        const int32 length(t_voxelAccessor::voxelLengthWithNormalCorrection);
+        vector2int32 pos;
+        switch (face/2)
+        {
+        case 0:
+            BASSERT(owner.x == (face % 2 == 0 ? -1 : t_voxelAccessor::voxelLength-1));
+            pos = vector2int32(owner.y, owner.z);
+            break;
+        case 1:
+            BASSERT(owner.y == (face % 2 == 0 ? -1 : t_voxelAccessor::voxelLength-1));
+            pos = vector2int32(owner.x, owner.z);
+            break;
+        case 2:
+            BASSERT(owner.z == (face % 2 == 0 ? -1 : t_voxelAccessor::voxelLength-1));
+            pos = vector2int32(owner.x, owner.y);
+            break;
+        default:
+            BASSERT(false);
+        }
+        return ((face*length + (pos.x+2))*length + (pos.y+2))*3 + edge;
+    }
+    /**
+     * @brief addVertexOnFaces remembers a vertex of marching cubes for transvoxel, if it lies on the border of the tile.
+     */
+    void addVertexOnFaces(vector<int32>& vertexIndicesFace, const vector3int32& owner, const int32& edge, const int32& index) const
+    {
+        const int32 border[] = {-1, t_voxelAccessor::voxelLength-1};
+        const int32 coords[] = {owner.x, owner.y, owner.z};
+        for (int32 face = 0; face < 6; ++face)
+        {
+            if (coords[face/2] == border[face%2])
+            {
+                vertexIndicesFace[calculateVertexIdFace(face, owner, edge)] = index;
+            }
+        }
+    }
+    /**
+     * @brief calculateCellId returns an id for a cell inside the tile. Ascending in the order calculateSurfaceFrom() visits the cells.
+     */
+    static int32 calculateCellId(const vector3int32& pos)
+    {
+        const int32 length(t_voxelAccessor::voxelLength);
+        return (pos.x*length + pos.y)*length + pos.z;
+    }
+    static bool isCellInside(const int32& cell, const vector3int32& min, const vector3int32& max)
+    {
+        const int32 length(t_voxelAccessor::voxelLength);
+        const vector3int32 pos(cell / (length*length), (cell / length) % length, cell % length);
+        return pos >= min && pos <= max;
+    }
+    /**
+     * @brief calculateEdgeKeyPartial returns an id for the edge between two neighbour voxel, relative to the voxel from min to min+size-1.
+     */
+    static int32 calculateEdgeKeyPartial(const vector3int32& voxel0, const vector3int32& voxel1, const vector3int32& min, const vector3int32& size)
+    {
+        const vector3int32 lower(vector3int32(voxel0).getMinimum(voxel1) - min);
+        const vector3int32 diff(voxel1 - voxel0);
+        const int32 axis(diff.x != 0 ? 0 : (diff.y != 0 ? 1 : 2));
+        BASSERT(lower >= vector3int32(0));
+        BASSERT(lower < size);
+
+        return ((lower.x*size.y + lower.y)*size.z + lower.z)*3 + axis;
+    }
+    /**
+     * @brief addVertexOnFacesPartial same like addVertexOnFaces() but inserts into the sorted m_faceVertices.
+     */
+    void addVertexOnFacesPartial(const vector3int32& owner, const int32& edge, const int32& index)
+    {
+        const int32 border[] = {-1, t_voxelAccessor::voxelLength-1};
+        const int32 coords[] = {owner.x, owner.y, owner.z};
+        for (int32 face = 0; face < 6; ++face)
+        {
+            if (coords[face/2] != border[face%2])
+            {
+                continue;
+            }
+            faceVertex toAdd;
+            toAdd.id = calculateVertexIdFace(face, owner, edge);
+            toAdd.vertex = index;
+            t_faceVertices& faceVertices(m_faceVertices[face]);
+            const typename t_faceVertices::iterator it(std::lower_bound(faceVertices.begin(), faceVertices.end(), toAdd));
+            if (it != faceVertices.end() && it->id == toAdd.id)
+            {
+                it->vertex = index;
+            }
+            else
+            {
+                faceVertices.insert(it, toAdd);
+            }
+        }
+    }
+    /**
+     * @brief setChangedAll sets getChangedVertices() and getChangedIndices() to the whole lists.
+     */
+    void setChangedAll()
+    {
+        m_changedVertices.first = 0;
+        m_changedVertices.count = m_vertexSources.size();
+        m_changedIndices.first = 0;
+        m_changedIndices.count = m_indices.size();
+    }
+    /**
+     * @brief createRevision returns a new id for getRevision(). Threadsafe.
+     */
+    static uint32 createRevision()
+    {
+        static idCreator<uint32> creator;
+        return creator.createIdThreadSafe();
     }
     int32 calculateVertexIdTransvoxel(const vector2int32& pos) const
     {
-        return (pos.x+1)*4*(t_voxelAccessor::voxelLength+1) +
+        return ((pos.x+1) & 1)*4*(t_voxelAccessor::voxelLength+1) +
                (pos.y+1)*4;
     }
-    vector3 calculateIntersectionPosition(const vector3int32& pos, const int32& corner0, const int32& corner1)
+    /**
+     * @brief calculateGradientNormal interpolates the central differences of the interpolation-field at two voxel like the vertex-position.
+     * @param voxel The voxel-source, must contain the neighbours of pos0 and pos1.
+     * @param pos0 Voxel on the one side of the iso-surface.
+     * @param pos1 Voxel on the other side of the iso-surface.
+     * @return Not normalised. Points to the lower interpolation.
+     */
+    template <class voxelSourceType>
+    static vector3 calculateGradientNormal(const voxelSourceType& voxel, const vector3int32& pos0, const vector3int32& pos1)
+    {
+        const real interpolation0(voxel.getVoxel(pos0).getInterpolation());
+        const real interpolation1(voxel.getVoxel(pos1).getInterpolation());
+        BASSERT(interpolation0 != interpolation1);
+
+        const real mu(-interpolation0 / (interpolation1 - interpolation0));
+        const vector3 result(calculateGradient(voxel, pos0)*(1.-mu) + calculateGradient(voxel, pos1)*mu);
+        if (result == vector3::ZERO)
+        {
+            // saturated field, the edge is the best guess
+            if (interpolation0 > interpolation1)
+            {
+                return vector3(pos1 - pos0);
+            }
+            return vector3(pos0 - pos1);
+        }
+        return -result;
+    }
+    template <class voxelSourceType>
+    static vector3 calculateGradient(const voxelSourceType& voxel, const vector3int32& pos)
+    {
+        return vector3(voxel.getVoxel(pos + vector3int32(1, 0, 0)).getInterpolation() - voxel.getVoxel(pos - vector3int32(1, 0, 0)).getInterpolation(),
+                       voxel.getVoxel(pos + vector3int32(0, 1, 0)).getInterpolation() - voxel.getVoxel(pos - vector3int32(0, 1, 0)).getInterpolation(),
+                       voxel.getVoxel(pos + vector3int32(0, 0, 1)).getInterpolation() - voxel.getVoxel(pos - vector3int32(0, 0, 1)).getInterpolation());
+    }
+    template <class voxelSourceType>
+    vector3 calculateIntersectionPosition(const voxelSourceType& voxel, const vector3int32& pos, const int32& corner0, const int32& corner1)
     {
         const vector3int32 corn0(calculateCorner(corner0));
         const vector3int32 corn1(calculateCorner(corner1));
 
-        const int8 interpolation0 = getVoxelInterpolation(corn0+pos);
-        const int8 interpolation1 = getVoxelInterpolation(corn1+pos);
+        const int8 interpolation0 = voxel.getVoxel(corn0+pos).getInterpolation();
+        const int8 interpolation1 = voxel.getVoxel(corn1+pos).getInterpolation();
 
         const vector3 result = getInterpolatedPosition(vector3(corn0), vector3(corn1), interpolation0, interpolation1);
 
         return vector3(pos) + result;
     }
-    vector3 calculateIntersectionPositionTransvoxel(const vector3int32& pos, const int32& corner0, const int32& corner1, const vector3int32 voxel[], const uint16 &lod)
+    vector3 calculateIntersectionPositionTransvoxel(const vector3int32& pos, const int32& corner0, const int32& corner1, const vector3int32 voxel[], const uint16 &lod) const
     {
         const vector3int32 corn0(calculateCornerTransvoxel(corner0, voxel));
         const vector3int32 corn1(calculateCornerTransvoxel(corner1, voxel));
@@ -771,12 +2399,28 @@ private:
     }
 
 protected:
-    t_voxelAccessorPtr m_voxel;
     int32 m_lod;
+    real m_voxelSize;
+    bool m_normalCorrection;
+    normalMode m_normalMode;
+    vertexFormat m_vertexFormat;
+    bool m_optimizeVertexCache;
+    real m_decimation;
+    uint32 m_revision;
+    uint32 m_remeshedFrom;
+    changedRange m_changedVertices;
+    changedRange m_changedIndices;
 
     t_vertices m_vertices;
+    t_verticesQuantized m_verticesQuantized;
+    t_dequantization m_dequantization;
+    t_vertexSources m_vertexSources;
     t_indices m_indices;
-    t_indices m_indicesLod[6];
+    t_faceVertices m_faceVertices[6];
+    t_cellTriangles m_cellTriangles;
+    vector<int32> m_freeVertices;
+    t_voxelArrayLodPtr m_voxelLod; // shared with the accessor-tile, see calculateSurface()
+    mutable transitionCache m_transitions;
 };
 
 
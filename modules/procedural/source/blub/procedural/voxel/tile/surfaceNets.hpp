@@ -0,0 +1,953 @@
+#ifndef PROCEDURAL_VOXEL_TILE_SURFACENETS_HPP
+#define PROCEDURAL_VOXEL_TILE_SURFACENETS_HPP
+
+#include "blub/core/globals.hpp"
+#include "blub/core/sharedPointer.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/vector2int.hpp"
+#include "blub/math/vector3.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/voxel/tile/surface.hpp"
+
+#include <boost/thread/tss.hpp>
+
+#include <algorithm>
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+namespace tile
+{
+
+
+/**
+ * @brief The surfaceNets class convertes a tile::accessor to an iso-surface like tile::surface, but with surface nets instead of marching cubes.
+ * Every cell with corners on both sides of the iso-surface gets one vertex, at the average of the intersections of its edges.
+ * Every edge that crosses the iso-surface gets a quad between the vertices of its four cells.
+ * Compared to marching cubes with the gradient-normals of tile::surface that gives about 10% more vertices and 40% more triangles.
+ * Select it by the config: typedef tile::surfaceNets<configType> t_tile; in t_config::t_surface.
+ *
+ * The mesh ends exactly on the faces of the tile. A cell outside one face collapses to the square of the face it touches, its vertex lies in the face-plane.
+ * A cell outside two faces collapses to the edge of the tile, its vertex is the intersection of the edge. Neighbours of the same lod calculate the same
+ * vertices on their common face, so their border-lines are identical and the seam is closed.
+ * The faces of getIndicesLod() lie in the face-plane too, like the transvoxel-faces of tile::surface: they fill the area between the border-line of the tile
+ * and the border-line the finer neighbour calculates from the same lod-voxel.
+ *
+ * Differences to tile::surface:
+ * The normals are always the voxel-gradient of the cell, setNormalMode() has no effect.
+ * calculateSurfacePartial() always returns false, so simple::surface remeshes the whole tile.
+ *
+ * setQuadCollapse() optionally merges the quads lying nearly in one plane afterwards, by tile::surface::decimate(). That is lossy, the surface moves up to
+ * the set error, and it takes many times longer than the surface nets themselves. It is disabled by default, see examples/benchmark/source/surface.cpp.
+ */
+template <class configType>
+class surfaceNets : public surface<configType>
+{
+public:
+    typedef configType t_config;
+    typedef surface<t_config> t_base;
+    typedef sharedPointer<surfaceNets<t_config> > pointer;
+    typedef typename t_base::t_thiz t_thiz;
+    typedef typename t_base::t_voxelAccessor t_voxelAccessor;
+    typedef typename t_base::t_vertices t_vertices;
+    typedef typename t_base::t_indices t_indices;
+    typedef typename t_base::t_voxel t_voxel;
+    typedef typename t_base::t_vertex t_vertex;
+    typedef typename t_base::t_vertexQuantized t_vertexQuantized;
+    typedef typename t_base::t_faceVertices t_faceVertices;
+
+    friend class surface<configType>;
+
+    /**
+     * @brief create creates an instance.
+     * @return never nullptr.
+     */
+    static pointer create()
+    {
+        return pointer(new surfaceNets());
+    }
+    /**
+     * @brief createCopy copies an instance.
+     * @param toCopy
+     * @return never nullptr.
+     */
+    static pointer createCopy(pointer toCopy)
+    {
+        return pointer(new surfaceNets(*toCopy.get()));
+    }
+
+    /**
+     * @brief setQuadCollapse sets the error up to which the next calculateSurface() merges quads lying nearly in one plane. Default is 0, disabled.
+     * Uses tile::surface::decimate(), the vertices on the faces of the tile don't move. If setDecimation() is larger, that gets used instead.
+     * @param toSet Maximal error in voxel of the lod of the tile. 0 disables the merging.
+     */
+    void setQuadCollapse(const real& toSet)
+    {
+        BASSERT(toSet >= 0.);
+        m_quadCollapse = toSet;
+    }
+    /**
+     * @brief getQuadCollapse returns the value set by setQuadCollapse().
+     * @return
+     */
+    const real& getQuadCollapse() const
+    {
+        return m_quadCollapse;
+    }
+
+protected:
+    /**
+     * @brief surfaceNets constructor
+     */
+    surfaceNets()
+        : m_quadCollapse(0.)
+    {
+        ;
+    }
+
+    /**
+     * @brief The netsBuffer struct contains the buffers of one thread, like tile::surface::reuseBuffer.
+     */
+    struct netsBuffer
+    {
+        /// the interpolation of every voxel from -1 to voxelLength+1, read once per calculation
+        vector<int8> interpolations;
+        /// the vertex-index of every cell from -1 to voxelLength, -1 if the cell has no vertex yet
+        vector<int32> cellVertices;
+        /// the lod-voxel of the face calculateTransitionFace() works on
+        vector<int8> interpolationsLod;
+        /// the index in the face-vertices of every fine square, coarse square and fine edge, -1 if not created yet
+        vector<int32> squaresFine;
+        vector<int32> squaresCoarse;
+        vector<int32> edgesFine[2];
+    };
+    /**
+     * @brief getNetsBuffer returns the netsBuffer of the calling thread.
+     */
+    static netsBuffer& getNetsBuffer()
+    {
+        static boost::thread_specific_ptr<netsBuffer> buffer;
+        if (buffer.get() == nullptr)
+        {
+            buffer.reset(new netsBuffer());
+        }
+        return *buffer;
+    }
+
+    /**
+     * @brief calculateSurfaceFrom calculates the iso surface, called by tile::surface::calculateSurface().
+     * Reads the voxel from -1 to voxelLength+1, calculateNormalCorrection gets ignored.
+     */
+    template <class voxelSourceType>
+    void calculateSurfaceFrom(const voxelSourceType& voxel, const real &voxelSize, const bool& calculateNormalCorrection)
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        const int32 sampleLength(voxelLength+3);
+        const int32 cellLength(voxelLength+2);
+
+        t_base::m_normalCorrection = calculateNormalCorrection;
+
+        typename t_base::reuseBuffer& buffer(t_base::getReuseBuffer());
+        t_base::moveResultsToArena(buffer);
+        netsBuffer& nets(getNetsBuffer());
+
+        // isLevel describes at which interpolation-level a surface is generated around the voxel
+        const int8 isoLevel(0);
+
+        // the interpolations get read once. One bit per voxel along z, set if the voxel is below isoLevel, like tile::surface::calculateSurfaceFrom()
+        vector<int8>& interpolations(nets.interpolations);
+        interpolations.resize(sampleLength*sampleLength*sampleLength);
+        vector<uint32>& signs(buffer.signs);
+        BASSERT(signs.size() >= static_cast<uint32>(sampleLength*sampleLength));
+        for (int32 x = -1; x <= voxelLength+1; ++x)
+        {
+            for (int32 y = -1; y <= voxelLength+1; ++y)
+            {
+                uint32 row(0);
+                for (int32 z = -1; z <= voxelLength+1; ++z)
+                {
+                    const int8 interpolation(voxel.getVoxel(vector3int32(x, y, z)).getInterpolation());
+                    interpolations[calculateSampleIndex(vector3int32(x, y, z))] = interpolation;
+                    if (interpolation < isoLevel)
+                    {
+                        row |= 1u << (z+1);
+                    }
+                }
+                signs[(x+1)*sampleLength + y+1] = row;
+            }
+        }
+
+        // the vertices get created by the first quad using them
+        nets.cellVertices.assign(cellLength*cellLength*cellLength, -1);
+        const bool collectFaces(t_base::m_lod > 0);
+
+        // one quad per edge crossing the iso-surface, between the vertices of the four cells around it.
+        // The tile owns all edges from voxel 0 to voxelLength, an edge in a face gets calculated by both neighbours and each adds the half of the quad inside
+        const uint32 rowEdges(((1u << (voxelLength+1)) - 1) << 1);
+        const uint32 rowEdgesZ(((1u << voxelLength) - 1) << 1);
+        for (int32 x = 0; x <= voxelLength; ++x)
+        {
+            for (int32 y = 0; y <= voxelLength; ++y)
+            {
+                const int32 indexRow((x+1)*sampleLength + y+1);
+                const uint32 row(signs[indexRow]);
+                const uint32 crossings[3] = {x < voxelLength ? (row ^ signs[indexRow + sampleLength]) & rowEdges : 0,
+                                             y < voxelLength ? (row ^ signs[indexRow + 1]) & rowEdges : 0,
+                                             (row ^ (row >> 1)) & rowEdgesZ};
+                for (int32 axis = 0; axis < 3; ++axis)
+                {
+                    uint32 crossing(crossings[axis]);
+                    for (int32 z = -1; crossing != 0; ++z, crossing >>= 1)
+                    {
+                        if ((crossing & 1) == 0)
+                        {
+                            continue;
+                        }
+                        const vector3int32 posVoxel(x, y, z);
+                        const bool below(((row >> (z+1)) & 1) != 0);
+
+                        // the cells in counter clockwise order, seen from the end of the edge
+                        const vector3int32 axis1(calculateAxis((axis+1)%3));
+                        const vector3int32 axis2(calculateAxis((axis+2)%3));
+                        vector3int32 cells[4] = {posVoxel - axis1 - axis2,
+                                                 posVoxel - axis2,
+                                                 posVoxel,
+                                                 posVoxel - axis1};
+                        if (below)
+                        {
+                            // the normal points to the side below the iso-level
+                            std::swap(cells[1], cells[3]);
+                        }
+                        int32 ids[4];
+                        for (int32 ind = 0; ind < 4; ++ind)
+                        {
+                            ids[ind] = addCellVertex(voxel, nets, cells[ind], voxelSize, collectFaces);
+                        }
+                        // split along the shorter diagonal
+                        const vector3& position0(t_base::m_vertices[ids[0]].position);
+                        const vector3& position1(t_base::m_vertices[ids[1]].position);
+                        const vector3& position2(t_base::m_vertices[ids[2]].position);
+                        const vector3& position3(t_base::m_vertices[ids[3]].position);
+                        if ((position2 - position0).squaredLength() <= (position3 - position1).squaredLength())
+                        {
+                            addTriangle(t_base::m_indices, ids[0], ids[1], ids[2]);
+                            addTriangle(t_base::m_indices, ids[0], ids[2], ids[3]);
+                        }
+                        else
+                        {
+                            addTriangle(t_base::m_indices, ids[0], ids[1], ids[3]);
+                            addTriangle(t_base::m_indices, ids[1], ids[2], ids[3]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // the faces look up the vertices by id, see tile::surface::addFaceVertex()
+        if (collectFaces)
+        {
+            for (int32 face = 0; face < 6; ++face)
+            {
+                std::sort(t_base::m_faceVertices[face].begin(), t_base::m_faceVertices[face].end());
+            }
+        }
+
+        const real collapse(std::max(t_base::m_decimation, m_quadCollapse));
+        if (collapse > 0.)
+        {
+            t_base::decimate(buffer, collapse);
+        }
+        if (t_base::m_optimizeVertexCache)
+        {
+            t_base::optimizeVertexCache(buffer);
+        }
+
+        t_base::m_dequantization = t_base::calculateDequantization(voxelSize);
+        if (t_base::m_vertexFormat != t_base::vertexFormat::full)
+        {
+            t_base::quantizeVertices();
+        }
+        t_base::moveResultsFromArena(buffer);
+
+        t_base::m_revision = t_base::createRevision();
+        t_base::m_remeshedFrom = 0;
+        t_base::setChangedAll();
+    }
+
+    /**
+     * @brief addCellVertex returns the vertex of a cell, creates it on the first call.
+     * A cell outside the tile collapses to the square or the edge of the tile it touches, see class description.
+     * @param posCell From -1 to voxelLength, at most two coordinates outside the tile.
+     * @return The index in m_vertices.
+     */
+    template <class voxelSourceType>
+    int32 addCellVertex(const voxelSourceType& voxel, netsBuffer& nets, const vector3int32& posCell, const real& voxelSize, const bool& collectFaces)
+    {
+        int32& result(nets.cellVertices[calculateCellIndex(posCell)]);
+        if (result != -1)
+        {
+            return result;
+        }
+        const vector<int8>& interpolations(nets.interpolations);
+        const int8 isoLevel(0);
+
+        // the corners of the cell clamped to the faces, a collapsed cell has the same corner several times
+        vector3int32 voxelMin;
+        vector3int32 voxelMax;
+        vector3int32 cellsMin;
+        vector3int32 cellsMax;
+        calculateCollapsedCell(posCell, voxelMin, voxelMax, cellsMin, cellsMax);
+
+        // the average of the intersections on the edges of the cell. A collapsed cell counts every edge the same number of times
+        vector3 position(0.);
+        int32 numIntersections(0);
+        vector3int32 posVoxel0;
+        vector3int32 posVoxel1;
+        for (int32 edge = 0; edge < 12; ++edge)
+        {
+            const vector3int32 pos0(calculateCollapsedCorner(voxelMin, voxelMax, cellEdges[edge][0]));
+            const vector3int32 pos1(calculateCollapsedCorner(voxelMin, voxelMax, cellEdges[edge][1]));
+            if (pos0 == pos1)
+            {
+                continue;
+            }
+            const int8& interpolation0(interpolations[calculateSampleIndex(pos0)]);
+            const int8& interpolation1(interpolations[calculateSampleIndex(pos1)]);
+            if ((interpolation0 < isoLevel) == (interpolation1 < isoLevel))
+            {
+                continue;
+            }
+            position += t_base::getInterpolatedPosition(vector3(pos0), vector3(pos1), interpolation0, interpolation1);
+            if (numIntersections == 0)
+            {
+                posVoxel0 = pos0;
+                posVoxel1 = pos1;
+            }
+            ++numIntersections;
+        }
+        BASSERT(numIntersections > 0);
+        position *= voxelSize/static_cast<real>(numIntersections);
+
+        // the gradient of the trilinear interpolation, a collapsed cell averages the cells on both sides of the face
+        vector3 normal(0.);
+        for (int32 x = cellsMin.x; x <= cellsMax.x; ++x)
+        {
+            for (int32 y = cellsMin.y; y <= cellsMax.y; ++y)
+            {
+                for (int32 z = cellsMin.z; z <= cellsMax.z; ++z)
+                {
+                    normal += calculateCellNormal(interpolations, vector3int32(x, y, z));
+                }
+            }
+        }
+        if (normal == vector3::ZERO)
+        {
+            // saturated field, the edge is the best guess
+            normal = interpolations[calculateSampleIndex(posVoxel0)] > interpolations[calculateSampleIndex(posVoxel1)] ?
+                        vector3(posVoxel1 - posVoxel0) : vector3(posVoxel0 - posVoxel1);
+        }
+        normal.normalise();
+
+        const t_voxel& voxel0(voxel.getVoxel(posVoxel0));
+        const t_voxel& voxel1(voxel.getVoxel(posVoxel1));
+        const t_vertex vertex(static_cast<t_thiz>(this)->createVertex(posCell, voxel0, voxel1, position, normal));
+        t_base::m_vertices.push_back(vertex);
+        t_base::addVertexSource(posCell, posVoxel0, posVoxel1);
+        result = t_base::m_vertices.size()-1;
+
+        if (collectFaces)
+        {
+            const int32 voxelLength(t_voxelAccessor::voxelLength);
+            for (int32 coord = 0; coord < 3; ++coord)
+            {
+                if (posCell[coord] >= 0 && posCell[coord] < voxelLength)
+                {
+                    continue;
+                }
+                typename t_base::faceVertex toAdd;
+                toAdd.id = calculateFaceId(posCell, coord);
+                toAdd.vertex = result;
+                t_base::m_faceVertices[coord*2 + (posCell[coord] < 0 ? 0 : 1)].push_back(toAdd);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief calculateTransitionFace calculates the face between this tile and the finer neighbours, called by tile::surface::getTransitionFace().
+     * The face lies in the face-plane. One side of it is the border-line of this tile, the other side the border-line the four finer neighbours calculate
+     * from the lod-voxel. Every fine edge crossing the iso-surface gets a polygon like the quads of calculateSurfaceFrom(),
+     * around it lie two fine squares of the neighbours and one or two squares of this tile.
+     */
+    void calculateTransitionFace(const int32& lod, typename t_base::transitionFace& result) const
+    {
+        BASSERT(!t_base::m_voxelLod.isNull());
+
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        const int32 lengthLod(2*voxelLength+1);
+        const int32 last(lengthLod-1);
+        const int8 isoLevel(0);
+        const int32 coord(lod/2);
+        // the neighbours lie on the side of the face-plane outside the tile
+        const int32 signFine(lod % 2 == 0 ? -1 : 1);
+
+        typename t_base::reuseBuffer& buffer(t_base::getReuseBuffer());
+        t_vertices& vertices(buffer.verticesFace);
+        vertices.clear();
+        t_indices& indices(buffer.indicesFace);
+        indices.clear();
+        // the index in vertices for every entry of m_faceVertices[lod]
+        buffer.faceVerticesLocal.assign(t_base::m_faceVertices[lod].size(), -1);
+
+        netsBuffer& nets(getNetsBuffer());
+        nets.interpolationsLod.resize(lengthLod*lengthLod);
+        for (int32 indU = 0; indU < lengthLod; ++indU)
+        {
+            for (int32 indV = 0; indV < lengthLod; ++indV)
+            {
+                nets.interpolationsLod[indU*lengthLod + indV] = t_base::getVoxelInterpolationLod(calculatePosLod(lod, vector2int32(indU, indV)), lod);
+            }
+        }
+        nets.squaresFine.assign(last*last, -1);
+        nets.squaresCoarse.assign(voxelLength*voxelLength, -1);
+        nets.edgesFine[0].assign(last*lengthLod, -1);
+        nets.edgesFine[1].assign(last*lengthLod, -1);
+
+        // dir 0 are the edges along the first face-coordinate, dir 1 the ones along the second
+        for (int32 dir = 0; dir < 2; ++dir)
+        {
+            const int32 axisEdge(calculateAxisFace(coord, dir));
+            // the quadrants around an edge are counter clockwise in the two other axes, like in calculateSurfaceFrom()
+            const bool coordFirst((axisEdge+1)%3 == coord);
+
+            for (int32 along = 0; along < last; ++along)
+            {
+                for (int32 across = 0; across < lengthLod; ++across)
+                {
+                    const int8 interpolation0(getInterpolationLod(nets, calculatePosFace(dir, along, across)));
+                    const int8 interpolation1(getInterpolationLod(nets, calculatePosFace(dir, along+1, across)));
+                    if ((interpolation0 < isoLevel) == (interpolation1 < isoLevel))
+                    {
+                        continue;
+                    }
+
+                    // the side of the neighbours: the fine squares on both sides, the intersection of the edge itself where a neighbour ends
+                    const int32 fineLow(across > 0 ? addSquareFine(lod, buffer, nets, calculatePosFace(dir, along, across-1)) : addEdgeFine(lod, buffer, nets, dir, along, across));
+                    const int32 fineHigh(across < last ? addSquareFine(lod, buffer, nets, calculatePosFace(dir, along, across)) : addEdgeFine(lod, buffer, nets, dir, along, across));
+                    const int32 fineBetween(across == voxelLength ? addEdgeFine(lod, buffer, nets, dir, along, across) : -1);
+
+                    // the side of this tile: the squares the edge touches, the vertex on the edge of the tile beyond the border of the face
+                    int32 coarseLow;
+                    int32 coarseHigh;
+                    if (across % 2 == 1)
+                    {
+                        coarseLow = coarseHigh = addSquareCoarse(lod, buffer, nets, calculatePosFace(dir, along/2, across/2));
+                    }
+                    else
+                    {
+                        int32 beyond(-1);
+                        if (across == 0 || across == last)
+                        {
+                            const int32 alongCoarse(along - along % 2);
+                            const int8 interpolationCoarse0(getInterpolationLod(nets, calculatePosFace(dir, alongCoarse, across)));
+                            const int8 interpolationCoarse1(getInterpolationLod(nets, calculatePosFace(dir, alongCoarse+2, across)));
+                            if ((interpolationCoarse0 < isoLevel) != (interpolationCoarse1 < isoLevel))
+                            {
+                                const int32 id(calculateFaceId(calculatePosFace(dir, alongCoarse+1, across)));
+                                beyond = t_base::addFaceVertex(id, t_base::m_faceVertices[lod], buffer.faceVerticesLocal, vertices);
+                            }
+                            else if (along % 2 == 0)
+                            {
+                                // both fine halves cross and this tile has no vertex on the edge, join them
+                                beyond = addEdgeFine(lod, buffer, nets, dir, along+1, across);
+                            }
+                        }
+                        coarseLow = across > 0 ? addSquareCoarse(lod, buffer, nets, calculatePosFace(dir, along/2, across/2-1)) : beyond;
+                        coarseHigh = across < last ? addSquareCoarse(lod, buffer, nets, calculatePosFace(dir, along/2, across/2)) : beyond;
+                    }
+
+                    const int32 quadrants[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+                    int32 polygon[5];
+                    int32 numPolygon(0);
+                    for (int32 ind = 0; ind < 4; ++ind)
+                    {
+                        const int32 signFace(quadrants[ind][coordFirst ? 0 : 1]);
+                        const int32 signAcross(quadrants[ind][coordFirst ? 1 : 0]);
+                        if (signFace == signFine)
+                        {
+                            polygon[numPolygon++] = signAcross < 0 ? fineLow : fineHigh;
+                            // the edge lies on the border between two neighbours, both end at its intersection
+                            if (fineBetween != -1 && quadrants[(ind+1)%4][coordFirst ? 0 : 1] == signFine)
+                            {
+                                polygon[numPolygon++] = fineBetween;
+                            }
+                        }
+                        else
+                        {
+                            polygon[numPolygon++] = signAcross < 0 ? coarseLow : coarseHigh;
+                        }
+                    }
+                    if (interpolation0 < isoLevel)
+                    {
+                        // the normal points to the side below the iso-level
+                        std::reverse(polygon, polygon + numPolygon);
+                    }
+                    addPolygon(indices, polygon, numPolygon);
+                }
+            }
+        }
+
+        if (t_base::m_vertexFormat != t_base::vertexFormat::full)
+        {
+            result.verticesQuantized.reserve(vertices.size());
+            for (const t_vertex& workVertex : vertices)
+            {
+                result.verticesQuantized.push_back(t_vertexQuantized::encode(workVertex.position, workVertex.normal, t_base::m_dequantization));
+            }
+        }
+        if (t_base::m_vertexFormat != t_base::vertexFormat::quantized)
+        {
+            t_base::copyExactly(vertices, result.vertices);
+        }
+        t_base::copyExactly(indices, result.indices);
+    }
+
+    /**
+     * @brief addSquareCoarse returns the vertex of this tile on a square of the face, copies it to the face on the first call.
+     * A square without crossing edges in this tile but with crossing fine edges gets a vertex of its own, at the average of the fine intersections.
+     * @param square Position of the square in voxel of this tile, in the order of the lod-voxel.
+     * @return The index in the vertices of the face.
+     */
+    int32 addSquareCoarse(const int32& lod, typename t_base::reuseBuffer& buffer, netsBuffer& nets, const vector2int32& square) const
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        int32& result(nets.squaresCoarse[square.x*voxelLength + square.y]);
+        if (result != -1)
+        {
+            return result;
+        }
+        const t_faceVertices& faceVertices(t_base::m_faceVertices[lod]);
+        typename t_base::faceVertex toFind;
+        toFind.id = calculateFaceId(square*2 + vector2int32(1));
+        const typename t_faceVertices::const_iterator it(std::lower_bound(faceVertices.begin(), faceVertices.end(), toFind));
+        if (it != faceVertices.end() && it->id == toFind.id)
+        {
+            result = t_base::addFaceVertex(toFind.id, faceVertices, buffer.faceVerticesLocal, buffer.verticesFace);
+            return result;
+        }
+
+        // the fine edges inside the square, in fine voxel
+        const int8 isoLevel(0);
+        vector3 position(0.);
+        int32 numIntersections(0);
+        vector2int32 posVoxel0;
+        vector2int32 posVoxel1;
+        for (int32 dir = 0; dir < 2; ++dir)
+        {
+            for (int32 along = 0; along < 2; ++along)
+            {
+                for (int32 across = 0; across < 3; ++across)
+                {
+                    const vector2int32 pos0(square*2 + calculatePosFace(dir, along, across));
+                    const vector2int32 pos1(square*2 + calculatePosFace(dir, along+1, across));
+                    const int8 interpolation0(getInterpolationLod(nets, pos0));
+                    const int8 interpolation1(getInterpolationLod(nets, pos1));
+                    if ((interpolation0 < isoLevel) == (interpolation1 < isoLevel))
+                    {
+                        continue;
+                    }
+                    position += t_base::getInterpolatedPosition(calculatePositionLod(lod, pos0), calculatePositionLod(lod, pos1), interpolation0, interpolation1);
+                    if (numIntersections == 0)
+                    {
+                        posVoxel0 = pos0;
+                        posVoxel1 = pos1;
+                    }
+                    ++numIntersections;
+                }
+            }
+        }
+        BASSERT(numIntersections > 0);
+        position *= t_base::m_voxelSize*0.5/static_cast<real>(numIntersections);
+
+        // the iso-surface only touches the face, the normal points to the side of the corners below the iso-level
+        const int32 coord(lod/2);
+        const bool below(getInterpolationLod(nets, square*2) < isoLevel);
+        const int32 signFine(lod % 2 == 0 ? -1 : 1);
+        const vector3int32 normal(calculateAxis(coord)*(below ? -signFine : signFine));
+
+        result = addVertexLod(lod, buffer, posVoxel0, posVoxel1, position, vector3(normal));
+        return result;
+    }
+    /**
+     * @brief addSquareFine returns the vertex of a finer neighbour on a fine square of the face, creates it on the first call.
+     * Calculated like the vertex of a collapsed cell in addCellVertex(), the normal gets taken from the square of this tile.
+     * @param square Position in lod-voxel.
+     * @return The index in the vertices of the face.
+     */
+    int32 addSquareFine(const int32& lod, typename t_base::reuseBuffer& buffer, netsBuffer& nets, const vector2int32& square) const
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        int32& result(nets.squaresFine[square.x*2*voxelLength + square.y]);
+        if (result != -1)
+        {
+            return result;
+        }
+
+        const int8 isoLevel(0);
+        vector3 position(0.);
+        int32 numIntersections(0);
+        vector2int32 posVoxel0;
+        vector2int32 posVoxel1;
+        for (int32 dir = 0; dir < 2; ++dir)
+        {
+            for (int32 across = 0; across < 2; ++across)
+            {
+                const vector2int32 pos0(square + calculatePosFace(dir, 0, across));
+                const vector2int32 pos1(square + calculatePosFace(dir, 1, across));
+                const int8 interpolation0(getInterpolationLod(nets, pos0));
+                const int8 interpolation1(getInterpolationLod(nets, pos1));
+                if ((interpolation0 < isoLevel) == (interpolation1 < isoLevel))
+                {
+                    continue;
+                }
+                position += t_base::getInterpolatedPosition(calculatePositionLod(lod, pos0), calculatePositionLod(lod, pos1), interpolation0, interpolation1);
+                if (numIntersections == 0)
+                {
+                    posVoxel0 = pos0;
+                    posVoxel1 = pos1;
+                }
+                ++numIntersections;
+            }
+        }
+        BASSERT(numIntersections > 0);
+        position *= t_base::m_voxelSize*0.5/static_cast<real>(numIntersections);
+
+        const vector3 normal(buffer.verticesFace[addSquareCoarse(lod, buffer, nets, square/2)].normal);
+        result = addVertexLod(lod, buffer, posVoxel0, posVoxel1, position, normal);
+        return result;
+    }
+    /**
+     * @brief addEdgeFine returns the intersection of a fine edge, where a finer neighbour ends. Creates it on the first call.
+     * @param dir 0 for an edge along the first face-coordinate, 1 for the second.
+     * @param along Start of the edge along it, in lod-voxel.
+     * @param across Position of the edge across it, in lod-voxel.
+     * @return The index in the vertices of the face.
+     */
+    int32 addEdgeFine(const int32& lod, typename t_base::reuseBuffer& buffer, netsBuffer& nets, const int32& dir, const int32& along, const int32& across) const
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        int32& result(nets.edgesFine[dir][along*(2*voxelLength+1) + across]);
+        if (result != -1)
+        {
+            return result;
+        }
+        const vector2int32 pos0(calculatePosFace(dir, along, across));
+        const vector2int32 pos1(calculatePosFace(dir, along+1, across));
+        const vector3 position(t_base::getInterpolatedPosition(calculatePositionLod(lod, pos0), calculatePositionLod(lod, pos1),
+                                                               getInterpolationLod(nets, pos0), getInterpolationLod(nets, pos1))*t_base::m_voxelSize*0.5);
+
+        const vector2int32 square(calculatePosFace(dir, along/2, std::min(across/2, voxelLength-1)));
+        const vector3 normal(buffer.verticesFace[addSquareCoarse(lod, buffer, nets, square)].normal);
+        result = addVertexLod(lod, buffer, pos0, pos1, position, normal);
+        return result;
+    }
+    /**
+     * @brief addVertexLod adds a vertex to the face by createVertexLod().
+     * @param posVoxel0 The lod-voxel the vertex gets its attributes from.
+     * @return The index in the vertices of the face.
+     */
+    int32 addVertexLod(const int32& lod, typename t_base::reuseBuffer& buffer,
+                       const vector2int32& posVoxel0, const vector2int32& posVoxel1, const vector3& position, const vector3& normal) const
+    {
+        // createVertexLod() of derived classes isn't const, calculating a face doesn't change the results of the other getters though
+        const t_thiz thiz(static_cast<t_thiz>(const_cast<surfaceNets*>(this)));
+        const vector3int32 posLod0(calculatePosLod(lod, posVoxel0));
+        const vector3int32 posLod1(calculatePosLod(lod, posVoxel1));
+        const t_vertex vertex(thiz->createVertexLod(posLod0, t_base::getVoxelLod(posLod0, lod), t_base::getVoxelLod(posLod1, lod), position, normal));
+        buffer.verticesFace.push_back(vertex);
+        return buffer.verticesFace.size()-1;
+    }
+    /**
+     * @brief addPolygon fan-triangulates a polygon of calculateTransitionFace(). Skips missing and repeated vertices.
+     * @param polygon Indices in vertices, -1 for a missing one.
+     */
+    static void addPolygon(t_indices& indices, const int32* polygon, const int32& numPolygon)
+    {
+        int32 corners[5];
+        int32 numCorners(0);
+        for (int32 ind = 0; ind < numPolygon; ++ind)
+        {
+            if (polygon[ind] == -1 || (numCorners > 0 && corners[numCorners-1] == polygon[ind]))
+            {
+                continue;
+            }
+            corners[numCorners++] = polygon[ind];
+        }
+        while (numCorners > 1 && corners[numCorners-1] == corners[0])
+        {
+            --numCorners;
+        }
+        for (int32 ind = 1; ind+1 < numCorners; ++ind)
+        {
+            addTriangle(indices, corners[0], corners[ind], corners[ind+1]);
+        }
+    }
+
+    /**
+     * @brief calculateVertexId calculates tile::surface::getVertexId(). A vertex is identified by its cell, a collapsed cell by the square or edge of the tile it collapsed to.
+     */
+    uint64 calculateVertexId(const int32& index, const vector3int32& voxelStart) const
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        const vector3int32& posCell(t_base::m_vertexSources[index].voxelPos);
+        int32 pos[3] = {posCell.x, posCell.y, posCell.z};
+        int32 numOutside(0);
+        int32 axisOutside(0);
+        int32 axisInside(0);
+        for (int32 coord = 0; coord < 3; ++coord)
+        {
+            if (pos[coord] >= 0 && pos[coord] < voxelLength)
+            {
+                axisInside = coord;
+                continue;
+            }
+            pos[coord] = pos[coord] < 0 ? 0 : voxelLength;
+            axisOutside = coord;
+            ++numOutside;
+        }
+        const vector3int32 posId(voxelStart + vector3int32(pos[0], pos[1], pos[2]));
+        switch (numOutside)
+        {
+        case 0:
+            return t_base::packVertexId(posId, 3);
+        case 1:
+            return t_base::packVertexId(posId, 4 + axisOutside);
+        default:
+            BASSERT(numOutside == 2);
+            return t_base::packVertexId(posId, axisInside);
+        }
+    }
+    /**
+     * @brief calculateVerticesLocked locks the vertices of the collapsed cells, they lie on the faces and are shared with the neighbours.
+     * @param locked Gets resized to the number of vertices.
+     * @see tile::surface::calculateVerticesLocked()
+     */
+    void calculateVerticesLocked(vector<uint8>& locked) const
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        locked.resize(t_base::m_vertices.size());
+        for (int32 index = 0; index < static_cast<int32>(t_base::m_vertexSources.size()); ++index)
+        {
+            const vector3int32& posCell(t_base::m_vertexSources[index].voxelPos);
+            locked[index] = posCell >= vector3int32(0) && posCell < vector3int32(voxelLength) ? 0 : 1;
+        }
+    }
+    /**
+     * @brief addTriangle adds a triangle to indices.
+     * Triangles without an area stay, a vertex of a cell may lie on the vertex of a collapsed cell. Dropping the triangle would open the mesh welded by getVertexId().
+     */
+    static void addTriangle(t_indices& indices, const int32& vertexIndex0, const int32& vertexIndex1, const int32& vertexIndex2)
+    {
+        indices.push_back(vertexIndex0);
+        indices.push_back(vertexIndex1);
+        indices.push_back(vertexIndex2);
+    }
+    /**
+     * @brief calculateCollapsedCell clamps a cell to the tile.
+     * @param posCell From -1 to voxelLength.
+     * @param voxelMin Gets the first corner of the collapsed cell.
+     * @param voxelMax Gets the last corner of the collapsed cell.
+     * @param cellsMin Gets the first real cell the collapsed cell stands for, cells outside a face stand for both cells next to it.
+     * @param cellsMax Gets the last real cell.
+     */
+    static void calculateCollapsedCell(const vector3int32& posCell, vector3int32& voxelMin, vector3int32& voxelMax, vector3int32& cellsMin, vector3int32& cellsMax)
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        int32 result[4][3];
+        for (int32 coord = 0; coord < 3; ++coord)
+        {
+            const int32 pos(posCell[coord]);
+            if (pos < 0)
+            {
+                result[0][coord] = result[1][coord] = 0;
+                result[2][coord] = -1;
+                result[3][coord] = 0;
+            }
+            else if (pos >= voxelLength)
+            {
+                result[0][coord] = result[1][coord] = voxelLength;
+                result[2][coord] = voxelLength-1;
+                result[3][coord] = voxelLength;
+            }
+            else
+            {
+                result[0][coord] = pos;
+                result[1][coord] = pos+1;
+                result[2][coord] = result[3][coord] = pos;
+            }
+        }
+        voxelMin = vector3int32(result[0][0], result[0][1], result[0][2]);
+        voxelMax = vector3int32(result[1][0], result[1][1], result[1][2]);
+        cellsMin = vector3int32(result[2][0], result[2][1], result[2][2]);
+        cellsMax = vector3int32(result[3][0], result[3][1], result[3][2]);
+    }
+    /**
+     * @brief calculateCollapsedCorner returns a corner of calculateCorner() of a cell clamped by calculateCollapsedCell().
+     */
+    static vector3int32 calculateCollapsedCorner(const vector3int32& voxelMin, const vector3int32& voxelMax, const int32& corner)
+    {
+        const vector3int32 select(t_base::calculateCorner(corner));
+        return vector3int32(select.x == 0 ? voxelMin.x : voxelMax.x,
+                            select.y == 0 ? voxelMin.y : voxelMax.y,
+                            select.z == 0 ? voxelMin.z : voxelMax.z);
+    }
+    /**
+     * @brief calculateCellNormal returns the negative gradient of the trilinear interpolation in the middle of a cell, not normalised.
+     * @param posCell From -1 to voxelLength.
+     */
+    static vector3 calculateCellNormal(const vector<int8>& interpolations, const vector3int32& posCell)
+    {
+        real values[2][2][2];
+        for (int32 x = 0; x < 2; ++x)
+        {
+            for (int32 y = 0; y < 2; ++y)
+            {
+                for (int32 z = 0; z < 2; ++z)
+                {
+                    values[x][y][z] = interpolations[calculateSampleIndex(posCell + vector3int32(x, y, z))];
+                }
+            }
+        }
+        vector3 result(0.);
+        for (int32 ind0 = 0; ind0 < 2; ++ind0)
+        {
+            for (int32 ind1 = 0; ind1 < 2; ++ind1)
+            {
+                result.x += values[0][ind0][ind1] - values[1][ind0][ind1];
+                result.y += values[ind0][0][ind1] - values[ind0][1][ind1];
+                result.z += values[ind0][ind1][0] - values[ind0][ind1][1];
+            }
+        }
+        return result;
+    }
+    /**
+     * @brief calculateFaceId returns the id of a collapsed cell in m_faceVertices, see calculateFaceId(const vector2int32&).
+     * @param posCell From -1 to voxelLength.
+     * @param coord The axis of the face.
+     */
+    static int32 calculateFaceId(const vector3int32& posCell, const int32& coord)
+    {
+        const int32 voxelLength(t_voxelAccessor::voxelLength);
+        int32 pos[2];
+        for (int32 ind = 0; ind < 2; ++ind)
+        {
+            const int32 work(posCell[calculateAxisFace(coord, ind)]);
+            pos[ind] = work < 0 ? 0 : (work >= voxelLength ? 2*voxelLength : 2*work+1);
+        }
+        return calculateFaceId(vector2int32(pos[0], pos[1]));
+    }
+    /**
+     * @brief calculateFaceId returns the id of a collapsed cell in m_faceVertices.
+     * @param posLod The middle of the square or edge the cell collapsed to, in lod-voxel.
+     */
+    static int32 calculateFaceId(const vector2int32& posLod)
+    {
+        return posLod.x*(2*t_voxelAccessor::voxelLength+1) + posLod.y;
+    }
+    /**
+     * @brief calculateAxisFace returns the axis of a face-coordinate, in the order of the lod-voxel.
+     * @param coord The axis of the face.
+     * @param index 0 or 1.
+     */
+    static int32 calculateAxisFace(const int32& coord, const int32& index)
+    {
+        if (index == 0)
+        {
+            return coord == 0 ? 1 : 0;
+        }
+        return coord == 2 ? 1 : 2;
+    }
+    /**
+     * @brief calculatePosFace converts a position along and across an edge of calculateTransitionFace() to face-coordinates.
+     */
+    static vector2int32 calculatePosFace(const int32& dir, const int32& along, const int32& across)
+    {
+        return dir == 0 ? vector2int32(along, across) : vector2int32(across, along);
+    }
+    /**
+     * @brief calculatePosLod converts face-coordinates to the position of tile::accessor::getVoxelLod().
+     */
+    static vector3int32 calculatePosLod(const int32& lod, const vector2int32& posFace)
+    {
+        switch (lod/2)
+        {
+        case 0:
+            return vector3int32(0, posFace.x, posFace.y);
+        case 1:
+            return vector3int32(posFace.x, 0, posFace.y);
+        default:
+            return vector3int32(posFace.x, posFace.y, 0);
+        }
+    }
+    /**
+     * @brief calculatePositionLod returns the position of a lod-voxel in lod-voxel, the face-plane at 0 or 2*voxelLength.
+     */
+    static vector3 calculatePositionLod(const int32& lod, const vector2int32& posFace)
+    {
+        const int32 coord(lod/2);
+        vector3 result;
+        result[coord] = lod % 2 == 0 ? 0. : 2*t_voxelAccessor::voxelLength;
+        result[calculateAxisFace(coord, 0)] = posFace.x;
+        result[calculateAxisFace(coord, 1)] = posFace.y;
+        return result;
+    }
+    static int8 getInterpolationLod(const netsBuffer& nets, const vector2int32& posFace)
+    {
+        return nets.interpolationsLod[posFace.x*(2*t_voxelAccessor::voxelLength+1) + posFace.y];
+    }
+
+    static int32 calculateSampleIndex(const vector3int32& pos)
+    {
+        const int32 sampleLength(t_voxelAccessor::voxelLength+3);
+        return ((pos.x+1)*sampleLength + pos.y+1)*sampleLength + pos.z+1;
+    }
+    static int32 calculateCellIndex(const vector3int32& pos)
+    {
+        const int32 cellLength(t_voxelAccessor::voxelLength+2);
+        return ((pos.x+1)*cellLength + pos.y+1)*cellLength + pos.z+1;
+    }
+    static vector3int32 calculateAxis(const int32& axis)
+    {
+        return vector3int32(axis == 0, axis == 1, axis == 2);
+    }
+
+    /**
+     * @brief cellEdges are the twelve edges of a cell, as corners of calculateCorner().
+     */
+    static const int32 cellEdges[12][2];
+
+protected:
+    real m_quadCollapse;
+
+};
+
+
+template <class configType>
+const int32 surfaceNets<configType>::cellEdges[12][2] = {
+    {0, 1}, {2, 3}, {4, 5}, {6, 7}, // x
+    {0, 4}, {1, 5}, {2, 6}, {3, 7}, // y
+    {0, 2}, {1, 3}, {4, 6}, {5, 7}  // z
+    };
+
+
+}
+}
+}
+}
+
+
+#endif // PROCEDURAL_VOXEL_TILE_SURFACENETS_HPP
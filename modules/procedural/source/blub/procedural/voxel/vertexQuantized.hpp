@@ -0,0 +1,121 @@
+#ifndef BLUB_PROCEDURAL_VOXEL_VERTEXQUANTIZED
+#define BLUB_PROCEDURAL_VOXEL_VERTEXQUANTIZED
+
+#include "blub/core/globals.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/vector3.hpp"
+
+
+namespace blub
+{
+namespace procedural
+{
+namespace voxel
+{
+
+
+/**
+ * @brief The vertexQuantized struct is the compact alternative to vertex. 8 bytes instead of 24.
+ * The position is 16 bit fixed point relative to the tile, see dequantization. The normal is octahedral encoded in 2x8 bit signed normalized.
+ * Can be uploaded to the gpu unchanged, for example as one 4x16 bit attribute or as 3x16 bit unsigned plus 2x8 bit signed normalized.
+ * Call decodePosition() and decodeNormal() to get the float values back.
+ */
+struct vertexQuantized
+{
+    /**
+     * @brief The dequantization struct holds the per tile parameters to convert the quantized position back.
+     * position = offset + quantized*scale
+     */
+    struct dequantization
+    {
+        dequantization()
+            : offset(0.)
+            , scale(1.)
+        {
+            ;
+        }
+
+        vector3 offset;
+        real scale;
+    };
+
+    /**
+     * @brief encode creates a quantized vertex.
+     * @param position Gets clamped to the range of dequant.
+     * @param normal Must be normalised or zero.
+     * @param dequant The parameters of the tile.
+     * @return
+     */
+    static vertexQuantized encode(const vector3& position, const vector3& normal, const dequantization& dequant)
+    {
+        vertexQuantized result;
+        const vector3 toQuantize((position - dequant.offset) / dequant.scale);
+        for (int32 ind = 0; ind < 3; ++ind)
+        {
+            result.position[ind] = static_cast<uint16>(math::clamp<real>(math::floor(toQuantize[ind] + 0.5), 0., 65535.));
+        }
+        encodeNormal(normal, result.normal);
+        return result;
+    }
+
+    /**
+     * @brief decodePosition converts the position back.
+     * @param dequant Same as passed to encode().
+     * @return
+     */
+    vector3 decodePosition(const dequantization& dequant) const
+    {
+        return dequant.offset + vector3(position[0], position[1], position[2])*dequant.scale;
+    }
+
+    /**
+     * @brief decodeNormal converts the octahedral normal back.
+     * @return Normalised.
+     */
+    vector3 decodeNormal() const
+    {
+        const real x(math::max<real>(normal[0] / 127., -1.));
+        const real y(math::max<real>(normal[1] / 127., -1.));
+        vector3 result(x, y, 1. - math::abs(x) - math::abs(y));
+        if (result.z < 0.)
+        {
+            result.x = (1. - math::abs(y)) * (x < 0. ? -1. : 1.);
+            result.y = (1. - math::abs(x)) * (y < 0. ? -1. : 1.);
+        }
+        result.normalise();
+        return result;
+    }
+
+    uint16 position[3];
+    int8 normal[2];
+
+protected:
+    static void encodeNormal(const vector3& toEncode, int8* result)
+    {
+        const real sum(math::abs(toEncode.x) + math::abs(toEncode.y) + math::abs(toEncode.z));
+        if (sum <= 0.)
+        {
+            result[0] = 0;
+            result[1] = 0;
+            return;
+        }
+        real x(toEncode.x / sum);
+        real y(toEncode.y / sum);
+        if (toEncode.z < 0.)
+        {
+            const real oldX(x);
+            x = (1. - math::abs(y)) * (oldX < 0. ? -1. : 1.);
+            y = (1. - math::abs(oldX)) * (y < 0. ? -1. : 1.);
+        }
+        result[0] = static_cast<int8>(math::floor(math::clamp<real>(x, -1., 1.)*127. + 0.5));
+        result[1] = static_cast<int8>(math::floor(math::clamp<real>(y, -1., 1.)*127. + 0.5));
+    }
+};
+
+
+}
+}
+}
+
+
+#endif // BLUB_PROCEDURAL_VOXEL_VERTEXQUANTIZED
@@ -0,0 +1,62 @@
+#define BOOST_TEST_MODULE procedural_voxel_edit_axisAlignedBox
+#include <boost/test/unit_test.hpp>
+
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/quaternion.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/axisAlignedBox.hpp"
+
+#include "countDifferentVoxel.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::edit::axisAlignedBox<t_config> t_axisAlignedBox;
+
+
+void checkVectorClose(const vector3& result, const vector3& expected)
+{
+    BOOST_CHECK_SMALL((result - expected).length(), static_cast<real>(1e-4));
+}
+
+
+BOOST_AUTO_TEST_CASE(rotatedAxisAlignedBoxMatchesAxisAlignedBox)
+{
+    const vector3 position(0.25, 0.5, 0.75);
+    const t_axisAlignedBox::pointer rotated(t_axisAlignedBox::create(blub::axisAlignedBox(vector3(-2.3, -4.7, -1.3), vector3(6.3, 3.7, 5.7))));
+    // 90 degree about y maps x to -z and z to x
+    const blub::axisAlignedBox expected(vector3(-1.3, -4.7, -6.3) + position, vector3(5.7, 3.7, 2.3) + position);
+    const t_axisAlignedBox::pointer axisAligned(t_axisAlignedBox::create(expected));
+
+    const transform transRotated(position, quaternion(math::pi/2., vector3(0., 1., 0.)));
+
+    const blub::axisAlignedBox aabb(rotated->getAxisAlignedBoundingBox(transRotated));
+    checkVectorClose(aabb.getMinimum(), expected.getMinimum());
+    checkVectorClose(aabb.getMaximum(), expected.getMaximum());
+
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*rotated, transRotated, *axisAligned, transform()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(rotatedAxisAlignedBoxBoundsItsCorners)
+{
+    const blub::axisAlignedBox desc(vector3(-2.3, -4.7, -1.3), vector3(6.3, 3.7, 5.7));
+    const t_axisAlignedBox::pointer rotated(t_axisAlignedBox::create(desc));
+    const transform trans(vector3(0.25, 0.5, 0.75), quaternion(0.7, vector3(1., 1., 0.).getNormalise()), vector3(1., 2., 1.5));
+
+    // the tightest box is spanned by the transformed corners
+    blub::axisAlignedBox expected;
+    for (int32 corner = 0; corner < 8; ++corner)
+    {
+        const vector3 local((corner & 1) ? desc.getMaximum().x : desc.getMinimum().x,
+                            (corner & 2) ? desc.getMaximum().y : desc.getMinimum().y,
+                            (corner & 4) ? desc.getMaximum().z : desc.getMinimum().z);
+        expected.merge(trans.rotation*(local*trans.scale) + trans.position);
+    }
+
+    const blub::axisAlignedBox aabb(rotated->getAxisAlignedBoundingBox(trans));
+    checkVectorClose(aabb.getMinimum(), expected.getMinimum());
+    checkVectorClose(aabb.getMaximum(), expected.getMaximum());
+}
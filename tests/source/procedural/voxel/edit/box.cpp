@@ -0,0 +1,38 @@
+#define BOOST_TEST_MODULE procedural_voxel_edit_box
+#include <boost/test/unit_test.hpp>
+
+#include "blub/math/math.hpp"
+#include "blub/math/quaternion.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/box.hpp"
+
+#include "countDifferentVoxel.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::edit::box<t_config> t_box;
+
+
+BOOST_AUTO_TEST_CASE(rotatedBoxMatchesAxisAlignedBox)
+{
+    const t_box::pointer rotated(t_box::create(vector3(8.3, 5.3, 3.3), quaternion()));
+    const t_box::pointer axisAligned(t_box::create(vector3(3.3, 5.3, 8.3), quaternion()));
+    const vector3 position(0.25, 0.5, 0.75);
+
+    // 90 degree about y swaps the x- and z-extent
+    const transform transRotated(position, quaternion(math::pi/2., vector3(0., 1., 0.)));
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*rotated, transRotated, *axisAligned, transform(position)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(rotatedScaledBoxMatchesAxisAlignedBox)
+{
+    const t_box::pointer rotated(t_box::create(vector3(4.15, 5.3, 1.65), quaternion()));
+    const t_box::pointer axisAligned(t_box::create(vector3(3.3, 5.3, 8.3), quaternion()));
+    const vector3 position(0.25, 0.5, 0.75);
+
+    const transform transRotated(position, quaternion(math::pi/2., vector3(0., 1., 0.)), vector3(2., 1., 2.));
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*rotated, transRotated, *axisAligned, transform(position)), 0);
+}
@@ -0,0 +1,209 @@
+#define BOOST_TEST_MODULE procedural_voxel_edit_composite
+#include <boost/test/unit_test.hpp>
+
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/math.hpp"
+#include "blub/math/quaternion.hpp"
+#include "blub/math/sphere.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/axisAlignedBox.hpp"
+#include "blub/procedural/voxel/edit/composite.hpp"
+#include "blub/procedural/voxel/edit/sphere.hpp"
+
+#include "countDifferentVoxel.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::edit::composite<t_config> t_composite;
+typedef t_composite::operation t_operation;
+typedef voxel::edit::axisAlignedBox<t_config> t_axisAlignedBox;
+typedef voxel::edit::sphere<t_config> t_sphere;
+
+
+/**
+ * @brief calculateTile calculates an edit on an empty tile.
+ */
+t_tile::pointer calculateTile(const t_edit& edit, const vector3int32& id)
+{
+    t_tile::pointer result(t_tile::create());
+    result->startEdit();
+    edit.calculateVoxel(result.get(), id, transform());
+    result->endEdit();
+    return result;
+}
+
+/**
+ * @brief countWrongVoxel combines two overlapping spheres by op and counts the voxel on the 2^3 tiles around the origin,
+ * whose interpolation differs from expected() of the interpolations of the spheres.
+ */
+int32 countWrongVoxel(const t_operation& op, int8 (*expected)(const int8&, const int8&))
+{
+    const t_sphere::pointer sphereA(t_sphere::create(blub::sphere(vector3(-3.3, 0.4, 1.2), 9.4)));
+    const t_sphere::pointer sphereB(t_sphere::create(blub::sphere(vector3(4.7, -1.6, -0.8), 7.1)));
+
+    t_composite::pointer combined(t_composite::create());
+    combined->addEdit(sphereA);
+    combined->addEdit(sphereB, op);
+
+    const int32 voxelLength(t_tile::voxelLength);
+    int32 result(0);
+    for (int32 tileX = -1; tileX < 1; ++tileX)
+    {
+        for (int32 tileY = -1; tileY < 1; ++tileY)
+        {
+            for (int32 tileZ = -1; tileZ < 1; ++tileZ)
+            {
+                const vector3int32 id(tileX, tileY, tileZ);
+                const t_tile::pointer tileA(calculateTile(*sphereA, id));
+                const t_tile::pointer tileB(calculateTile(*sphereB, id));
+                const t_tile::pointer tileCombined(calculateTile(*combined, id));
+                for (int32 x = 0; x < voxelLength; ++x)
+                {
+                    for (int32 y = 0; y < voxelLength; ++y)
+                    {
+                        for (int32 z = 0; z < voxelLength; ++z)
+                        {
+                            const vector3int32 pos(x, y, z);
+                            const int8 interpolation(tileCombined->getVoxel(pos).getInterpolation());
+                            if (interpolation != expected(tileA->getVoxel(pos).getInterpolation(), tileB->getVoxel(pos).getInterpolation()))
+                            {
+                                ++result;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+int8 expectMerge(const int8& a, const int8& b)
+{
+    return math::max(a, b);
+}
+int8 expectSubtract(const int8& a, const int8& b)
+{
+    return math::max<int8>(math::min<int8>(a, -b), -127);
+}
+int8 expectIntersect(const int8& a, const int8& b)
+{
+    return math::min(a, b);
+}
+
+BOOST_AUTO_TEST_CASE(mergeKeepsTheMaximum)
+{
+    BOOST_CHECK_EQUAL(countWrongVoxel(t_operation::merge, expectMerge), 0);
+}
+
+BOOST_AUTO_TEST_CASE(subtractKeepsTheMinimumWithTheInverted)
+{
+    BOOST_CHECK_EQUAL(countWrongVoxel(t_operation::subtract, expectSubtract), 0);
+}
+
+BOOST_AUTO_TEST_CASE(intersectKeepsTheMinimum)
+{
+    BOOST_CHECK_EQUAL(countWrongVoxel(t_operation::intersect, expectIntersect), 0);
+}
+
+BOOST_AUTO_TEST_CASE(smoothMergeBlendsOnlyWhereBothSurfacesAreNear)
+{
+    const t_sphere::pointer sphereA(t_sphere::create(blub::sphere(vector3(-3.3, 0.4, 1.2), 9.4)));
+    const t_sphere::pointer sphereB(t_sphere::create(blub::sphere(vector3(4.7, -1.6, -0.8), 7.1)));
+
+    t_composite::pointer blended(t_composite::create());
+    blended->addEdit(sphereA);
+    blended->addEdit(sphereB, t_operation::smoothMerge, transform(), 0.);
+    t_composite::pointer merged(t_composite::create());
+    merged->addEdit(sphereA);
+    merged->addEdit(sphereB);
+    // blend radius 0 is a merge
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*blended, transform(), *merged, transform()), 0);
+
+    int32 numBlended(0);
+    int32 numLower(0);
+    const int32 voxelLength(t_tile::voxelLength);
+    t_composite::pointer smooth(t_composite::create());
+    smooth->addEdit(sphereA);
+    smooth->addEdit(sphereB, t_operation::smoothMerge, transform(), 2.);
+    for (int32 tileX = -1; tileX < 1; ++tileX)
+    {
+        for (int32 tileY = -1; tileY < 1; ++tileY)
+        {
+            for (int32 tileZ = -1; tileZ < 1; ++tileZ)
+            {
+                const vector3int32 id(tileX, tileY, tileZ);
+                const t_tile::pointer tileA(calculateTile(*sphereA, id));
+                const t_tile::pointer tileB(calculateTile(*sphereB, id));
+                const t_tile::pointer tileSmooth(calculateTile(*smooth, id));
+                for (int32 x = 0; x < voxelLength; ++x)
+                {
+                    for (int32 y = 0; y < voxelLength; ++y)
+                    {
+                        for (int32 z = 0; z < voxelLength; ++z)
+                        {
+                            const vector3int32 pos(x, y, z);
+                            const int8 a(tileA->getVoxel(pos).getInterpolation());
+                            const int8 b(tileB->getVoxel(pos).getInterpolation());
+                            const int8 result(tileSmooth->getVoxel(pos).getInterpolation());
+                            if (result < math::max(a, b))
+                            {
+                                ++numLower;
+                            }
+                            if (a == -127 || b == -127)
+                            {
+                                BOOST_CHECK_EQUAL(result, math::max(a, b));
+                            }
+                            else if (result > math::max(a, b))
+                            {
+                                ++numBlended;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // a smooth maximum never removes volume
+    BOOST_CHECK_EQUAL(numLower, 0);
+    BOOST_CHECK_GT(numBlended, 0);
+}
+
+BOOST_AUTO_TEST_CASE(rotatedChildInRotatedUniformScaledComposite)
+{
+    const t_axisAlignedBox::pointer child(t_axisAlignedBox::create(blub::axisAlignedBox(vector3(1.3, -2.7, -0.7), vector3(4.7, 2.3, 3.3))));
+    t_composite::pointer parent(t_composite::create());
+    // 90 degree about z maps x to y and y to -x
+    parent->addEdit(child, t_operation::merge, transform(vector3(5., 0., 0.), quaternion(math::pi/2., vector3(0., 0., 1.))));
+
+    // 90 degree about y maps x to -z and z to x
+    const vector3 position(0.25, 0.5, 0.75);
+    const transform transParent(position, quaternion(math::pi/2., vector3(0., 1., 0.)), vector3(2.));
+    const blub::axisAlignedBox expected(vector3(-1.4, 2.6, -15.4) + position, vector3(6.6, 9.4, -5.4) + position);
+
+    const blub::axisAlignedBox aabb(parent->getAxisAlignedBoundingBox(transParent));
+    BOOST_CHECK_SMALL((aabb.getMinimum() - expected.getMinimum()).length(), static_cast<real>(1e-4));
+    BOOST_CHECK_SMALL((aabb.getMaximum() - expected.getMaximum()).length(), static_cast<real>(1e-4));
+
+    const t_axisAlignedBox::pointer absolute(t_axisAlignedBox::create(expected));
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*parent, transParent, *absolute, transform()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(unrotatedChildInNonUniformScaledComposite)
+{
+    const t_axisAlignedBox::pointer child(t_axisAlignedBox::create(blub::axisAlignedBox(vector3(1.3, -2.7, -0.7), vector3(4.7, 2.3, 3.3))));
+    t_composite::pointer parent(t_composite::create());
+    parent->addEdit(child, t_operation::merge, transform(vector3(-5., 1., 2.)));
+
+    // 90 degree about y maps x to -z and z to x
+    const vector3 position(0.25, 0.5, 0.75);
+    const transform transParent(position, quaternion(math::pi/2., vector3(0., 1., 0.)), vector3(2., 1., 3.));
+    // relative [-3.7,-0.3]x[-1.7,3.3]x[1.3,5.3], scaled [-7.4,-0.6]x[-1.7,3.3]x[3.9,15.9]
+    const blub::axisAlignedBox expected(vector3(3.9, -1.7, 0.6) + position, vector3(15.9, 3.3, 7.4) + position);
+
+    const t_axisAlignedBox::pointer absolute(t_axisAlignedBox::create(expected));
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*parent, transParent, *absolute, transform()), 0);
+}
@@ -0,0 +1,60 @@
+#ifndef TESTS_PROCEDURAL_VOXEL_EDIT_COUNTDIFFERENTVOXEL_HPP
+#define TESTS_PROCEDURAL_VOXEL_EDIT_COUNTDIFFERENTVOXEL_HPP
+
+#include "blub/math/transform.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/edit/base.hpp"
+#include "blub/procedural/voxel/tile/container.hpp"
+
+
+typedef blub::procedural::voxel::config t_config;
+typedef blub::procedural::voxel::edit::base<t_config> t_edit;
+typedef blub::procedural::voxel::tile::container<t_config> t_tile;
+
+
+/**
+ * @brief countDifferentVoxel calculates both edits on the 2^3 tiles around the origin and counts the voxel whose interpolation differs by more than one.
+ */
+inline blub::int32 countDifferentVoxel(const t_edit& editA, const blub::transform& transA, const t_edit& editB, const blub::transform& transB)
+{
+    const blub::int32 voxelLength(t_tile::voxelLength);
+    blub::int32 result(0);
+    for (blub::int32 tileX = -1; tileX < 1; ++tileX)
+    {
+        for (blub::int32 tileY = -1; tileY < 1; ++tileY)
+        {
+            for (blub::int32 tileZ = -1; tileZ < 1; ++tileZ)
+            {
+                const blub::vector3int32 id(tileX, tileY, tileZ);
+                t_tile::pointer tileA(t_tile::create());
+                t_tile::pointer tileB(t_tile::create());
+                tileA->startEdit();
+                tileB->startEdit();
+                editA.calculateVoxel(tileA.get(), id, transA);
+                editB.calculateVoxel(tileB.get(), id, transB);
+                tileA->endEdit();
+                tileB->endEdit();
+                for (blub::int32 x = 0; x < voxelLength; ++x)
+                {
+                    for (blub::int32 y = 0; y < voxelLength; ++y)
+                    {
+                        for (blub::int32 z = 0; z < voxelLength; ++z)
+                        {
+                            const blub::vector3int32 pos(x, y, z);
+                            const blub::int32 difference(tileA->getVoxel(pos).getInterpolation() - tileB->getVoxel(pos).getInterpolation());
+                            if (difference < -1 || difference > 1)
+                            {
+                                ++result;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+
+#endif // TESTS_PROCEDURAL_VOXEL_EDIT_COUNTDIFFERENTVOXEL_HPP
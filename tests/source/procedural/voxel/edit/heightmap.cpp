@@ -0,0 +1,38 @@
+#define BOOST_TEST_MODULE procedural_voxel_edit_heightmap
+#include <boost/test/unit_test.hpp>
+
+#include "blub/async/dispatcher.hpp"
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/math/vector2int.hpp"
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/edit/heightmap.hpp"
+#include "blub/procedural/voxel/simple/container/inMemory.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::config t_config;
+typedef t_config::t_container::t_simple t_voxelContainer;
+typedef voxel::simple::container::utils::tileState t_tileState;
+typedef voxel::edit::heightmap<t_config> t_heightmap;
+
+
+BOOST_AUTO_TEST_CASE(attributesOnlyTilesGetCalculated)
+{
+    async::dispatcher worker(1, true);
+    t_voxelContainer voxels(worker);
+
+    t_heightmap::pointer heights(t_heightmap::create(vector2int32(2, 2), t_heightmap::t_heights(4, 50.), -10.));
+    const transform trans(vector3(-20., 0., -20.), quaternion(), vector3(60., 1., 60.));
+    const int32 voxelsPerTile(t_config::voxelsPerTile);
+    const axisAlignedBox tileBounds(vector3(0.), vector3(voxelsPerTile-1));
+
+    heights->prepareCalculateVoxelMaster(voxels, trans);
+    BOOST_CHECK(heights->calculateTileState(tileBounds, trans) == t_tileState::full);
+    heights->setAttributesOnly(true);
+    BOOST_CHECK(heights->calculateTileState(tileBounds, trans) == t_tileState::partitial);
+    heights->finishCalculateVoxelMaster();
+}
@@ -0,0 +1,80 @@
+#define BOOST_TEST_MODULE procedural_voxel_edit_sphere
+#include <boost/test/unit_test.hpp>
+
+#include "blub/math/math.hpp"
+#include "blub/math/quaternion.hpp"
+#include "blub/math/sphere.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/procedural/voxel/edit/sphere.hpp"
+
+#include "countDifferentVoxel.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::edit::sphere<t_config> t_sphere;
+
+
+void checkVectorClose(const vector3& result, const vector3& expected)
+{
+    BOOST_CHECK_SMALL((result - expected).length(), static_cast<real>(1e-4));
+}
+
+
+BOOST_AUTO_TEST_CASE(rotatedSphereMatchesMovedSphere)
+{
+    const vector3 center(5.3, -2.7, 1.4);
+    const real radius(7.3);
+    const quaternion rotation(0.7, vector3(1., 1., 0.).getNormalise());
+    const vector3 position(0.25, 0.5, 0.75);
+    const vector3 centerAbsolut(rotation*center + position);
+
+    const t_sphere::pointer rotated(t_sphere::create(blub::sphere(center, radius)));
+    const t_sphere::pointer moved(t_sphere::create(blub::sphere(centerAbsolut, radius)));
+    const transform transRotated(position, rotation);
+
+    const axisAlignedBox aabb(rotated->getAxisAlignedBoundingBox(transRotated));
+    checkVectorClose(aabb.getMinimum(), centerAbsolut - vector3(radius + 1.));
+    checkVectorClose(aabb.getMaximum(), centerAbsolut + vector3(radius + 1.));
+
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*rotated, transRotated, *moved, transform()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(rotatedScaledSphereMatchesScaledSphere)
+{
+    const real radius(4.3);
+    const t_sphere::pointer ellipsoid(t_sphere::create(blub::sphere(vector3(0.), radius)));
+    const vector3 position(0.25, 0.5, 0.75);
+
+    // 90 degree about y swaps the x- and z-scale
+    const transform transRotated(position, quaternion(math::pi/2., vector3(0., 1., 0.)), vector3(2., 1., 1.));
+    const transform transScaled(position, quaternion(), vector3(1., 1., 2.));
+
+    const axisAlignedBox aabb(ellipsoid->getAxisAlignedBoundingBox(transRotated));
+    // calculateOneVoxel() interpolates up to radius+1 in edit-space
+    const real extent(radius + 1.);
+    checkVectorClose(aabb.getMinimum(), position - vector3(extent, extent, 2.*extent));
+    checkVectorClose(aabb.getMaximum(), position + vector3(extent, extent, 2.*extent));
+
+    BOOST_CHECK_EQUAL(countDifferentVoxel(*ellipsoid, transRotated, *ellipsoid, transScaled), 0);
+}
+
+BOOST_AUTO_TEST_CASE(voxelOutsideRadiusGetInterpolated)
+{
+    const real radius(5.6);
+    const t_sphere::pointer sphere(t_sphere::create(blub::sphere(vector3(0.), radius)));
+    const transform trans(vector3(0.), quaternion(math::pi/4., vector3(0., 0., 1.)));
+
+    t_tile::pointer tile(t_tile::create());
+    tile->startEdit();
+    sphere->calculateVoxel(tile.get(), vector3int32(0), trans);
+    tile->endEdit();
+
+    // the surface lies between the voxel 5 and 6, both need their interpolation
+    const int8 inside(tile->getVoxel(vector3int32(5, 0, 0)).getInterpolation());
+    const int8 outside(tile->getVoxel(vector3int32(6, 0, 0)).getInterpolation());
+    BOOST_CHECK_EQUAL(inside, static_cast<int8>((radius - 5.)*127.));
+    BOOST_CHECK_EQUAL(outside, static_cast<int8>((radius - 6.)*127.));
+}
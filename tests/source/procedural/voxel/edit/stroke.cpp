@@ -0,0 +1,105 @@
+#define BOOST_TEST_MODULE procedural_voxel_edit_stroke
+#include <boost/test/unit_test.hpp>
+
+#include "blub/math/axisAlignedBox.hpp"
+#include "blub/math/quaternion.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/math/vector3int.hpp"
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/edit/stroke.hpp"
+#include "blub/procedural/voxel/tile/container.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::config t_config;
+typedef voxel::edit::stroke<t_config> t_stroke;
+typedef voxel::tile::container<t_config> t_tile;
+
+
+/**
+ * @brief calculateTileBounds returns the absolute voxel bounds of a tile, like the container passes them to intersectsTile().
+ */
+blub::axisAlignedBox calculateTileBounds(const vector3int32& id)
+{
+    const vector3int32 tileStart(id*t_config::voxelsPerTile);
+    return blub::axisAlignedBox(vector3(tileStart), vector3(tileStart + vector3int32(t_config::voxelsPerTile-1)));
+}
+
+/**
+ * @brief calculatesVoxel returns true if the stroke changes at least one voxel of the tile.
+ */
+bool calculatesVoxel(const t_stroke& stroke, const vector3int32& id, const transform& trans)
+{
+    t_tile::pointer tile(t_tile::create());
+    tile->startEdit();
+    stroke.calculateVoxel(tile.get(), id, trans);
+    tile->endEdit();
+
+    const int32 voxelLength(t_tile::voxelLength);
+    for (int32 x = 0; x < voxelLength; ++x)
+    {
+        for (int32 y = 0; y < voxelLength; ++y)
+        {
+            for (int32 z = 0; z < voxelLength; ++z)
+            {
+                if (tile->getVoxel(vector3int32(x, y, z)).getInterpolation() != -127)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+
+BOOST_AUTO_TEST_CASE(diagonalSegmentSkipsTilesBesideIt)
+{
+    t_stroke::pointer stroke(t_stroke::create());
+    stroke->addPoint(vector3(0.), 2.);
+    stroke->addPoint(vector3(100.), 2.);
+
+    // inside the bounds of the segment, but far from the capsule
+    BOOST_CHECK(!stroke->intersectsTile(calculateTileBounds(vector3int32(4, 0, 0)), transform()));
+    BOOST_CHECK(!stroke->intersectsTile(calculateTileBounds(vector3int32(0, 4, 4)), transform()));
+    // on the segment
+    BOOST_CHECK(stroke->intersectsTile(calculateTileBounds(vector3int32(2, 2, 2)), transform()));
+    // touched only by the interpolation range of radius+1
+    BOOST_CHECK(stroke->intersectsTile(calculateTileBounds(vector3int32(0, 0, -1)), transform()));
+}
+
+BOOST_AUTO_TEST_CASE(skippedTilesGetNoVoxel)
+{
+    t_stroke::pointer stroke(t_stroke::create());
+    stroke->addPoint(vector3(0.), 1.5);
+    stroke->addPoint(vector3(30., 10., 20.), 4.5);
+    stroke->addPoint(vector3(50., -20., 40.), 2.5);
+
+    const transform trans(vector3(3.25, -1.5, 0.75), quaternion(0.7, vector3(1., 1., 0.).getNormalise()), vector3(1., 1.5, 0.75));
+
+    const blub::axisAlignedBox aabb(stroke->getAxisAlignedBoundingBox(trans));
+    const vector3int32 start(vector3int32(aabb.getMinimum()/t_config::voxelsPerTile) - vector3int32(1));
+    const vector3int32 end(vector3int32(aabb.getMaximum()/t_config::voxelsPerTile) + vector3int32(2));
+
+    int32 numSkipped(0);
+    for (int32 x = start.x; x < end.x; ++x)
+    {
+        for (int32 y = start.y; y < end.y; ++y)
+        {
+            for (int32 z = start.z; z < end.z; ++z)
+            {
+                const vector3int32 id(x, y, z);
+                const bool intersects(stroke->intersectsTile(calculateTileBounds(id), trans));
+                if (!intersects)
+                {
+                    ++numSkipped;
+                }
+                BOOST_CHECK(intersects || !calculatesVoxel(*stroke, id, trans));
+            }
+        }
+    }
+    BOOST_CHECK_GT(numSkipped, 0);
+}
@@ -0,0 +1,80 @@
+#define BOOST_TEST_MODULE procedural_voxel_simple_container_base
+#include <boost/test/unit_test.hpp>
+
+#include "blub/async/dispatcher.hpp"
+#include "blub/core/vector.hpp"
+#include "blub/math/sphere.hpp"
+#include "blub/math/transform.hpp"
+#include "blub/math/vector2int.hpp"
+#include "blub/procedural/voxel/config.hpp"
+#include "blub/procedural/voxel/edit/heightmap.hpp"
+#include "blub/procedural/voxel/edit/sphere.hpp"
+#include "blub/procedural/voxel/simple/container/inMemory.hpp"
+#include "blub/procedural/voxel/tile/container.hpp"
+
+
+using namespace blub::procedural;
+using namespace blub;
+
+
+typedef voxel::config t_config;
+typedef t_config::t_container::t_simple t_voxelContainer;
+typedef t_voxelContainer::t_utilsTile t_utilsTile;
+typedef voxel::simple::container::utils::tileState t_tileState;
+typedef voxel::tile::container<t_config> t_tile;
+typedef voxel::edit::heightmap<t_config> t_heightmap;
+typedef voxel::edit::sphere<t_config> t_sphere;
+
+
+/**
+ * @brief runUntilDone runs the dispatcher until all jobs are done, including the ones they post.
+ */
+void runUntilDone(async::dispatcher& worker)
+{
+    worker.start();
+    worker.stop();
+    worker.reset();
+}
+
+/**
+ * @brief getInterpolations returns the interpolation of every voxel of a partitial tile.
+ */
+vector<int8> getInterpolations(const t_utilsTile& holder)
+{
+    vector<int8> result;
+    for (int32 index = 0; index < t_tile::voxelCount; ++index)
+    {
+        result.push_back(holder.data->getVoxel(index).getInterpolation());
+    }
+    return result;
+}
+
+
+BOOST_AUTO_TEST_CASE(attributesOnlyEditKeepsTileTheHeightmapJudgesFull)
+{
+    async::dispatcher worker(1, true);
+    t_voxelContainer voxels(worker);
+    const vector3int32 id(0);
+
+    voxels.editVoxel(t_sphere::create(blub::sphere(vector3(10.), 6.)));
+    runUntilDone(worker);
+
+    voxels.lockForRead();
+    const t_utilsTile before(voxels.getTileHolder(id));
+    BOOST_REQUIRE(before.state == t_tileState::partitial);
+    const vector<int8> interpolationsBefore(getInterpolations(before));
+    voxels.unlockRead();
+
+    // the tile lies completely below the surface of the heightmap
+    t_heightmap::pointer paint(t_heightmap::create(vector2int32(2, 2), t_heightmap::t_heights(4, 50.), -10.));
+    paint->setAttributesOnly(true);
+    voxels.editVoxel(paint, transform(vector3(-20., 0., -20.), quaternion(), vector3(60., 1., 60.)));
+    runUntilDone(worker);
+
+    voxels.lockForRead();
+    const t_utilsTile after(voxels.getTileHolder(id));
+    BOOST_REQUIRE(after.state == t_tileState::partitial);
+    BOOST_CHECK(getInterpolations(after) == interpolationsBefore);
+    BOOST_CHECK(voxels.getEditedAttributesOnly());
+    voxels.unlockRead();
+}